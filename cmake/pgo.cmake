@@ -0,0 +1,124 @@
+# Profile-guided optimisation pipeline, run in script mode:
+#
+#   cmake -DHFT_SOURCE_DIR=<repo> -DHFT_PGO_ROOT=<work dir> [-DHFT_PGO_MESSAGES=N]
+#         [-DHFT_CXX_COMPILER=<c++>] [-DHFT_PGO_BENCHMARKS="queue;alloc"] -P cmake/pgo.cmake
+#
+# Normally invoked through the `pgo` build target. Steps:
+#   1. Build a baseline tree (HFT_PGO=OFF).
+#   2. Generate the training workload from data/mock_market_data.txt with gen_workload.
+#   3. Build an instrumented tree (HFT_PGO=GENERATE) and replay the workload through hft_system.
+#   4. Rebuild the same tree with HFT_PGO=USE. GCC keys profiles by object path, so the
+#      instrumented and optimised builds must share a build directory.
+#   5. Replay the workload and run the benchmark suite on both trees and report the gain.
+
+if(NOT HFT_SOURCE_DIR OR NOT HFT_PGO_ROOT)
+    message(FATAL_ERROR "HFT_SOURCE_DIR and HFT_PGO_ROOT are required")
+endif()
+if(NOT HFT_PGO_MESSAGES)
+    set(HFT_PGO_MESSAGES 2000000)
+endif()
+
+set(baseline_dir ${HFT_PGO_ROOT}/baseline)
+set(pgo_dir ${HFT_PGO_ROOT}/optimised)
+set(profile_dir ${HFT_PGO_ROOT}/profile)
+set(workload ${HFT_PGO_ROOT}/replay_workload.txt)
+set(compiler_args)
+if(HFT_CXX_COMPILER)
+    set(compiler_args -DCMAKE_CXX_COMPILER=${HFT_CXX_COMPILER})
+endif()
+
+function(hft_run)
+    cmake_parse_arguments(RUN "" "WORKING_DIRECTORY;OUTPUT_VARIABLE" "COMMAND" ${ARGN})
+    if(NOT RUN_WORKING_DIRECTORY)
+        set(RUN_WORKING_DIRECTORY ${HFT_PGO_ROOT})
+    endif()
+    if(RUN_OUTPUT_VARIABLE)
+        execute_process(COMMAND ${RUN_COMMAND} WORKING_DIRECTORY ${RUN_WORKING_DIRECTORY}
+                        RESULT_VARIABLE result OUTPUT_VARIABLE output ERROR_VARIABLE output)
+        set(${RUN_OUTPUT_VARIABLE} "${output}" PARENT_SCOPE)
+    else()
+        execute_process(COMMAND ${RUN_COMMAND} WORKING_DIRECTORY ${RUN_WORKING_DIRECTORY}
+                        RESULT_VARIABLE result)
+    endif()
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "PGO step failed (${result}): ${RUN_COMMAND}\n${output}")
+    endif()
+endfunction()
+
+# Replays the workload in a fresh directory (no snapshot/journal carried over) and returns
+# the best msgs/sec of three runs.
+function(hft_replay_throughput binary run_dir out_var)
+    set(best 0)
+    foreach(attempt RANGE 1 3)
+        file(REMOVE_RECURSE ${run_dir})
+        file(MAKE_DIRECTORY ${run_dir})
+        hft_run(COMMAND ${binary} --replay ${workload} WORKING_DIRECTORY ${run_dir} OUTPUT_VARIABLE output)
+        string(REGEX MATCH "ms, ([0-9]+) msgs/sec" match "${output}")
+        if(NOT match)
+            message(FATAL_ERROR "No throughput in replay output:\n${output}")
+        endif()
+        set(rate ${CMAKE_MATCH_1})
+        if(rate GREATER best)
+            set(best ${rate})
+        endif()
+    endforeach()
+    set(${out_var} ${best} PARENT_SCOPE)
+endfunction()
+
+file(MAKE_DIRECTORY ${HFT_PGO_ROOT})
+
+message(STATUS "[pgo] 1/5 baseline build")
+hft_run(COMMAND ${CMAKE_COMMAND} -S ${HFT_SOURCE_DIR} -B ${baseline_dir} -DCMAKE_BUILD_TYPE=Release
+                -DHFT_PGO=OFF ${compiler_args})
+hft_run(COMMAND ${CMAKE_COMMAND} --build ${baseline_dir} --parallel)
+
+message(STATUS "[pgo] 2/5 generating ${HFT_PGO_MESSAGES}-message workload")
+hft_run(COMMAND ${baseline_dir}/gen_workload ${HFT_SOURCE_DIR}/data/mock_market_data.txt ${workload}
+                ${HFT_PGO_MESSAGES})
+
+message(STATUS "[pgo] 3/5 instrumented build and training replay")
+file(REMOVE_RECURSE ${profile_dir})
+hft_run(COMMAND ${CMAKE_COMMAND} -S ${HFT_SOURCE_DIR} -B ${pgo_dir} -DCMAKE_BUILD_TYPE=Release
+                -DHFT_PGO=GENERATE -DHFT_PGO_DIR=${profile_dir} ${compiler_args})
+hft_run(COMMAND ${CMAKE_COMMAND} --build ${pgo_dir} --parallel --clean-first)
+file(REMOVE_RECURSE ${HFT_PGO_ROOT}/train)
+file(MAKE_DIRECTORY ${HFT_PGO_ROOT}/train)
+hft_run(COMMAND ${pgo_dir}/hft_system --replay ${workload} WORKING_DIRECTORY ${HFT_PGO_ROOT}/train)
+
+file(GLOB raw_profiles ${profile_dir}/*.profraw)
+if(raw_profiles)
+    # Clang writes raw profiles that must be merged before use.
+    find_program(LLVM_PROFDATA NAMES llvm-profdata REQUIRED)
+    hft_run(COMMAND ${LLVM_PROFDATA} merge -output=${profile_dir}/hft.profdata ${raw_profiles})
+endif()
+
+message(STATUS "[pgo] 4/5 profile-use rebuild")
+hft_run(COMMAND ${CMAKE_COMMAND} -S ${HFT_SOURCE_DIR} -B ${pgo_dir} -DHFT_PGO=USE)
+hft_run(COMMAND ${CMAKE_COMMAND} --build ${pgo_dir} --parallel --clean-first)
+
+message(STATUS "[pgo] 5/5 benchmarking baseline vs. PGO")
+hft_replay_throughput(${baseline_dir}/hft_system ${HFT_PGO_ROOT}/run-baseline baseline_rate)
+hft_replay_throughput(${pgo_dir}/hft_system ${HFT_PGO_ROOT}/run-pgo pgo_rate)
+foreach(build baseline pgo)
+    set(dir ${baseline_dir})
+    if(build STREQUAL "pgo")
+        set(dir ${pgo_dir})
+    endif()
+    hft_run(COMMAND ${dir}/benchmark ${HFT_PGO_BENCHMARKS} OUTPUT_VARIABLE bench_${build})
+endforeach()
+
+math(EXPR gain_permille "(${pgo_rate} - ${baseline_rate}) * 1000 / ${baseline_rate}")
+set(gain_sign "+")
+if(gain_permille LESS 0)
+    set(gain_sign "-")
+    math(EXPR gain_permille "-(${gain_permille})")
+endif()
+math(EXPR gain_whole "${gain_permille} / 10")
+math(EXPR gain_frac "${gain_permille} % 10")
+message("== Benchmark suite: baseline ==\n${bench_baseline}")
+message("== Benchmark suite: PGO ==\n${bench_pgo}")
+message("== Replay workload (${HFT_PGO_MESSAGES} messages, best of 3) ==")
+message("Baseline: ${baseline_rate} msgs/sec")
+message("PGO:      ${pgo_rate} msgs/sec")
+message("Gain:     ${gain_sign}${gain_whole}.${gain_frac}%")
+message("PGO-optimised binaries: ${pgo_dir}")
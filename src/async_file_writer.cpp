@@ -0,0 +1,283 @@
+#include "async_file_writer.h"
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+AsyncFileWriter::~AsyncFileWriter() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+/**
+ * @brief Allocates and prefaults the block pool, sets up io_uring and starts the writer thread.
+ */
+void AsyncFileWriter::open(const std::string& path, const AsyncWriterOptions& options) {
+    if (options.block_size == 0 || options.block_size % kAlignment != 0 || options.block_size > UINT32_MAX) {
+        throw std::runtime_error("AsyncFileWriter block size must be a non-zero multiple of 4096");
+    }
+    if (options.block_count < 2 || options.block_count > kMaxBlocks) {
+        throw std::runtime_error("AsyncFileWriter block count must be between 2 and 256");
+    }
+    if (options.direct_io && options.append) {
+        throw std::runtime_error("AsyncFileWriter cannot append with O_DIRECT");
+    }
+    close();
+
+    int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (options.append ? O_APPEND : O_TRUNC) | (options.direct_io ? O_DIRECT : 0);
+    fd_ = ::open(path.c_str(), flags, 0644);
+    if (fd_ < 0) throw std::runtime_error("Failed to open " + path + ": errno " + std::to_string(errno));
+    base_offset_ = 0;
+    if (options.append) {
+        struct stat st {};
+        if (::fstat(fd_, &st) == 0) base_offset_ = static_cast<uint64_t>(st.st_size);
+    }
+
+    block_size_ = options.block_size;
+    block_count_ = options.block_count;
+    direct_io_ = options.direct_io;
+    append_ = options.append;
+    blocks_ = static_cast<uint8_t*>(std::aligned_alloc(kAlignment, block_size_ * block_count_));
+    if (!blocks_) {
+        ::close(fd_);
+        fd_ = -1;
+        throw std::bad_alloc();
+    }
+    std::memset(blocks_, 0, block_size_ * block_count_); // Prefault so appends never page-fault
+    for (uint32_t i = 0; i < block_count_; ++i) free_.push(i);
+
+    current_ = kNoBlock;
+    current_length_ = 0;
+    next_offset_ = base_offset_;
+    handed_off_ = 0;
+    stalls_ = 0;
+    completed_.store(0);
+    error_.value.store(0);
+    stop_.value.store(false);
+
+    ring_.reset();
+    fixed_buffers_ = false;
+    if (!append_ && IoUring::supported()) {
+        try {
+            // One SQE per block is enough: a block is never in flight twice.
+            unsigned entries = 1;
+            while (entries < block_count_) entries <<= 1;
+            ring_ = std::make_unique<IoUring>(entries);
+            std::vector<iovec> iovecs(block_count_);
+            for (size_t i = 0; i < block_count_; ++i) iovecs[i] = {blockData(static_cast<uint32_t>(i)), block_size_};
+            fixed_buffers_ = ring_->registerBuffers(iovecs.data(), static_cast<unsigned>(iovecs.size()));
+        } catch (const std::exception&) {
+            ring_.reset();
+        }
+    }
+    writer_ = std::thread(&AsyncFileWriter::writerLoop, this);
+}
+
+/**
+ * @brief Drains all blocks, stops the writer and trims O_DIRECT padding. Everything is released
+ * before a write error is reported, so the writer is closed (and can be reopened) even if this throws.
+ */
+void AsyncFileWriter::close() {
+    if (fd_ < 0) return;
+    if (current_ != kNoBlock && current_length_ > 0) handOff();
+    stopWriter();
+
+    uint32_t index;
+    while (free_.pop(index)) {
+    }
+    ring_.reset();
+    if (direct_io_ && ::ftruncate(fd_, static_cast<off_t>(next_offset_)) != 0 && error_.value.load() == 0) {
+        error_.value.store(errno);
+    }
+    ::close(fd_);
+    fd_ = -1;
+    std::free(blocks_);
+    blocks_ = nullptr;
+    current_ = kNoBlock;
+    throwIfFailed();
+}
+
+void AsyncFileWriter::flush() {
+    if (!direct_io_ && current_ != kNoBlock && current_length_ > 0) handOff();
+}
+
+void AsyncFileWriter::sync() {
+    flush();
+    while (completed_.load() < handed_off_) std::this_thread::yield();
+    throwIfFailed();
+}
+
+void AsyncFileWriter::throwIfFailed() const {
+    int error = error_.value.load(std::memory_order_relaxed);
+    if (error != 0) throw std::runtime_error("AsyncFileWriter write failed: errno " + std::to_string(error));
+}
+
+/**
+ * @brief Takes a free block, waiting for the writer if all are in flight. Once the file is closed
+ * or a write has failed, appending throws instead of filling blocks that will never land.
+ */
+void AsyncFileWriter::acquireBlock() {
+    if (fd_ < 0) throw std::runtime_error("AsyncFileWriter is not open");
+    throwIfFailed();
+    uint32_t index;
+    if (!free_.pop(index)) {
+        ++stalls_;
+        while (!free_.pop(index)) {
+            throwIfFailed();
+            std::this_thread::yield();
+        }
+    }
+    current_ = index;
+    current_length_ = 0;
+}
+
+/**
+ * @brief Publishes the current block to the writer thread. O_DIRECT blocks are zero-padded to
+ * the alignment; only the final block of a file can be partial.
+ */
+void AsyncFileWriter::handOff() {
+    size_t length = current_length_;
+    if (direct_io_ && length % kAlignment != 0) {
+        size_t padded = (length + kAlignment - 1) & ~(kAlignment - 1);
+        std::memset(blockData(current_) + length, 0, padded - length);
+        length = padded;
+    }
+    filled_.push(BlockWrite{current_, static_cast<uint32_t>(length), next_offset_});
+    next_offset_ += current_length_;
+    ++handed_off_;
+    current_ = kNoBlock;
+    current_length_ = 0;
+}
+
+void AsyncFileWriter::stopWriter() {
+    stop_.value.store(true, std::memory_order_release);
+    if (writer_.joinable()) writer_.join();
+}
+
+/**
+ * @brief Writes a block synchronously: pwrite(2) at its offset, or write(2) at the end of the
+ * file in append mode.
+ */
+void AsyncFileWriter::writeBlock(const BlockWrite& write) {
+    const uint8_t* data = blockData(write.index);
+    size_t done = 0;
+    while (done < write.length) {
+        ssize_t n = append_ ? ::write(fd_, data + done, write.length - done)
+                            : ::pwrite(fd_, data + done, write.length - done, static_cast<off_t>(write.offset + done));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            int expected = 0;
+            error_.value.compare_exchange_strong(expected, n < 0 ? errno : EIO);
+            return;
+        }
+        done += static_cast<size_t>(n);
+    }
+}
+
+/**
+ * @brief Writer thread: batch-submits every handed-over block, reaps completions, resubmits
+ * short writes and recycles finished blocks. Idles with spin, yield, then short sleeps.
+ * If the ring itself fails, the error is recorded, blocks in flight are recycled unwritten and
+ * later blocks go through writeBlock(), so sync() and close() still return.
+ */
+void AsyncFileWriter::writerLoop() {
+    std::vector<BlockWrite> inflight(block_count_);
+    std::vector<uint32_t> written(block_count_, 0);
+    std::vector<uint8_t> pending(block_count_, 0); ///< Submitted to the ring, not yet finished.
+    size_t inflight_count = 0;
+    unsigned idle_rounds = 0;
+    bool use_ring = ring_ != nullptr;
+
+    auto prepare = [&](uint32_t index) {
+        const BlockWrite& write = inflight[index];
+        io_uring_sqe* sqe = ring_->getSqe();
+        sqe->opcode = fixed_buffers_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe->fd = fd_;
+        sqe->addr = reinterpret_cast<uint64_t>(blockData(index) + written[index]);
+        sqe->len = write.length - written[index];
+        sqe->off = write.offset + written[index];
+        if (fixed_buffers_) sqe->buf_index = static_cast<uint16_t>(index);
+        sqe->user_data = index;
+    };
+    auto finish = [&](uint32_t index) {
+        pending[index] = 0;
+        free_.push(index);
+        completed_.add();
+    };
+
+    for (;;) {
+        bool progressed = false;
+        BlockWrite write;
+        while (filled_.pop(write)) {
+            progressed = true;
+            if (!use_ring) {
+                writeBlock(write);
+                finish(write.index);
+                continue;
+            }
+            inflight[write.index] = write;
+            written[write.index] = 0;
+            pending[write.index] = 1;
+            prepare(write.index);
+            ++inflight_count;
+        }
+
+        if (use_ring) {
+            try {
+                ring_->submit();
+                while (io_uring_cqe* cqe = ring_->peekCqe()) {
+                    auto index = static_cast<uint32_t>(cqe->user_data);
+                    int result = cqe->res;
+                    ring_->cqeSeen();
+                    progressed = true;
+                    if (result == -EINTR || result == -EAGAIN) {
+                        prepare(index);
+                        continue;
+                    }
+                    if (result <= 0) {
+                        int expected = 0;
+                        error_.value.compare_exchange_strong(expected, result < 0 ? -result : EIO);
+                    } else {
+                        written[index] += static_cast<uint32_t>(result);
+                        if (written[index] < inflight[index].length) {
+                            prepare(index); // Short write: submit the remainder
+                            continue;
+                        }
+                    }
+                    --inflight_count;
+                    finish(index);
+                }
+                ring_->submit();
+                if (!progressed && inflight_count > 0) {
+                    ring_->submit(1); // Nothing new to submit: block until a write completes
+                    continue;
+                }
+            } catch (const std::exception&) {
+                int expected = 0;
+                error_.value.compare_exchange_strong(expected, EIO);
+                use_ring = false;
+                for (uint32_t index = 0; index < block_count_; ++index) {
+                    if (pending[index]) finish(index);
+                }
+                inflight_count = 0;
+            }
+        }
+
+        if (progressed) {
+            idle_rounds = 0;
+            continue;
+        }
+        if (inflight_count == 0 && stop_.value.load(std::memory_order_acquire) && filled_.empty()) break;
+        if (++idle_rounds < 1000) continue;
+        if (idle_rounds < 2000) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include "io_uring.h"
+#include "padded_counter.h"
+#include "spsc_ring.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Tuning options for AsyncFileWriter.
+ */
+struct AsyncWriterOptions {
+    size_t block_size = 1 << 20; ///< Bytes per block; a multiple of 4096.
+    size_t block_count = 16;     ///< Blocks in the pool (at most kMaxBlocks).
+    bool direct_io = false;      ///< Open with O_DIRECT, bypassing the page cache.
+    bool append = false;         ///< Append (O_APPEND) to an existing file instead of truncating it.
+};
+
+/**
+ * @brief Asynchronous file writer: pipeline threads copy into pooled blocks, a dedicated writer
+ * thread performs all I/O.
+ *
+ * The producing thread fills fixed-size blocks and hands full ones over through an SPSC ring;
+ * it never makes a system call (unless it has to wait for a free block). The writer thread
+ * submits handed-over blocks as IORING_OP_WRITE_FIXED requests against registered buffers,
+ * batching every block available into one io_uring_enter, and returns blocks to the free ring
+ * as completions arrive. Without io_uring it falls back to pwrite(2) on the writer thread.
+ *
+ * With direct_io, partial blocks can only be written at close(): the last block is padded to
+ * the block alignment and the file is truncated back to its logical size afterwards.
+ *
+ * With append the file is opened O_APPEND and the writer thread issues plain write(2) calls one
+ * block at a time, so blocks land in order at the end of the file even while other processes
+ * append to it too. io_uring is not used in that mode: concurrent in-flight appends could land
+ * out of order.
+ *
+ * Single producer: append()/flush()/sync() must be called from one thread at a time.
+ */
+class AsyncFileWriter {
+public:
+    static constexpr size_t kMaxBlocks = 256;   ///< Upper bound on AsyncWriterOptions::block_count.
+    static constexpr size_t kAlignment = 4096;  ///< Block and O_DIRECT alignment.
+
+    AsyncFileWriter() = default;
+
+    /**
+     * @brief Opens path and starts the writer thread.
+     * @throws std::runtime_error if the file cannot be opened or options are invalid.
+     */
+    explicit AsyncFileWriter(const std::string& path, const AsyncWriterOptions& options = {}) {
+        open(path, options);
+    }
+
+    /**
+     * @brief Writes out remaining data and stops the writer thread.
+     */
+    ~AsyncFileWriter();
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    /**
+     * @brief Opens path and starts the writer thread (closing any previous file first).
+     * @throws std::runtime_error if the file cannot be opened or options are invalid.
+     */
+    void open(const std::string& path, const AsyncWriterOptions& options = {});
+
+    /**
+     * @brief Writes all data handed over so far, stops the writer thread and closes the file.
+     * @throws std::runtime_error if any write failed; the file is closed regardless.
+     */
+    void close();
+
+    bool isOpen() const noexcept { return fd_ >= 0; }
+
+    /**
+     * @brief Copies data into the current block, handing full blocks to the writer thread.
+     *
+     * Waits (spinning, then yielding) only if every block is in flight; such waits are counted
+     * in stalls().
+     * @throws std::runtime_error when it needs a block after close() or after a write failed.
+     */
+    void append(const void* data, size_t size) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        while (size > 0) {
+            if (current_ == kNoBlock) acquireBlock();
+            size_t chunk = std::min(size, block_size_ - current_length_);
+            std::memcpy(blockData(current_) + current_length_, bytes, chunk);
+            current_length_ += chunk;
+            bytes += chunk;
+            size -= chunk;
+            if (current_length_ == block_size_) handOff();
+        }
+    }
+
+    /**
+     * @brief Hands the partially filled block to the writer thread (no-op with direct_io).
+     */
+    void flush();
+
+    /**
+     * @brief Flushes and waits until every handed-over block has reached the file.
+     * @throws std::runtime_error if any write failed.
+     */
+    void sync();
+
+    /**
+     * @brief True if the writer thread uses io_uring (false: pwrite/write fallback).
+     */
+    bool usingIoUring() const noexcept { return ring_ != nullptr; }
+
+    /**
+     * @brief Number of times the producer had to wait for a free block.
+     */
+    uint64_t stalls() const noexcept { return stalls_; }
+
+    /**
+     * @brief Logical bytes appended so far.
+     */
+    uint64_t size() const noexcept { return next_offset_ + current_length_ - base_offset_; }
+
+private:
+    static constexpr uint32_t kNoBlock = UINT32_MAX;
+
+    /// Descriptor of a block handed to the writer thread.
+    struct BlockWrite {
+        uint32_t index;  ///< Block index in the pool.
+        uint32_t length; ///< Bytes to write (padded for direct_io).
+        uint64_t offset; ///< File offset.
+    };
+
+    uint8_t* blockData(uint32_t index) const noexcept { return blocks_ + static_cast<size_t>(index) * block_size_; }
+    void acquireBlock();
+    void handOff();
+    void throwIfFailed() const;
+    void writerLoop();
+    void writeBlock(const BlockWrite& write);
+    void stopWriter();
+
+    SpscRing<BlockWrite, kMaxBlocks> filled_;  ///< Producer -> writer: blocks to write.
+    SpscRing<uint32_t, kMaxBlocks> free_;      ///< Writer -> producer: blocks available for reuse.
+
+    // Producer-side state.
+    uint8_t* blocks_ = nullptr;    ///< Block pool, kAlignment-aligned.
+    size_t block_size_ = 0;
+    size_t block_count_ = 0;
+    uint32_t current_ = kNoBlock;  ///< Block being filled.
+    size_t current_length_ = 0;    ///< Bytes in the current block.
+    uint64_t next_offset_ = 0;     ///< File offset of the current block.
+    uint64_t base_offset_ = 0;     ///< File size when opened (append mode).
+    uint64_t handed_off_ = 0;      ///< Blocks handed to the writer.
+    uint64_t stalls_ = 0;          ///< Waits for a free block.
+    bool direct_io_ = false;
+    bool append_ = false;          ///< O_APPEND: write(2) in order, ignore offsets.
+    int fd_ = -1;
+
+    // Writer-side state.
+    std::unique_ptr<IoUring> ring_;     ///< Null when io_uring is unavailable or in append mode.
+    bool fixed_buffers_ = false;        ///< Blocks registered as fixed buffers.
+    std::thread writer_;
+    PaddedCounter completed_;           ///< Blocks fully written, published by the writer.
+    CachePadded<std::atomic<int>> error_; ///< First write errno, 0 if none.
+    CachePadded<std::atomic<bool>> stop_; ///< Set by close() to end the writer loop.
+};
@@ -0,0 +1,105 @@
+#include "basket_calculator.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+uint32_t BasketCalculator::addBasket(const std::string& name, const std::vector<Constituent>& constituents) {
+    if (constituents.empty()) throw std::runtime_error("Basket " + name + " has no constituents");
+    std::vector<uint64_t> unseen; // Checked up front so a failed add interns nothing
+    for (const Constituent& constituent : constituents) {
+        if (directory_.find(constituent.ticker) == kInvalidSymbol) unseen.push_back(constituent.ticker);
+    }
+    std::sort(unseen.begin(), unseen.end());
+    unseen.erase(std::unique(unseen.begin(), unseen.end()), unseen.end());
+    if (directory_.size() + unseen.size() > directory_.capacity()) {
+        throw std::runtime_error("Basket " + name + " exceeds the constituent capacity");
+    }
+    // One entry per constituent (duplicates merged), so a symbol's fan-out run reaches a basket
+    // once and an exact re-sum inside the run is never followed by a stale increment.
+    const auto basket = static_cast<uint32_t>(baskets_.size());
+    const size_t first_entry = basket_symbols_.size();
+    for (const Constituent& constituent : constituents) {
+        uint32_t symbol = directory_.intern(constituent.ticker);
+        auto begin = basket_symbols_.begin() + static_cast<std::ptrdiff_t>(first_entry);
+        auto it = std::find(begin, basket_symbols_.end(), symbol);
+        if (it != basket_symbols_.end()) {
+            basket_weights_[static_cast<size_t>(it - basket_symbols_.begin())] += constituent.weight;
+        } else {
+            basket_symbols_.push_back(symbol);
+            basket_weights_.emplace_back(constituent.weight);
+        }
+    }
+    prices_.resize(directory_.size(), 0.0);
+    priced_.resize(directory_.size(), 0);
+    basket_offsets_.push_back(static_cast<uint32_t>(basket_symbols_.size()));
+    const size_t entries = basket_symbols_.size() - first_entry;
+    Basket state;
+    for (size_t k = first_entry; k < basket_symbols_.size(); ++k) state.priced += priced_[basket_symbols_[k]];
+    state.recompute_after = recompute_interval_ == 0
+                                ? std::numeric_limits<uint32_t>::max()
+                                : static_cast<uint32_t>(std::min<size_t>(std::max(recompute_interval_, entries),
+                                                                         std::numeric_limits<uint32_t>::max()));
+    baskets_.push_back(state);
+    names_.push_back(name);
+    recompute(basket);
+    rebuildFanOut();
+    return basket;
+}
+
+void BasketCalculator::recompute(uint32_t basket) noexcept {
+    double value = 0;
+    for (uint32_t k = basket_offsets_[basket]; k < basket_offsets_[basket + 1]; ++k) {
+        value += basket_weights_[k] * prices_[basket_symbols_[k]];
+    }
+    baskets_[basket].value = value;
+    baskets_[basket].since_exact = 0;
+}
+
+void BasketCalculator::recomputeAll() noexcept {
+    for (uint32_t basket = 0; basket < baskets_.size(); ++basket) recompute(basket);
+}
+
+/**
+ * @brief Regroups the basket entries by constituent (a counting sort), so a tick reads one
+ * contiguous run of (basket, weight) pairs.
+ */
+void BasketCalculator::rebuildFanOut() {
+    const size_t symbols = directory_.size();
+    fan_offsets_.assign(symbols + 1, 0);
+    for (uint32_t symbol : basket_symbols_) ++fan_offsets_[symbol + 1];
+    for (size_t symbol = 0; symbol < symbols; ++symbol) fan_offsets_[symbol + 1] += fan_offsets_[symbol];
+    fan_baskets_.resize(basket_symbols_.size());
+    fan_weights_.resize(basket_symbols_.size());
+    std::vector<uint32_t> next(fan_offsets_.begin(), fan_offsets_.end() - 1);
+    for (uint32_t basket = 0; basket < baskets_.size(); ++basket) {
+        for (uint32_t k = basket_offsets_[basket]; k < basket_offsets_[basket + 1]; ++k) {
+            uint32_t slot = next[basket_symbols_[k]]++;
+            fan_baskets_[slot] = basket;
+            fan_weights_[slot] = basket_weights_[k];
+        }
+    }
+}
+
+size_t loadBaskets(const std::string& path, BasketCalculator& calculator) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open basket file " + path);
+    std::map<std::string, std::vector<BasketCalculator::Constituent>> baskets;
+    std::string line;
+    for (size_t number = 1; std::getline(in, line); ++number) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        size_t first = line.find(','), second = line.find(',', first == std::string::npos ? first : first + 1);
+        double weight = 0;
+        const char* weight_end = line.data() + line.size();
+        if (first == 0 || first == std::string::npos || second == std::string::npos || second == first + 1 ||
+            std::from_chars(line.data() + second + 1, weight_end, weight).ptr != weight_end) {
+            throw std::runtime_error(path + ":" + std::to_string(number) + ": expected BASKET,SYMBOL,weight");
+        }
+        baskets[line.substr(0, first)].push_back({packTicker(line.substr(first + 1, second - first - 1)), weight});
+    }
+    for (const auto& [name, constituents] : baskets) calculator.addBasket(name, constituents);
+    return baskets.size();
+}
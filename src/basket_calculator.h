@@ -0,0 +1,138 @@
+#pragma once
+#include "symbol_directory.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Incremental fair values of weighted baskets (indices, ETFs) over shared constituents.
+ *
+ * Each basket's value is sum(weight x last price) over its constituents. Constituent tickers are
+ * interned into dense IDs, and a symbol-to-basket fan-out table in CSR form (offsets plus flat
+ * basket/weight arrays) lists every basket a constituent belongs to, so a tick touches only the
+ * baskets holding that symbol, each with one multiply-add of weight x price change.
+ *
+ * Incremental updates accumulate rounding error, so each basket is re-summed exactly from the
+ * stored prices after max(recompute_interval, constituents) incremental updates; the amortised
+ * cost stays under one multiply-add per update while the error stays bounded by one fresh sum.
+ *
+ * Owned by a single thread (the consumer); not thread-safe.
+ */
+class BasketCalculator {
+public:
+    static constexpr size_t kDefaultRecomputeInterval = 4096;
+
+    struct Constituent {
+        uint64_t ticker; ///< Packed ticker (see packTicker).
+        double weight;   ///< Units per basket (e.g. shares per ETF share, or index weight / divisor).
+    };
+
+    /**
+     * @brief Constructs an empty calculator.
+     * @param max_symbols Maximum number of distinct constituents over all baskets.
+     * @param recompute_interval Minimum incremental updates between exact re-sums of a basket;
+     * 0 never re-sums.
+     */
+    explicit BasketCalculator(size_t max_symbols, size_t recompute_interval = kDefaultRecomputeInterval)
+        : directory_(max_symbols), fan_offsets_(1, 0), basket_offsets_(1, 0), recompute_interval_(recompute_interval) {}
+
+    /**
+     * @brief Adds a basket; its value starts from the constituent prices already seen.
+     * A ticker listed twice is one constituent with the sum of its weights.
+     * @return Basket index.
+     * @throws std::runtime_error if the constituents overflow max_symbols or the list is empty.
+     */
+    uint32_t addBasket(const std::string& name, const std::vector<Constituent>& constituents);
+
+    /**
+     * @brief Applies a price for a packed ticker.
+     * @return Number of baskets updated (0 if the ticker is not a constituent).
+     */
+    size_t update(uint64_t ticker, double price) noexcept {
+        uint32_t symbol = directory_.find(ticker);
+        return symbol == kInvalidSymbol ? 0 : updateSymbol(symbol, price);
+    }
+
+    /**
+     * @brief Applies a price for a constituent ID (see symbol()), skipping the ticker lookup.
+     * @return Number of baskets updated.
+     */
+    size_t updateSymbol(uint32_t symbol, double price) noexcept {
+        const double change = price - prices_[symbol]; // Unpriced constituents hold 0
+        const bool first = !priced_[symbol];
+        prices_[symbol] = price;
+        priced_[symbol] = 1;
+        const uint32_t begin = fan_offsets_[symbol], end = fan_offsets_[symbol + 1];
+        for (uint32_t k = begin; k < end; ++k) {
+            Basket& basket = baskets_[fan_baskets_[k]];
+            basket.value += fan_weights_[k] * change;
+            basket.priced += first;
+            if (++basket.since_exact >= basket.recompute_after) recompute(fan_baskets_[k]);
+        }
+        return end - begin;
+    }
+
+    /**
+     * @brief Constituent ID of a packed ticker, or kInvalidSymbol.
+     */
+    uint32_t symbol(uint64_t ticker) const noexcept { return directory_.find(ticker); }
+
+    size_t size() const noexcept { return baskets_.size(); }
+    bool empty() const noexcept { return baskets_.empty(); }
+    const std::string& name(uint32_t basket) const noexcept { return names_[basket]; }
+
+    /**
+     * @brief Current value: sum of weight x last price, with unpriced constituents at 0.
+     */
+    double value(uint32_t basket) const noexcept { return baskets_[basket].value; }
+
+    /**
+     * @brief True once every constituent of the basket has a price.
+     */
+    bool ready(uint32_t basket) const noexcept { return baskets_[basket].priced == constituents(basket); }
+
+    uint32_t constituents(uint32_t basket) const noexcept { return basket_offsets_[basket + 1] - basket_offsets_[basket]; }
+
+    /**
+     * @brief Re-sums a basket exactly from the stored prices.
+     */
+    void recompute(uint32_t basket) noexcept;
+
+    /**
+     * @brief Re-sums every basket.
+     */
+    void recomputeAll() noexcept;
+
+private:
+    struct Basket {
+        double value = 0;             ///< Running sum of weight x price.
+        uint32_t priced = 0;          ///< Constituent entries with a price.
+        uint32_t since_exact = 0;     ///< Incremental updates since the last exact sum.
+        uint32_t recompute_after = 0; ///< since_exact threshold for the next exact sum.
+    };
+
+    void rebuildFanOut();
+
+    SymbolDirectory directory_;          ///< Constituent ticker to constituent ID.
+    std::vector<double> prices_;         ///< Last price per constituent ID.
+    std::vector<uint8_t> priced_;        ///< 1 once a constituent has a price.
+    std::vector<uint32_t> fan_offsets_;  ///< Constituent ID -> first entry in fan_baskets_/fan_weights_.
+    std::vector<uint32_t> fan_baskets_;  ///< Basket per fan-out entry.
+    std::vector<double> fan_weights_;    ///< Weight per fan-out entry.
+    std::vector<uint32_t> basket_offsets_; ///< Basket -> first entry in basket_symbols_/basket_weights_.
+    std::vector<uint32_t> basket_symbols_; ///< Constituent ID per basket entry.
+    std::vector<double> basket_weights_;   ///< Weight per basket entry.
+    std::vector<Basket> baskets_;
+    std::vector<std::string> names_;
+    size_t recompute_interval_;
+};
+
+/**
+ * @brief Adds the baskets defined in a file of "BASKET,SYMBOL,weight" lines (blank lines and
+ * lines starting with '#' are skipped; a basket's lines need not be adjacent).
+ * @return Number of baskets added.
+ * @throws std::runtime_error if the file cannot be read, a line is malformed, or a basket
+ * cannot be added.
+ */
+size_t loadBaskets(const std::string& path, BasketCalculator& calculator);
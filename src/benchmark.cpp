@@ -1,11 +1,75 @@
 #include "lock_free_queue.h"
 #include "types.h"
 #include "memory_pool.h"
+#include "journal.h"
+#include "market_state.h"
+#include "snapshot.h"
+#include "padded_counter.h"
+#include "simd_kernels.h"
+#include "async_file_writer.h"
+#include "basket_calculator.h"
+#include "book_signals.h"
+#include "clock.h"
+#include "feed_receiver.h"
+#include "file_io.h"
+#include "fixed_price.h"
+#include "nbbo_consolidator.h"
+#include "order_manager.h"
+#include "pcap_reader.h"
+#include "pcap_writer.h"
+#include "perfect_hash.h"
+#include "position_tracker.h"
+#include "price_ladder.h"
+#include "radix_sort.h"
+#include "simulated_exchange.h"
+#include "subscription_filter.h"
+#include "symbol_universe.h"
+#include "tick_scan.h"
+#include "tick_store.h"
+#include "timer_wheel.h"
+#include <fstream>
+#include <map>
 #include <queue>
 #include <mutex>
 #include <thread>
 #include <chrono>
+#include <cstdio>
+#include <deque>
+#include <random>
 #include <iostream>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#if defined(HFT_HAVE_PARALLEL_STL)
+#include <execution>
+#endif
+
+namespace {
+constexpr size_t kStaticUniverse = 2048;
+
+/// Synthetic compile-time universe "U0000".."U2047" for the perfect hash benchmark.
+constexpr std::array<uint64_t, kStaticUniverse> staticUniverseKeys() {
+    std::array<uint64_t, kStaticUniverse> keys{};
+    for (size_t i = 0; i < kStaticUniverse; ++i) {
+        const char text[5] = {'U', static_cast<char>('0' + i / 1000 % 10), static_cast<char>('0' + i / 100 % 10),
+                              static_cast<char>('0' + i / 10 % 10), static_cast<char>('0' + i % 10)};
+        keys[i] = packTicker(std::string_view(text, sizeof(text)));
+    }
+    return keys;
+}
+
+constexpr PerfectSymbolTable<kStaticUniverse> kStaticTable(staticUniverseKeys());
+static_assert(kStaticTable.find("U0042") == 42 && kStaticTable.find("U9999") == kInvalidSymbol &&
+              kStaticTable.find(uint64_t{0}) == kInvalidSymbol);
+} // namespace
 
 struct Benchmark {
     static void run_mutex_queue(size_t iterations) {
@@ -16,7 +80,7 @@ struct Benchmark {
 
         auto producer = [&]() {
             for (size_t i = 0; i < iterations; ++i) {
-                MarketData data{"TEST", 100.0, 100};
+                MarketData data{"TEST", 100.0, 100, 0};
                 std::lock_guard<std::mutex> lock(mutex);
                 queue.push(data);
             }
@@ -61,7 +125,7 @@ struct Benchmark {
 
         auto producer = [&]() {
             for (size_t i = 0; i < iterations; ++i) {
-                MarketData data{"TEST", 100.0, 100};
+                MarketData data{"TEST", 100.0, 100, 0};
                 while (!queue.push(data)) {
                     std::this_thread::yield();
                 }
@@ -96,7 +160,7 @@ struct Benchmark {
         // Standard allocation
         auto start = std::chrono::high_resolution_clock::now();
         for (size_t i = 0; i < iterations; ++i) {
-            MarketData* data = new MarketData{"TEST", 100.0, 100};
+            MarketData* data = new MarketData{"TEST", 100.0, 100, 0};
             delete data;
         }
         auto end = std::chrono::high_resolution_clock::now();
@@ -118,13 +182,1944 @@ struct Benchmark {
                   << duration / 1000.0 << " ms, "
                   << (iterations * 1000000.0 / duration) << " allocs/sec\n";
     }
+
+    static void run_snapshot_restore(size_t symbols, size_t tail_updates) {
+        const std::string snapshot_path = "benchmark.snap";
+        const std::string journal_path = "benchmark.journal";
+        std::remove(snapshot_path.c_str());
+        Journal::removeSegments(journal_path);
+
+        // Build state for `symbols` symbols and journal every update, as the consumer does.
+        MarketState state(symbols);
+        uint64_t sequence = 0;
+        {
+            Journal journal(journal_path);
+            auto update = [&](size_t i) {
+                uint64_t ticker = packTicker("S" + std::to_string(i % symbols));
+                double price = 100.0 + static_cast<double>(i % 1000) / 100.0;
+                int32_t volume = static_cast<int32_t>(i % 500) + 1;
+                state.apply(ticker, price, volume, ++sequence);
+                journal.append(JournalRecord{sequence, ticker, price, volume, 0});
+            };
+            const size_t full_day = symbols * 100;
+            for (size_t i = 0; i < full_day; ++i) update(i);
+            journal.flush();
+
+            // Time a full-journal replay before the snapshot retires it, for comparison.
+            MarketState replayed(symbols);
+            auto start = std::chrono::high_resolution_clock::now();
+            size_t count = Journal::replay(journal_path, 0, [&](const JournalRecord& r) {
+                replayed.apply(r.ticker, r.price, r.volume, r.sequence);
+            });
+            auto end = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+            std::cout << "Full Journal Replay: " << count << " records, " << symbols << " symbols, "
+                      << duration / 1000.0 << " ms\n";
+
+            start = std::chrono::high_resolution_clock::now();
+            journal.rotate();
+            writeSnapshot(snapshot_path, state);
+            journal.retire(true);
+            end = std::chrono::high_resolution_clock::now();
+            duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+            std::cout << "Snapshot Write + Journal Retire: " << duration / 1000.0 << " ms\n";
+
+            for (size_t i = 0; i < tail_updates; ++i) update(i);
+        }
+
+        MarketState restored(symbols);
+        auto start = std::chrono::high_resolution_clock::now();
+        RecoveryResult result = recoverMarketState(snapshot_path, journal_path, restored);
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        bool match = restored.sequence() == state.sequence() && restored.directory().size() == state.directory().size();
+        std::cout << "Snapshot Restore + Tail Replay: " << restored.directory().size() << " symbols, "
+                  << result.replayed << " tail records, " << duration / 1000.0 << " ms"
+                  << (match ? "" : " (STATE MISMATCH)") << "\n";
+
+        std::remove(snapshot_path.c_str());
+        Journal::removeSegments(journal_path);
+    }
+
+    static void run_false_sharing(size_t iterations) {
+        constexpr size_t kThreads = 4;
+
+        // Before: per-thread counters packed next to each other, as packet_count was beside running.
+        struct PackedCounters {
+            std::atomic<uint64_t> counts[kThreads];
+        };
+        // After: each thread's counter alone on its cache line.
+        struct Counters {
+            std::atomic<uint64_t> count;
+        };
+
+        auto time_threads = [&](auto&& work) {
+            auto start = std::chrono::high_resolution_clock::now();
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < kThreads; ++t) threads.emplace_back(work, t);
+            for (auto& thread : threads) thread.join();
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        };
+
+        PackedCounters packed{};
+        auto duration = time_threads([&](size_t t) {
+            for (size_t i = 0; i < iterations; ++i) bumpCounter(packed.counts[t]);
+        });
+        std::cout << "Adjacent Counters (false sharing): " << kThreads << " threads x " << iterations << " increments, "
+                  << duration / 1000.0 << " ms, "
+                  << (kThreads * iterations * 1000000.0 / duration) << " increments/sec\n";
+
+        PerThreadStats<Counters, kThreads> padded;
+        duration = time_threads([&](size_t t) {
+            Counters& local = padded.local(t);
+            for (size_t i = 0; i < iterations; ++i) bumpCounter(local.count);
+        });
+        uint64_t total = 0;
+        padded.forEach([&](const Counters& c) { total += c.count.load(std::memory_order_relaxed); });
+        std::cout << "Padded Per-Thread Counters: " << kThreads << " threads x " << iterations << " increments, "
+                  << duration / 1000.0 << " ms, "
+                  << (kThreads * iterations * 1000000.0 / duration) << " increments/sec"
+                  << (total == kThreads * iterations ? "" : " (COUNT MISMATCH)") << "\n";
+    }
+
+    static void run_simd_dispatch(size_t bytes) {
+        // Random printable text with sparse delimiters, like a CSV feed; int64 column for sums.
+        std::vector<char> text(bytes);
+        std::mt19937_64 rng(7);
+        for (auto& c : text) c = static_cast<char>('A' + rng() % 26);
+        for (size_t i = 0; i < bytes; i += 64 + rng() % 64) text[i] = ',';
+        std::vector<int64_t> column(bytes / sizeof(int64_t));
+        for (auto& v : column) v = static_cast<int64_t>(rng() % 1000000) - 500000;
+
+        // One cache-resident tick block for the range filter: ~25% of rows match.
+        constexpr size_t kRows = 4096;
+        std::vector<uint64_t> times(kRows);
+        std::vector<int64_t> prices(kRows);
+        std::vector<int32_t> sizes(kRows);
+        for (size_t i = 0; i < kRows; ++i) {
+            times[i] = 1'000'000 + i * 1000;
+            prices[i] = static_cast<int64_t>(rng() % 4000);
+            sizes[i] = static_cast<int32_t>(rng() % 1000);
+        }
+        const ColumnRanges ranges{1'500'000, 4'000'000'000, 1000, 2999, 500, INT32_MAX};
+        std::vector<uint32_t> selection(kRows), expected_selection(kRows);
+
+        const SimdKernels& reference = simdKernelsFor(IsaLevel::Scalar);
+        const uint64_t expected_checksum = reference.checksum(text.data(), text.size());
+        const int64_t expected_sum = reference.sum_i64(column.data(), column.size());
+        const size_t expected_selected =
+            reference.select_ranges(times.data(), prices.data(), sizes.data(), kRows, ranges, expected_selection.data());
+        expected_selection.resize(expected_selected);
+        std::cout << "Detected ISA: " << isaName(detectedIsa()) << "\n";
+
+        const IsaLevel startup_level = simd().level;
+        for (IsaLevel level : {IsaLevel::Scalar, IsaLevel::SSE42, IsaLevel::AVX2, IsaLevel::AVX512}) {
+            if (level > detectedIsa()) break;
+            setSimdLevel(level);
+            const SimdKernels& k = simd();
+            auto time_ms = [](auto&& fn) {
+                auto start = std::chrono::high_resolution_clock::now();
+                fn();
+                auto end = std::chrono::high_resolution_clock::now();
+                return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+            };
+
+            size_t fields = 0;
+            double scan_ms = time_ms([&] {
+                const char* end = text.data() + text.size();
+                for (const char* p = text.data(); (p = k.find_delimiter(p, end, ',', '\n')) < end; ++p) ++fields;
+            });
+            uint64_t checksum = 0;
+            double checksum_ms = time_ms([&] { checksum = k.checksum(text.data(), text.size()); });
+            int64_t sum = 0;
+            double sum_ms = time_ms([&] { sum = k.sum_i64(column.data(), column.size()); });
+            const size_t select_rounds = bytes / (kRows * 20);
+            size_t selected = 0;
+            double select_ms = time_ms([&] {
+                for (size_t round = 0; round < select_rounds; ++round) {
+                    selected = k.select_ranges(times.data(), prices.data(), sizes.data(), kRows, ranges, selection.data());
+                }
+            });
+            bool selection_ok = selected == expected_selected &&
+                                std::equal(expected_selection.begin(), expected_selection.end(), selection.begin());
+
+            double gb = static_cast<double>(bytes) / 1e9;
+            std::cout << "SIMD " << isaName(level) << ": delimiter scan " << gb / (scan_ms / 1000.0) << " GB/s ("
+                      << fields << " fields), checksum " << gb / (checksum_ms / 1000.0) << " GB/s, sum_i64 "
+                      << gb / (sum_ms / 1000.0) << " GB/s, select_ranges "
+                      << static_cast<double>(select_rounds * kRows) / 1e6 / (select_ms / 1000.0) << " M rows/s"
+                      << (checksum == expected_checksum && sum == expected_sum && selection_ok ? "" : " (RESULT MISMATCH)")
+                      << "\n";
+        }
+        setSimdLevel(startup_level);
+    }
+    static void run_async_writer(size_t bytes) {
+        // Journal-like stream: fixed 64-byte records appended one at a time.
+        const std::string path = "benchmark.io";
+        constexpr size_t kRecordSize = 64;
+        const size_t records = bytes / kRecordSize;
+        char record[kRecordSize];
+        for (size_t i = 0; i < kRecordSize; ++i) record[i] = static_cast<char>('a' + i % 26);
+
+        auto report = [&](const char* name, double append_ms, double total_ms, const std::string& extra) {
+            struct stat st {};
+            bool size_ok = ::stat(path.c_str(), &st) == 0 && static_cast<size_t>(st.st_size) == records * kRecordSize;
+            double gb = static_cast<double>(records * kRecordSize) / 1e9;
+            std::cout << name << ": " << records << " records, append " << append_ms << " ms, total " << total_ms
+                      << " ms, " << gb / (total_ms / 1000.0) << " GB/s" << extra
+                      << (size_ok ? "" : " (SIZE MISMATCH)") << "\n";
+            std::remove(path.c_str());
+        };
+        auto elapsed_ms = [](auto start) {
+            auto end = std::chrono::high_resolution_clock::now();
+            return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0;
+        };
+
+        {
+            auto start = std::chrono::high_resolution_clock::now();
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            for (size_t i = 0; i < records; ++i) out.write(record, kRecordSize);
+            double append_ms = elapsed_ms(start);
+            out.close();
+            report("ofstream", append_ms, elapsed_ms(start), "");
+        }
+        {
+            // Synchronous baseline: 64 KiB buffer written with write(2) on the appending thread.
+            auto start = std::chrono::high_resolution_clock::now();
+            int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            std::vector<char> buffer(64 * 1024);
+            size_t used = 0;
+            for (size_t i = 0; i < records; ++i) {
+                std::memcpy(buffer.data() + used, record, kRecordSize);
+                used += kRecordSize;
+                if (used == buffer.size()) {
+                    writeAll(fd, buffer.data(), used);
+                    used = 0;
+                }
+            }
+            writeAll(fd, buffer.data(), used);
+            double append_ms = elapsed_ms(start);
+            ::close(fd);
+            report("write(2) 64 KiB", append_ms, elapsed_ms(start), "");
+        }
+        for (bool direct : {false, true}) {
+            const char* name = direct ? "AsyncFileWriter O_DIRECT" : "AsyncFileWriter";
+            try {
+                auto start = std::chrono::high_resolution_clock::now();
+                AsyncFileWriter writer(path, AsyncWriterOptions{1 << 20, 16, direct, false});
+                for (size_t i = 0; i < records; ++i) writer.append(record, kRecordSize);
+                double append_ms = elapsed_ms(start);
+                bool uring = writer.usingIoUring();
+                uint64_t stalls = writer.stalls();
+                writer.close();
+                report(name, append_ms, elapsed_ms(start),
+                       std::string(uring ? " (io_uring" : " (pwrite") + ", " + std::to_string(stalls) + " stalls)");
+            } catch (const std::exception& e) {
+                std::cout << name << ": skipped (" << e.what() << ")\n";
+                std::remove(path.c_str());
+            }
+        }
+    }
+    static void run_feed_receiver(size_t datagrams) {
+        // Loopback feed: a sender thread with a bounded in-flight window (so neither backend is
+        // measured through socket-buffer drops), and a receiver that polls, then drains the queue.
+        constexpr size_t kUpdatesPerDatagram = 4;
+        constexpr size_t kWindow = 256;
+        const double ns_per_tick = TscClock::nsPerTick();
+
+        for (FeedBackend backend : {FeedBackend::Recvmmsg, FeedBackend::IoUring}) {
+            std::unique_ptr<FeedReceiver> receiver;
+            try {
+                receiver = makeFeedReceiver(backend, FeedEndpoint{"127.0.0.1", 0, ""});
+            } catch (const std::exception& e) {
+                std::cout << "Feed " << feedBackendName(backend) << ": skipped (" << e.what() << ")\n";
+                continue;
+            }
+            MemoryPool pool(8192);
+            LockFreeQueue queue(8192, pool);
+            std::vector<std::atomic<uint64_t>> send_ticks(datagrams);
+            std::atomic<uint64_t> consumed{0};
+            std::atomic<bool> sender_done{false};
+
+            // The datagram index travels in the volume field so the receiver can find its send time.
+            std::thread sender([&] {
+                int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+                sockaddr_in to{};
+                to.sin_family = AF_INET;
+                to.sin_port = htons(receiver->port());
+                to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                ::connect(fd, reinterpret_cast<sockaddr*>(&to), sizeof(to));
+                WireUpdate updates[kUpdatesPerDatagram];
+                uint8_t packet[kMaxDatagramSize];
+                for (size_t i = 0; i < datagrams; ++i) {
+                    while (i - consumed.load(std::memory_order_acquire) >= kWindow) std::this_thread::yield();
+                    for (size_t u = 0; u < kUpdatesPerDatagram; ++u) {
+                        updates[u] = WireUpdate{packTicker(u % 2 ? "AAPL" : "MSFT"), 100.0 + static_cast<double>(u),
+                                                static_cast<int32_t>(i), 0};
+                    }
+                    uint64_t now = TscClock::now();
+                    size_t size = encodeDatagram(packet, i + 1, now, updates, kUpdatesPerDatagram);
+                    send_ticks[i].store(now, std::memory_order_relaxed);
+                    ::send(fd, packet, size, 0);
+                }
+                ::close(fd);
+                sender_done.store(true, std::memory_order_release);
+            });
+
+            std::vector<uint64_t> latencies;
+            latencies.reserve(datagrams * kUpdatesPerDatagram);
+            size_t updates_seen = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            auto last_progress = start;
+            while (updates_seen < datagrams * kUpdatesPerDatagram) {
+                receiver->poll(queue);
+                MarketData data;
+                bool progressed = false;
+                while (queue.pop(data)) {
+                    uint64_t sent = send_ticks[static_cast<size_t>(data.volume)].load(std::memory_order_relaxed);
+                    latencies.push_back(static_cast<uint64_t>((TscClock::now() - sent) * ns_per_tick));
+                    ++updates_seen;
+                    progressed = true;
+                }
+                consumed.store(updates_seen / kUpdatesPerDatagram, std::memory_order_release);
+                auto now = std::chrono::high_resolution_clock::now();
+                if (progressed) {
+                    last_progress = now;
+                } else if (sender_done.load(std::memory_order_acquire) && now - last_progress > std::chrono::milliseconds(200)) {
+                    break; // Datagrams lost; report what arrived
+                }
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            sender.join();
+
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+            std::sort(latencies.begin(), latencies.end());
+            auto percentile = [&](double p) {
+                return latencies.empty() ? 0 : latencies[static_cast<size_t>(p * static_cast<double>(latencies.size() - 1))];
+            };
+            const ReceiverStats& stats = receiver->stats();
+            std::cout << "Feed " << feedBackendName(backend) << ": " << stats.datagrams << " datagrams, "
+                      << duration / 1000.0 << " ms, " << static_cast<uint64_t>(stats.datagrams * 1e6 / duration)
+                      << " pps, p50 " << percentile(0.50) << " ns, p99 " << percentile(0.99) << " ns"
+                      << (stats.datagrams == datagrams && stats.gaps == 0 && stats.malformed == 0 ? ""
+                                                                                                  : " (DATAGRAMS LOST)")
+                      << "\n";
+        }
+    }
+    static void run_pcap_replay(size_t datagrams) {
+        // Synthetic feed capture: VLAN-tagged datagrams for 239.1.1.1:30001 with every fourth
+        // followed by one for another port, which the filter must skip.
+        constexpr size_t kUpdatesPerDatagram = 8;
+        constexpr uint32_t kGroup = 0xef010101;
+        const CaptureFilter filter{kGroup, 30001};
+
+        for (CaptureFormat format : {CaptureFormat::Pcap, CaptureFormat::PcapNg}) {
+            const std::string path = format == CaptureFormat::Pcap ? "benchmark.pcap" : "benchmark.pcapng";
+            const char* name = format == CaptureFormat::Pcap ? "pcap" : "pcapng";
+            {
+                PcapWriter writer(path, format);
+                WireUpdate updates[kUpdatesPerDatagram];
+                uint8_t packet[kMaxDatagramSize];
+                for (size_t i = 0; i < datagrams; ++i) {
+                    for (size_t u = 0; u < kUpdatesPerDatagram; ++u) {
+                        updates[u] = WireUpdate{packTicker(u % 2 ? "AAPL" : "MSFT"), 100.0 + static_cast<double>(u),
+                                                static_cast<int32_t>(i), 0};
+                    }
+                    uint64_t timestamp = 1'700'000'000'000'000'000ULL + i * 1000;
+                    size_t size = encodeDatagram(packet, i + 1, timestamp, updates, kUpdatesPerDatagram);
+                    writer.writeUdp(timestamp, 0x0a000001, kGroup, 40000, 30001, packet, size, 100);
+                    if (i % 4 == 3) writer.writeUdp(timestamp, 0x0a000001, kGroup, 40000, 30002, packet, size);
+                }
+                writer.close();
+            }
+
+            PcapReader reader(path);
+            // Walk only, then walk and decode every update, as replay does before the queue.
+            for (bool decode : {false, true}) {
+                size_t updates_seen = 0;
+                int64_t volume_sum = 0;
+                auto start = std::chrono::high_resolution_clock::now();
+                CaptureStats stats = reader.forEachUdp(filter, [&](const UdpDatagram& datagram) {
+                    if (!decode) {
+                        updates_seen += kUpdatesPerDatagram;
+                        return;
+                    }
+                    decodeDatagram(datagram.payload, datagram.size, [&](const WireHeader&, const WireUpdate& update) {
+                        volume_sum += update.volume;
+                        ++updates_seen;
+                    });
+                });
+                auto end = std::chrono::high_resolution_clock::now();
+                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+                auto expected_sum = static_cast<int64_t>(kUpdatesPerDatagram * datagrams * (datagrams - 1) / 2);
+                bool ok = stats.matched == datagrams && stats.frames == datagrams + datagrams / 4 &&
+                          updates_seen == datagrams * kUpdatesPerDatagram && (!decode || volume_sum == expected_sum);
+                std::cout << "Capture " << name << (decode ? " walk+decode" : " walk") << ": " << stats.matched
+                          << " datagrams, " << duration / 1000.0 << " ms, "
+                          << static_cast<double>(reader.size()) / 1e9 / (static_cast<double>(duration) / 1e6)
+                          << " GB/s, " << static_cast<uint64_t>(static_cast<double>(updates_seen) * 1e6 / duration)
+                          << " updates/s" << (ok ? "" : " (COUNT MISMATCH)") << "\n";
+            }
+            std::remove(path.c_str());
+        }
+    }
+    static void run_subscription_filter(size_t lookups) {
+        // 300 subscribed out of a 20k-symbol feed, looked up in random order.
+        constexpr size_t kUniverse = 20'000;
+        constexpr size_t kSubscribed = 300;
+        std::vector<uint64_t> universe;
+        for (size_t i = 0; i < kUniverse; ++i) universe.push_back(packTicker("S" + std::to_string(i)));
+        std::vector<bool> wanted(kUniverse);
+        std::mt19937_64 rng(42);
+        for (size_t n = 0; n < kSubscribed;) {
+            size_t i = rng() % kUniverse;
+            if (!wanted[i]) {
+                wanted[i] = true;
+                ++n;
+            }
+        }
+        std::vector<uint32_t> stream(lookups);
+        size_t expected = 0;
+        for (auto& i : stream) {
+            i = static_cast<uint32_t>(rng() % kUniverse);
+            expected += wanted[i];
+        }
+
+        auto measure = [&](const char* name, auto&& accepts) {
+            size_t accepted = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (uint32_t i : stream) accepted += accepts(universe[i]);
+            auto end = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+            std::cout << name << ": " << lookups << " lookups, " << duration / 1000.0 << " ms, "
+                      << static_cast<double>(duration) * 1000.0 / static_cast<double>(lookups) << " ns/lookup"
+                      << (accepted == expected ? "" : " (MISMATCH)") << "\n";
+        };
+
+        std::unordered_set<uint64_t> set;
+        SubscriptionFilter bloom(kUniverse);
+        SubscriptionFilter plain(kUniverse, 0);
+        for (size_t i = 0; i < kUniverse; ++i) {
+            if (!wanted[i]) continue;
+            set.insert(universe[i]);
+            bloom.subscribe(universe[i]);
+            plain.subscribe(universe[i]);
+        }
+        bloom.setAcceptAll(false);
+        plain.setAcceptAll(false);
+        measure("Subscription unordered_set", [&](uint64_t key) { return set.count(key) != 0; });
+        measure("Subscription bitset", [&](uint64_t key) { return plain.accepts(key); });
+        measure("Subscription bloom + bitset", [&](uint64_t key) { return bloom.accepts(key); });
+
+        // Lock-free updates: one thread churns other subscriptions while lookups run; the stable
+        // subscription must never be missed and an unsubscribed ticker never accepted.
+        std::atomic<bool> done{false};
+        std::thread writer([&] {
+            for (size_t n = 0; !done.load(std::memory_order_relaxed); ++n) {
+                uint64_t key = universe[n % kUniverse];
+                if (wanted[n % kUniverse]) continue;
+                bloom.subscribe(key);
+                bloom.unsubscribe(key);
+                if (n % 64 == 0) std::this_thread::yield();
+            }
+        });
+        uint64_t stable = *set.begin();
+        uint64_t absent = packTicker("NOTLISTD");
+        size_t errors = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < lookups; ++i) errors += !bloom.accepts(stable) + bloom.accepts(absent);
+        auto end = std::chrono::high_resolution_clock::now();
+        done = true;
+        writer.join();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        std::cout << "Subscription under churn: " << 2 * lookups << " lookups, " << duration / 1000.0 << " ms"
+                  << (errors == 0 ? "" : " (MISMATCH)") << "\n";
+    }
+    static void run_perfect_hash(size_t lookups) {
+        // Lookups of std::string symbols, as held in MarketData, 1 in 8 outside the universe.
+        std::vector<std::string> symbols;
+        for (size_t i = 0; i < kStaticUniverse; ++i) symbols.push_back(unpackTicker(kStaticTable.ticker(static_cast<uint32_t>(i))));
+        std::unordered_map<std::string, uint32_t> map;
+        SymbolDirectory directory(kStaticUniverse);
+        for (size_t i = 0; i < kStaticUniverse; ++i) {
+            map.emplace(symbols[i], static_cast<uint32_t>(i));
+            directory.intern(symbols[i]);
+        }
+        std::vector<std::string> misses;
+        for (size_t i = 0; i < 256; ++i) misses.push_back("X" + std::to_string(i));
+        std::vector<const std::string*> stream(lookups);
+        uint64_t expected = 0;
+        std::mt19937_64 rng(42);
+        for (auto& symbol : stream) {
+            size_t i = rng() % kStaticUniverse;
+            bool miss = rng() % 8 == 0;
+            symbol = miss ? &misses[i % misses.size()] : &symbols[i];
+            expected += miss ? kInvalidSymbol : i;
+        }
+
+        auto measure = [&](const char* name, auto&& find) {
+            uint64_t sum = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (const std::string* symbol : stream) sum += find(*symbol);
+            auto end = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+            std::cout << name << ": " << lookups << " lookups, " << duration / 1000.0 << " ms, "
+                      << static_cast<double>(duration) * 1000.0 / static_cast<double>(lookups) << " ns/lookup"
+                      << (sum == expected ? "" : " (MISMATCH)") << "\n";
+        };
+        measure("Symbol lookup unordered_map<string>", [&](const std::string& symbol) {
+            auto it = map.find(symbol);
+            return it == map.end() ? kInvalidSymbol : it->second;
+        });
+        measure("Symbol lookup SymbolDirectory", [&](const std::string& symbol) { return directory.find(symbol); });
+        measure("Symbol lookup PerfectSymbolTable", [&](const std::string& symbol) { return kStaticTable.find(symbol); });
+
+        // Pre-packed keys, as the wire format carries them: the table cost alone.
+        std::vector<uint64_t> keys(lookups);
+        for (size_t i = 0; i < lookups; ++i) keys[i] = packTicker(*stream[i]);
+        auto measure_packed = [&](const char* name, auto&& find) {
+            uint64_t sum = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (uint64_t key : keys) sum += find(key);
+            auto end = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+            std::cout << name << ": " << lookups << " lookups, " << duration / 1000.0 << " ms, "
+                      << static_cast<double>(duration) * 1000.0 / static_cast<double>(lookups) << " ns/lookup"
+                      << (sum == expected ? "" : " (MISMATCH)") << "\n";
+        };
+        measure_packed("Packed lookup SymbolDirectory", [&](uint64_t key) { return directory.find(key); });
+        measure_packed("Packed lookup PerfectSymbolTable", [&](uint64_t key) { return kStaticTable.find(key); });
+
+        // The build's own universe (HFT_SYMBOL_UNIVERSE) must map every ticker to its position.
+        bool universe_ok = true;
+        for (size_t i = 0; i < kUniverseTickers.size(); ++i) universe_ok &= kSymbolUniverse.find(kUniverseTickers[i]) == i;
+        std::cout << "Compile-time universe: " << kSymbolUniverse.size() << " symbols, " << sizeof(kSymbolUniverse)
+                  << " bytes" << (universe_ok ? "" : " (MISMATCH)") << "\n";
+    }
+    static void run_price_parser(size_t prices) {
+        // Exhaustive: every 7-digit significand with 0-7 decimal places, e.g. 1234567 -> "1.234567".
+        constexpr int64_t kPow10[9] = {1, 10, 100, 1000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000};
+        size_t checked = 0;
+        size_t errors = 0;
+        size_t strtod_checked = 0;
+        auto exhaustive_start = std::chrono::high_resolution_clock::now();
+        for (int64_t value = 0; value < 10'000'000; ++value) {
+            for (int decimals = 0; decimals <= 7; ++decimals) {
+                char text[16];
+                int length = 0;
+                int64_t integer = value / kPow10[decimals];
+                int64_t fraction = value % kPow10[decimals];
+                char digits[8];
+                int n = 0;
+                do {
+                    digits[n++] = static_cast<char>('0' + integer % 10);
+                    integer /= 10;
+                } while (integer > 0);
+                while (n > 0) text[length++] = digits[--n];
+                if (decimals > 0) {
+                    text[length++] = '.';
+                    for (int d = decimals - 1; d >= 0; --d) text[length++] = static_cast<char>('0' + fraction / kPow10[d] % 10);
+                }
+                FixedPrice parsed = -1;
+                const char* end = parsePrice(text, text + length, parsed);
+                errors += end != text + length || parsed != value * kPow10[8 - decimals];
+                if (++checked % 101 == 0) {
+                    text[length] = '\0';
+                    errors += toDouble(parsed) != std::strtod(text, nullptr);
+                    ++strtod_checked;
+                }
+            }
+        }
+        // Edge cases: signs, missing parts, truncation and rejection.
+        struct Case {
+            const char* text;
+            FixedPrice value; ///< Expected value; -1 with consumed == 0 means rejected.
+            size_t consumed;
+        };
+        const Case cases[] = {{"-1.5", -150'000'000, 4},    {".75", 75'000'000, 3},
+                              {"5.", 500'000'000, 2},       {"12345678.12345678", 1'234'567'812'345'678, 17},
+                              {"0.123456789", 12'345'678, 11}, {"150.25,100", 15'025'000'000, 6},
+                              {"123456789", -1, 0},         {"", -1, 0},
+                              {"-", -1, 0},                 {".", -1, 0},
+                              {"abc", -1, 0}};
+        for (const Case& c : cases) {
+            FixedPrice parsed = -1;
+            const char* end = parsePrice(c.text, c.text + std::strlen(c.text), parsed);
+            errors += c.consumed == 0 ? end != nullptr : (end != c.text + c.consumed || parsed != c.value);
+            ++checked;
+        }
+        auto exhaustive_end = std::chrono::high_resolution_clock::now();
+        std::cout << "Price parser exhaustive: " << checked << " strings (" << strtod_checked << " also vs strtod), "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(exhaustive_end - exhaustive_start).count()
+                  << " ms" << (errors == 0 ? "" : " (" + std::to_string(errors) + " MISMATCHES)") << "\n";
+
+        // Throughput on feed-like prices: 0.01-5000, 1-4 decimal places, comma separated.
+        std::string buffer;
+        std::vector<size_t> offsets;
+        std::mt19937_64 rng(42);
+        for (size_t i = 0; i < prices; ++i) {
+            offsets.push_back(buffer.size());
+            int decimals = 1 + static_cast<int>(rng() % 4);
+            int64_t units = 1 + static_cast<int64_t>(rng() % (5000 * kPow10[decimals]));
+            char text[32];
+            int length = std::snprintf(text, sizeof(text), "%.*f", decimals, static_cast<double>(units) / kPow10[decimals]);
+            buffer.append(text, static_cast<size_t>(length));
+            buffer.push_back(',');
+        }
+        const char* const data = buffer.data();
+        const char* const data_end = data + buffer.size();
+        auto measure = [&](const char* name, auto&& parse) {
+            double sum = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t offset : offsets) sum += parse(data + offset);
+            auto end = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+            std::cout << name << ": " << prices << " prices, " << duration / 1000.0 << " ms, "
+                      << static_cast<double>(duration) * 1000.0 / static_cast<double>(prices) << " ns/price, "
+                      << static_cast<double>(buffer.size()) / static_cast<double>(duration) << " MB/s";
+            return sum;
+        };
+        double reference = measure("strtod", [](const char* p) { return std::strtod(p, nullptr); });
+        std::cout << "\n";
+        double from_chars_sum = measure("from_chars", [&](const char* p) {
+            double value = 0;
+            std::from_chars(p, data_end, value);
+            return value;
+        });
+        std::cout << (from_chars_sum == reference ? "" : " (MISMATCH)") << "\n";
+        double fixed_sum = measure("parsePrice (SWAR fixed-point)", [&](const char* p) {
+            FixedPrice value = 0;
+            parsePrice(p, data_end, value);
+            return toDouble(value);
+        });
+        std::cout << (fixed_sum == reference ? "" : " (MISMATCH)") << "\n";
+    }
+    static void run_tick_store(size_t ticks) {
+        // A 6.5 hour session over 500 symbols with Zipf-like activity, queried in 5-minute windows.
+        constexpr size_t kSymbols = 500;
+        constexpr uint64_t kSessionStart = 1'699'954'200ULL * 1'000'000'000ULL; // 09:30 UTC
+        constexpr uint64_t kSessionNs = 23'400ULL * 1'000'000'000ULL;
+        constexpr uint64_t kWindowNs = 300ULL * 1'000'000'000ULL;
+        const std::string path = "benchmark.ticks";
+        struct Tick {
+            uint32_t symbol;
+            int32_t volume;
+            uint64_t timestamp;
+            FixedPrice price;
+        };
+        std::vector<double> weights(kSymbols);
+        for (size_t i = 0; i < kSymbols; ++i) weights[i] = 1.0 / static_cast<double>(i + 1);
+        std::discrete_distribution<uint32_t> pick(weights.begin(), weights.end());
+        std::mt19937_64 rng(42);
+        std::vector<Tick> flat(ticks);
+        std::vector<std::vector<size_t>> by_symbol(kSymbols); // Reference: tick indices per symbol
+        for (size_t i = 0; i < ticks; ++i) {
+            uint32_t symbol = pick(rng);
+            flat[i] = Tick{symbol, static_cast<int32_t>(1 + rng() % 1000), kSessionStart + kSessionNs / ticks * i,
+                           static_cast<FixedPrice>(100 * kPriceScale + static_cast<int64_t>(rng() % 1'000'000))};
+            by_symbol[symbol].push_back(i);
+        }
+        auto ticker = [](uint32_t symbol) { return packTicker("T" + std::to_string(symbol)); };
+
+        struct Query {
+            uint32_t symbol;
+            uint64_t from, to;
+        };
+        std::vector<Query> queries(1000);
+        for (Query& q : queries) {
+            q.symbol = pick(rng);
+            q.from = kSessionStart + rng() % (kSessionNs - kWindowNs);
+            q.to = q.from + kWindowNs;
+        }
+        auto expected = [&](const Query& q) {
+            int64_t volume = 0;
+            for (size_t i : by_symbol[q.symbol]) {
+                if (flat[i].timestamp >= q.from && flat[i].timestamp <= q.to) volume += flat[i].volume;
+            }
+            return volume;
+        };
+
+        std::vector<int64_t> volumes(queries.size());
+        for (TickEncoding encoding : {TickEncoding::Raw, TickEncoding::Delta}) {
+            const char* name = encoding == TickEncoding::Raw ? "raw" : "delta";
+            auto start = std::chrono::high_resolution_clock::now();
+            {
+                TickStoreWriter writer(path, encoding);
+                for (const Tick& tick : flat) writer.append(ticker(tick.symbol), tick.timestamp, tick.price, tick.volume);
+                writer.close();
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            struct stat st {};
+            ::stat(path.c_str(), &st);
+            auto write_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+            std::cout << "Tick store write (" << name << "): " << ticks << " ticks, " << write_us / 1000.0 << " ms, "
+                      << static_cast<double>(st.st_size) / 1e6 << " MB\n";
+
+            TickStoreReader store(path);
+            size_t mismatches = 0;
+            uint64_t matched = 0;
+            std::fill(volumes.begin(), volumes.end(), 0);
+            start = std::chrono::high_resolution_clock::now();
+            for (size_t n = 0; n < queries.size(); ++n) {
+                const TickSymbolEntry* symbol = store.findSymbol(ticker(queries[n].symbol));
+                if (!symbol) continue;
+                matched += store.query(*symbol, queries[n].from, queries[n].to, [&](const TickColumns& run) {
+                    for (size_t i = 0; i < run.count; ++i) volumes[n] += run.volumes[i];
+                });
+            }
+            end = std::chrono::high_resolution_clock::now();
+            for (size_t n = 0; n < queries.size(); ++n) mismatches += volumes[n] != expected(queries[n]);
+            auto store_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+            std::cout << "Tick store range query (" << name << "): " << queries.size() << " queries, " << matched
+                      << " ticks, " << static_cast<double>(store_us) / static_cast<double>(queries.size())
+                      << " us/query" << (mismatches == 0 ? "" : " (MISMATCH)") << "\n";
+        }
+
+        // Baseline: the same questions answered by scanning every record.
+        constexpr size_t kScans = 10;
+        size_t mismatches = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t n = 0; n < kScans; ++n) {
+            const Query& q = queries[n];
+            int64_t volume = 0;
+            for (const Tick& tick : flat) {
+                if (tick.symbol == q.symbol && tick.timestamp >= q.from && tick.timestamp <= q.to) volume += tick.volume;
+            }
+            mismatches += volume != volumes[n];
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        auto scan_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        std::cout << "Full scan range query: " << kScans << " queries, "
+                  << static_cast<double>(scan_us) / static_cast<double>(kScans) << " us/query"
+                  << (mismatches == 0 ? "" : " (MISMATCH)") << "\n";
+        std::remove(path.c_str());
+    }
+    static void run_tick_codec(size_t ticks) {
+        // A day of ticks over 500 symbols: cent-tick price random walks, round-lot-heavy volumes,
+        // nanosecond timestamps. Encoded per symbol in 4096-tick blocks, as in a tick store.
+        constexpr size_t kSymbols = 500;
+        constexpr size_t kBlockTicks = 4096;
+        constexpr int64_t kCent = kPriceScale / 100;
+        std::mt19937_64 rng(11);
+        std::vector<double> weights(kSymbols);
+        for (size_t i = 0; i < kSymbols; ++i) weights[i] = 1.0 / static_cast<double>(i + 1);
+        std::discrete_distribution<uint32_t> pick(weights.begin(), weights.end());
+        std::exponential_distribution<double> gap(1.0 / 2340.0); // ~2.3 us between ticks overall
+        std::vector<TickBatch> symbols(kSymbols);
+        std::vector<FixedPrice> last_price(kSymbols);
+        for (size_t i = 0; i < kSymbols; ++i) last_price[i] = static_cast<FixedPrice>(20 + rng() % 500) * kPriceScale;
+        uint64_t now = 1'699'954'200ULL * 1'000'000'000ULL;
+        for (size_t i = 0; i < ticks; ++i) {
+            uint32_t s = pick(rng);
+            now += 1 + static_cast<uint64_t>(gap(rng));
+            last_price[s] += (static_cast<int64_t>(rng() % 5) - 2) * kCent;
+            symbols[s].timestamps.push_back(now);
+            symbols[s].prices.push_back(last_price[s]);
+            symbols[s].volumes.push_back(rng() % 4 == 0 ? static_cast<int32_t>(1 + rng() % 99)
+                                                        : static_cast<int32_t>(100 * (1 + rng() % 20)));
+        }
+
+        std::vector<uint8_t> encoded;
+        encoded.reserve(encodedTicksBound(ticks) + kSymbols * ((ticks / kBlockTicks + 1) * sizeof(EncodedTicksHeader)));
+        std::vector<std::pair<size_t, size_t>> blocks; // Offset and size of each encoded block
+        auto start = std::chrono::high_resolution_clock::now();
+        for (const TickBatch& symbol : symbols) {
+            for (size_t begin = 0; begin < symbol.size(); begin += kBlockTicks) {
+                size_t end = std::min(begin + kBlockTicks, symbol.size());
+                size_t offset = encoded.size();
+                blocks.emplace_back(offset, encodeTicks(symbol.columns().slice(begin, end), encoded));
+            }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        const double column_bytes = static_cast<double>(ticks * (sizeof(uint64_t) + sizeof(FixedPrice) + sizeof(int32_t)));
+        const double encoded_bytes = static_cast<double>(encoded.size());
+        const double encode_s = std::chrono::duration<double>(end - start).count();
+        std::cout << "Tick codec: " << ticks << " ticks, " << encoded_bytes / static_cast<double>(ticks)
+                  << " bytes/tick, " << column_bytes / encoded_bytes << "x vs. raw columns, "
+                  << static_cast<double>(ticks * sizeof(MarketData)) / encoded_bytes << "x vs. MarketData records, encode "
+                  << column_bytes / 1e9 / encode_s << " GB/s\n";
+
+        const IsaLevel startup_level = simd().level;
+        TickBatch batch;
+        for (IsaLevel level : {IsaLevel::Scalar, IsaLevel::SSE42}) {
+            if (level > detectedIsa()) break;
+            setSimdLevel(level);
+            size_t mismatches = 0;
+            uint64_t checksum = 0;
+            start = std::chrono::high_resolution_clock::now();
+            for (const auto& [offset, size] : blocks) {
+                mismatches += !decodeTicks(encoded.data() + offset, size, batch);
+                checksum += batch.timestamps.back() + static_cast<uint64_t>(batch.prices.back());
+            }
+            end = std::chrono::high_resolution_clock::now();
+            const double decode_s = std::chrono::duration<double>(end - start).count();
+
+            // Verify every block against the source columns (untimed).
+            size_t b = 0;
+            for (const TickBatch& symbol : symbols) {
+                for (size_t begin = 0; begin < symbol.size(); begin += kBlockTicks, ++b) {
+                    size_t count = std::min(kBlockTicks, symbol.size() - begin);
+                    if (!decodeTicks(encoded.data() + blocks[b].first, blocks[b].second, batch) || batch.size() != count ||
+                        !std::equal(batch.timestamps.begin(), batch.timestamps.end(), symbol.timestamps.begin() + begin) ||
+                        !std::equal(batch.prices.begin(), batch.prices.end(), symbol.prices.begin() + begin) ||
+                        !std::equal(batch.volumes.begin(), batch.volumes.end(), symbol.volumes.begin() + begin)) {
+                        ++mismatches;
+                    }
+                }
+            }
+            std::cout << "Tick decode " << isaName(level) << ": " << column_bytes / 1e9 / decode_s << " GB/s decoded, "
+                      << static_cast<double>(ticks) / 1e6 / decode_s << " M ticks/s (checksum " << checksum % 1000 << ")"
+                      << (mismatches == 0 ? "" : " (MISMATCH)") << "\n";
+        }
+        setSimdLevel(startup_level);
+    }
+    static void run_radix_sort(size_t records) {
+        // Four feed lines captured separately and concatenated, each in time order with its own
+        // jitter, plus 1% late recovery records: sort by (timestamp, sequence) before replay.
+        struct CaptureRecord {
+            uint64_t timestamp;
+            uint64_t sequence;
+            uint64_t ticker;
+            FixedPrice price;
+        };
+        constexpr size_t kLines = 4;
+        constexpr uint64_t kSessionStart = 1'699'954'200ULL * 1'000'000'000ULL;
+        constexpr uint64_t kSessionNs = 23'400ULL * 1'000'000'000ULL;
+        std::mt19937_64 rng(5);
+        std::vector<CaptureRecord> input(records);
+        for (size_t i = 0; i < records; ++i) {
+            size_t line = i * kLines / records;
+            size_t position = i - line * records / kLines; // Index within the line
+            uint64_t timestamp = kSessionStart + kSessionNs / (records / kLines) * position + rng() % 50'000;
+            if (rng() % 100 == 0) timestamp -= rng() % 1'000'000'000; // Late recovery record
+            input[i] = CaptureRecord{timestamp, i * kLines % records + line, rng(), static_cast<FixedPrice>(rng() % kPriceScale)};
+        }
+        auto timestampKey = [](const CaptureRecord& r) { return r.timestamp; };
+        auto sequenceKey = [](const CaptureRecord& r) { return r.sequence; };
+        auto less = [](const CaptureRecord& a, const CaptureRecord& b) {
+            return a.timestamp != b.timestamp ? a.timestamp < b.timestamp : a.sequence < b.sequence;
+        };
+
+        std::vector<CaptureRecord> expected;
+        std::vector<CaptureRecord> work(records);
+        std::vector<CaptureRecord> scratch(records);
+        auto run = [&](const std::string& name, auto&& sort) {
+            std::copy(input.begin(), input.end(), work.begin());
+            auto start = std::chrono::high_resolution_clock::now();
+            sort();
+            auto end = std::chrono::high_resolution_clock::now();
+            double ms = std::chrono::duration<double, std::milli>(end - start).count();
+            if (expected.empty()) expected = work;
+            bool ok = std::equal(work.begin(), work.end(), expected.begin(), [](const CaptureRecord& a, const CaptureRecord& b) {
+                return a.timestamp == b.timestamp && a.sequence == b.sequence && a.ticker == b.ticker;
+            });
+            std::cout << name << ": " << records << " records, " << ms << " ms, "
+                      << static_cast<double>(records) / 1e3 / ms << " M records/s" << (ok ? "" : " (MISMATCH)") << "\n";
+        };
+        run("std::sort", [&] { std::sort(work.begin(), work.end(), less); });
+#if defined(HFT_HAVE_PARALLEL_STL)
+        run("std::sort(par)", [&] { std::sort(std::execution::par, work.begin(), work.end(), less); });
+#endif
+        // At least 4 workers, so the parallel path is checked even on small hosts.
+        const size_t parallel = std::max<size_t>(4, std::thread::hardware_concurrency());
+        for (size_t threads : {size_t{1}, parallel}) {
+            run("radixSort (" + std::to_string(threads) + " threads)", [&] {
+                radixSort(std::span<CaptureRecord>(work), std::span<CaptureRecord>(scratch), threads, timestampKey,
+                          sequenceKey);
+            });
+        }
+    }
+    static void run_price_ladder(size_t operations) {
+        // Ask-side churn with a fixed number of levels: while the market rises, the best level is
+        // removed (traded through) and a level is added behind the worst; while it falls, a new
+        // best appears below and the worst is cancelled. Gaps between levels average gap ticks, so
+        // a thin book leaves a linear scan hundreds of empty levels to cross.
+        constexpr FixedPrice kLow = 100 * kPriceScale;
+        constexpr FixedPrice kTick = kPriceScale / 100;
+        constexpr size_t kLevels = 65'536;
+        struct Shape {
+            const char* name;
+            size_t populated;
+            uint32_t gap;
+        };
+        struct Churn {
+            uint32_t remove;
+            uint32_t add;
+        };
+        for (const Shape& shape : {Shape{"thin", 64, 256}, Shape{"dense", 2'048, 2}}) {
+            std::mt19937_64 rng(11);
+            auto gap = [&] { return static_cast<uint32_t>(1 + rng() % (2 * shape.gap - 1)); };
+            std::deque<uint32_t> book{static_cast<uint32_t>(kLevels / 4)};
+            while (book.size() < shape.populated) book.push_back(book.back() + gap());
+            const std::vector<uint32_t> initial(book.begin(), book.end());
+            std::vector<Churn> churn(operations);
+            bool rising = true;
+            for (Churn& op : churn) {
+                if (rising && book.back() + 2 * shape.gap >= kLevels) rising = false;
+                if (!rising && book.front() < 2 * shape.gap) rising = true;
+                if (rising) {
+                    op = {book.front(), book.back() + gap()};
+                    book.pop_front();
+                    book.push_back(op.add);
+                } else {
+                    op = {book.back(), book.front() - gap()};
+                    book.pop_back();
+                    book.push_front(op.add);
+                }
+            }
+
+            uint64_t expected = 0;
+            auto measure = [&](const char* name, auto&& churn) {
+                auto start = std::chrono::high_resolution_clock::now();
+                uint64_t sum = churn(); // Sum of best prices after each operation
+                auto end = std::chrono::high_resolution_clock::now();
+                if (expected == 0) expected = sum;
+                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+                std::cout << "Best-level churn " << name << " (" << shape.name << ", " << shape.populated
+                          << " levels, mean gap " << shape.gap << " ticks): " << operations << " ops, " << duration / 1000.0 << " ms, "
+                          << static_cast<double>(duration) * 1000.0 / static_cast<double>(operations) << " ns/op"
+                          << (sum == expected ? "" : " (MISMATCH)") << "\n";
+            };
+            auto priceOf = [&](size_t level) { return kLow + static_cast<FixedPrice>(level) * kTick; };
+            measure("std::map", [&] {
+                std::map<FixedPrice, int64_t> book;
+                for (uint32_t level : initial) book.emplace(priceOf(level), 100);
+                uint64_t sum = 0;
+                for (const Churn& op : churn) {
+                    book.erase(priceOf(op.remove));
+                    book.emplace(priceOf(op.add), 100);
+                    sum += static_cast<uint64_t>(book.begin()->first);
+                }
+                return sum;
+            });
+            measure("linear scan", [&] {
+                std::vector<int64_t> book(kLevels);
+                for (uint32_t level : initial) book[level] = 100;
+                size_t top = initial.front();
+                uint64_t sum = 0;
+                for (const Churn& op : churn) {
+                    book[op.remove] = 0;
+                    book[op.add] = 100;
+                    if (op.add < top) {
+                        top = op.add;
+                    } else {
+                        while (book[top] == 0) ++top; // Stops at the new level at the latest
+                    }
+                    sum += static_cast<uint64_t>(priceOf(top));
+                }
+                return sum;
+            });
+            measure("PriceLadder", [&] {
+                PriceLadder book(Side::Ask, kLow, kTick, kLevels);
+                for (uint32_t level : initial) book.set(priceOf(level), 100);
+                uint64_t sum = 0;
+                for (const Churn& op : churn) {
+                    book.set(priceOf(op.remove), 0);
+                    book.set(priceOf(op.add), 100);
+                    sum += static_cast<uint64_t>(*book.best());
+                }
+                return sum;
+            });
+        }
+
+        // Both sides against std::map: best, next worse level from arbitrary prices, and depth walks.
+        bool ok = true;
+        std::mt19937_64 rng(12);
+        for (Side side : {Side::Bid, Side::Ask}) {
+            PriceLadder ladder(side, kLow, kTick, 300'000);
+            std::map<FixedPrice, int64_t> reference;
+            for (size_t i = 0; i < 200'000; ++i) {
+                FixedPrice price = kLow + static_cast<FixedPrice>(rng() % 300'000) * kTick;
+                int64_t quantity = static_cast<int64_t>(rng() % 200) - 100;
+                if (ladder.add(price, quantity) > 0) {
+                    reference[price] = ladder.quantity(price);
+                } else {
+                    reference.erase(price);
+                }
+                std::optional<FixedPrice> best = ladder.best();
+                if (reference.empty()) {
+                    ok &= !best;
+                } else {
+                    ok &= best == (side == Side::Bid ? reference.rbegin()->first : reference.begin()->first);
+                }
+                FixedPrice from = kLow + static_cast<FixedPrice>(rng() % 300'010) * kTick - kTick * 5 + (i % 3 == 0 ? kTick / 2 : 0);
+                std::optional<FixedPrice> next = ladder.next(from);
+                if (side == Side::Bid) {
+                    auto it = reference.lower_bound(from);
+                    ok &= it == reference.begin() ? !next : next == std::prev(it)->first;
+                } else {
+                    auto it = reference.upper_bound(from);
+                    ok &= it == reference.end() ? !next : next == it->first;
+                }
+            }
+            std::vector<std::pair<FixedPrice, int64_t>> walked;
+            ladder.walk(SIZE_MAX, [&](FixedPrice price, int64_t quantity) { walked.emplace_back(price, quantity); });
+            std::vector<std::pair<FixedPrice, int64_t>> levels(reference.begin(), reference.end());
+            if (side == Side::Bid) std::reverse(levels.begin(), levels.end());
+            ok &= walked == levels;
+            ladder.clear();
+            ok &= ladder.empty() && !ladder.best();
+        }
+        std::cout << "PriceLadder check against std::map" << (ok ? "" : " (MISMATCH)") << "\n";
+    }
+    static void run_book_signals(size_t updates) {
+        // Market-by-price stream around a drifting mid: most updates resize or replace levels
+        // within a few ticks of the touch, and a move of the mid sweeps the levels it crosses.
+        constexpr FixedPrice kLow = 100 * kPriceScale;
+        constexpr FixedPrice kTick = kPriceScale / 100;
+        constexpr size_t kLevels = 4'096;
+        constexpr size_t kTopLevels = 5;
+        constexpr size_t kDepthTicks = 10;
+        struct Update {
+            Side side;
+            FixedPrice price;
+            int64_t quantity;
+        };
+        std::vector<Update> stream;
+        stream.reserve(updates);
+        {
+            std::mt19937_64 rng(13);
+            OrderBook book(kLow, kTick, kLevels);
+            size_t mid = kLevels / 2; // Bids below mid, asks at or above
+            auto emit = [&](Side side, size_t level, int64_t quantity) {
+                stream.push_back({side, kLow + static_cast<FixedPrice>(level) * kTick, quantity});
+                book.set(side, stream.back().price, quantity);
+            };
+            while (stream.size() < updates) {
+                uint64_t r = rng();
+                if (r % 16 == 0) {
+                    const bool up = mid < 256 || (mid < kLevels - 256 && (r >> 8) % 2 == 0);
+                    mid += up ? 1 : -1;
+                    const PriceLadder& crossed = book.side(up ? Side::Ask : Side::Bid);
+                    while (stream.size() < updates && crossed.bestLevel() != PriceLadder::npos &&
+                           (up ? crossed.bestLevel() < mid : crossed.bestLevel() >= mid)) {
+                        emit(crossed.side(), crossed.bestLevel(), 0);
+                    }
+                    continue;
+                }
+                const Side side = (r >> 8) % 2 == 0 ? Side::Bid : Side::Ask;
+                size_t distance = static_cast<size_t>(std::countr_zero(rng() | (uint64_t{1} << 20)));
+                if ((r >> 9) % 4 == 0) distance += (r >> 16) % 32;
+                const size_t level = side == Side::Bid ? mid - 1 - distance : mid + distance;
+                emit(side, level, (r >> 24) % 5 == 0 ? 0 : static_cast<int64_t>(1 + (r >> 32) % 1000));
+            }
+        }
+
+        auto fold = [](const BookSignalSnapshot& signals) { // Uses every signal, so none is optimised away
+            return signals.microprice + signals.weighted_mid + signals.imbalance +
+                   static_cast<double>(signals.spread_ticks + signals.bid_depth + signals.ask_depth);
+        };
+        auto measure = [&](const char* name, auto&& run) {
+            auto start = std::chrono::high_resolution_clock::now();
+            double sum = run();
+            auto end = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+            std::cout << name << ": " << updates << " updates, " << duration / 1000.0 << " ms, "
+                      << static_cast<double>(duration) * 1000.0 / static_cast<double>(updates) << " ns/update (checksum "
+                      << sum << ")\n";
+        };
+        measure("Book only", [&] {
+            OrderBook book(kLow, kTick, kLevels);
+            double sum = 0;
+            for (const Update& update : stream) sum += static_cast<double>(book.set(update.side, update.price, update.quantity).after);
+            return sum;
+        });
+        measure("Book + incremental signals", [&] {
+            OrderBook book(kLow, kTick, kLevels);
+            BookSignals signals(book, kTopLevels, kDepthTicks);
+            double sum = 0;
+            for (const Update& update : stream) {
+                signals.apply(book.set(update.side, update.price, update.quantity));
+                sum += fold(signals.snapshot());
+            }
+            return sum;
+        });
+        measure("Book + signals from scratch", [&] {
+            OrderBook book(kLow, kTick, kLevels);
+            double sum = 0;
+            for (const Update& update : stream) {
+                book.set(update.side, update.price, update.quantity);
+                sum += fold(BookSignals::compute(book, kTopLevels, kDepthTicks));
+            }
+            return sum;
+        });
+
+        // Every incremental snapshot must equal a recomputation, field for field.
+        OrderBook book(kLow, kTick, kLevels);
+        BookSignals signals(book, kTopLevels, kDepthTicks);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < std::min<size_t>(updates, 1'000'000); ++i) {
+            signals.apply(book.set(stream[i].side, stream[i].price, stream[i].quantity));
+            mismatches += !(signals.snapshot() == BookSignals::compute(book, kTopLevels, kDepthTicks));
+        }
+        BookSignalSnapshot last = signals.snapshot();
+        std::cout << "Book signals: bid " << toDouble(last.bid) << " x " << last.bid_quantity << ", ask " << toDouble(last.ask)
+                  << " x " << last.ask_quantity << ", microprice " << last.microprice << ", imbalance " << last.imbalance
+                  << (mismatches == 0 ? "" : " (MISMATCH)") << "\n";
+    }
+    static void run_basket_calculator(size_t ticks) {
+        // 500 symbols; an index over all of them plus 100 overlapping 50-name baskets, so a tick
+        // fans out to about 11 baskets. Prices random-walk in 1-cent steps.
+        constexpr size_t kSymbols = 500;
+        constexpr size_t kBaskets = 100;
+        constexpr size_t kBasketSize = 50;
+        std::mt19937_64 rng(17);
+        std::vector<uint64_t> tickers(kSymbols);
+        for (size_t i = 0; i < kSymbols; ++i) tickers[i] = packTicker("S" + std::to_string(i));
+        std::vector<std::vector<BasketCalculator::Constituent>> definitions(kBaskets + 1);
+        std::vector<std::vector<size_t>> members(kBaskets + 1); // Symbol index per constituent
+        for (size_t i = 0; i < kSymbols; ++i) {
+            definitions[0].push_back({tickers[i], 1.0 / static_cast<double>(kSymbols)});
+            members[0].push_back(i);
+        }
+        for (size_t b = 1; b <= kBaskets; ++b) {
+            for (size_t i = 0; i < kBasketSize; ++i) {
+                members[b].push_back(rng() % kSymbols);
+                definitions[b].push_back({tickers[members[b].back()], static_cast<double>(1 + rng() % 1000) / 7.0});
+            }
+        }
+        std::vector<double> prices(kSymbols);
+        for (double& price : prices) price = static_cast<double>(10 + rng() % 500);
+        std::vector<uint32_t> ticked(ticks);
+        std::vector<double> stream(ticks);
+        for (size_t t = 0; t < ticks; ++t) {
+            ticked[t] = static_cast<uint32_t>(rng() % kSymbols);
+            prices[ticked[t]] = std::max(0.01, prices[ticked[t]] + (rng() % 2 == 0 ? 0.01 : -0.01));
+            stream[t] = prices[ticked[t]];
+        }
+
+        // Worst relative error against the final prices summed in long double.
+        auto maxError = [&](const BasketCalculator& calculator) {
+            double worst = 0;
+            for (uint32_t b = 0; b < definitions.size(); ++b) {
+                long double exact = 0;
+                for (size_t k = 0; k < definitions[b].size(); ++k) {
+                    exact += static_cast<long double>(definitions[b][k].weight) * prices[members[b][k]];
+                }
+                worst = std::max(worst, static_cast<double>(std::fabs((calculator.value(b) - exact) / exact)));
+            }
+            return worst;
+        };
+        auto measure = [&](const std::string& name, size_t recompute_interval, bool full_resum) {
+            BasketCalculator calculator(kSymbols, recompute_interval);
+            for (size_t b = 0; b < definitions.size(); ++b) calculator.addBasket("B" + std::to_string(b), definitions[b]);
+            std::vector<std::vector<uint32_t>> holders(kSymbols); // Baseline: baskets holding each symbol
+            for (uint32_t b = 0; b < definitions.size(); ++b) {
+                for (size_t i : members[b]) {
+                    if (holders[i].empty() || holders[i].back() != b) holders[i].push_back(b);
+                }
+            }
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t t = 0; t < ticks; ++t) {
+                calculator.update(tickers[ticked[t]], stream[t]);
+                if (full_resum) {
+                    for (uint32_t b : holders[ticked[t]]) calculator.recompute(b);
+                }
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+            double error = maxError(calculator);
+            std::cout << name << ": " << ticks << " ticks, " << duration / 1000.0 << " ms, "
+                      << static_cast<double>(duration) * 1000.0 / static_cast<double>(ticks) << " ns/tick, max relative error "
+                      << error << (recompute_interval != 0 && error > 1e-12 ? " (MISMATCH)" : "") << "\n";
+        };
+        measure("Baskets incremental, no re-sum", 0, false);
+        measure("Baskets incremental, periodic re-sum", BasketCalculator::kDefaultRecomputeInterval, false);
+        measure("Baskets full re-sum per tick", 0, true);
+    }
+    static void run_nbbo(size_t quotes) {
+        // Eight venues quoting 500 symbols around per-symbol cent-tick random walks: a venue is at
+        // the touch (1 cent off the mid) a quarter of the time, otherwise 2-4 cents away, with
+        // round-lot sizes, and occasionally pulls a side.
+        constexpr size_t kVenues = 8;
+        constexpr size_t kSymbols = 500;
+        constexpr size_t kChunk = 1024; // Quotes pushed before each drain; fits every ring
+        constexpr FixedPrice kCent = kPriceScale / 100;
+        std::mt19937_64 rng(23);
+        std::vector<uint64_t> tickers(kSymbols);
+        std::vector<FixedPrice> mids(kSymbols);
+        for (size_t i = 0; i < kSymbols; ++i) {
+            tickers[i] = packTicker("S" + std::to_string(i));
+            mids[i] = static_cast<FixedPrice>(20 + rng() % 500) * kPriceScale;
+        }
+        std::vector<uint8_t> venue_of(quotes);
+        std::vector<VenueQuote> stream(quotes);
+        for (size_t q = 0; q < quotes; ++q) {
+            const size_t symbol = rng() % kSymbols;
+            if (rng() % 8 == 0) mids[symbol] += rng() % 2 == 0 ? kCent : -kCent;
+            venue_of[q] = static_cast<uint8_t>(rng() % kVenues);
+            VenueQuote& quote = stream[q];
+            quote.ticker = tickers[symbol];
+            quote.bid = mids[symbol] - static_cast<FixedPrice>(rng() % 4 == 0 ? 1 : 2 + rng() % 3) * kCent;
+            quote.ask = mids[symbol] + static_cast<FixedPrice>(rng() % 4 == 0 ? 1 : 2 + rng() % 3) * kCent;
+            quote.bid_size = rng() % 50 == 0 ? 0 : static_cast<int64_t>(100 * (1 + rng() % 10));
+            quote.ask_size = rng() % 50 == 0 ? 0 : static_cast<int64_t>(100 * (1 + rng() % 10));
+            quote.timestamp = q;
+        }
+
+        // Reference: the final NBBO from each venue's last quote per symbol, found by plain loops.
+        std::vector<std::array<VenueQuote, kVenues>> last(kSymbols);
+        std::unordered_map<uint64_t, size_t> index_of;
+        for (size_t i = 0; i < kSymbols; ++i) index_of[tickers[i]] = i;
+        for (size_t q = 0; q < quotes; ++q) last[index_of[stream[q].ticker]][venue_of[q]] = stream[q];
+        auto matchesReference = [&](const NbboConsolidator& consolidator) {
+            for (size_t i = 0; i < kSymbols; ++i) {
+                Nbbo expected;
+                for (size_t v = 0; v < kVenues; ++v) {
+                    const VenueQuote& quote = last[i][v];
+                    if (quote.bid_size > 0 && (expected.bid_venues == 0 || quote.bid >= expected.bid)) {
+                        if (expected.bid_venues == 0 || quote.bid > expected.bid) expected.bid_size = expected.bid_venues = 0;
+                        expected.bid = quote.bid;
+                        expected.bid_size += quote.bid_size;
+                        expected.bid_venues |= 1u << v;
+                    }
+                    if (quote.ask_size > 0 && (expected.ask_venues == 0 || quote.ask <= expected.ask)) {
+                        if (expected.ask_venues == 0 || quote.ask < expected.ask) expected.ask_size = expected.ask_venues = 0;
+                        expected.ask = quote.ask;
+                        expected.ask_size += quote.ask_size;
+                        expected.ask_venues |= 1u << v;
+                    }
+                }
+                const Nbbo* actual = consolidator.find(tickers[i]);
+                if (actual == nullptr || !actual->sameQuote(expected)) return false;
+            }
+            return true;
+        };
+
+        // One thread pushes a chunk into the venue rings, then drains them: a fixed interleaving,
+        // so every ISA level must publish the same sequence.
+        std::vector<VenueQuoteRing> rings(kVenues);
+        uint64_t expected_digest = 0;
+        const IsaLevel startup_level = simd().level;
+        for (IsaLevel level : {IsaLevel::Scalar, IsaLevel::SSE42, IsaLevel::AVX2, IsaLevel::AVX512}) {
+            if (level > detectedIsa()) break;
+            setSimdLevel(level);
+            NbboConsolidator consolidator(kSymbols);
+            for (VenueQuoteRing& ring : rings) consolidator.addVenue(ring);
+            uint64_t digest = 0;
+            auto publish = [&](const Nbbo& nbbo) {
+                digest = digest * 31 + static_cast<uint64_t>(nbbo.bid ^ nbbo.ask ^ nbbo.bid_size ^ (nbbo.ask_size << 20)) +
+                         (uint64_t{nbbo.bid_venues} << 32 | nbbo.ask_venues);
+            };
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t q = 0; q < quotes; q += kChunk) {
+                for (size_t i = q; i < std::min(quotes, q + kChunk); ++i) rings[venue_of[i]].push(stream[i]);
+                while (consolidator.poll(publish) != 0) {
+                }
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            double seconds = std::chrono::duration<double>(end - start).count();
+            if (level == IsaLevel::Scalar) expected_digest = digest;
+            std::cout << "NBBO " << isaName(level) << " (" << kVenues << " venues, 1 thread): " << quotes << " quotes, "
+                      << seconds * 1000.0 << " ms, " << seconds * 1e9 / static_cast<double>(quotes) << " ns/quote, "
+                      << consolidator.published() << " published ("
+                      << 100.0 * static_cast<double>(consolidator.published()) / static_cast<double>(quotes) << "%), "
+                      << consolidator.rescans() << " rescans"
+                      << (digest == expected_digest && matchesReference(consolidator) ? "" : " (MISMATCH)") << "\n";
+        }
+        setSimdLevel(startup_level);
+
+        // A feed thread per venue pushing concurrently while this thread consolidates.
+        NbboConsolidator consolidator(kSymbols);
+        for (VenueQuoteRing& ring : rings) consolidator.addVenue(ring);
+        std::vector<std::thread> feeds;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t v = 0; v < kVenues; ++v) {
+            feeds.emplace_back([&, v] {
+                for (size_t q = 0; q < quotes; ++q) {
+                    if (venue_of[q] != v) continue;
+                    while (!rings[v].push(stream[q])) std::this_thread::yield();
+                }
+            });
+        }
+        uint64_t published = 0;
+        for (size_t applied = 0; applied < quotes;) {
+            size_t polled = consolidator.poll([&](const Nbbo&) { ++published; });
+            if (polled == 0) std::this_thread::yield();
+            applied += polled;
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        for (std::thread& feed : feeds) feed.join();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        std::cout << "NBBO " << isaName(simd().level) << " (" << kVenues << " feed threads): " << quotes << " quotes, "
+                  << seconds * 1000.0 << " ms, " << static_cast<double>(quotes) / 1e6 / seconds << " M quotes/s, "
+                  << published << " published" << (matchesReference(consolidator) ? "" : " (MISMATCH)") << "\n";
+    }
+    static void run_position_tracker(size_t events) {
+        // Ticks over 500 symbols (cent random walks), of which 50 are traded: every 100th event is
+        // a fill of 100-500 shares either way at the symbol's current price.
+        constexpr size_t kSymbols = 500;
+        constexpr size_t kTraded = 50;
+        constexpr size_t kFillEvery = 100;
+        struct Event {
+            uint32_t symbol;
+            int32_t quantity; // 0 for a tick
+            double price;
+        };
+        std::mt19937_64 rng(29);
+        std::vector<double> prices(kSymbols);
+        for (double& price : prices) price = static_cast<double>(20 + rng() % 500);
+        std::vector<Event> stream(events);
+        for (size_t e = 0; e < events; ++e) {
+            if (e % kFillEvery == kFillEvery - 1) {
+                const auto symbol = static_cast<uint32_t>(rng() % kTraded);
+                const auto shares = static_cast<int32_t>(100 * (1 + rng() % 5));
+                stream[e] = {symbol, rng() % 2 == 0 ? shares : -shares, prices[symbol]};
+            } else {
+                const auto symbol = static_cast<uint32_t>(rng() % kSymbols);
+                prices[symbol] = std::max(0.01, prices[symbol] + (rng() % 2 == 0 ? 0.01 : -0.01));
+                stream[e] = {symbol, 0, prices[symbol]};
+            }
+        }
+
+        // Independent check: PnL = cash from fills + market value of the final positions.
+        auto matches = [&](const PositionTracker& tracker) {
+            long double cash = 0, value = 0;
+            for (const Event& event : stream) cash -= static_cast<long double>(event.quantity) * event.price;
+            for (uint32_t symbol = 0; symbol < kSymbols; ++symbol) {
+                const Position position = tracker.position(symbol);
+                value += static_cast<long double>(position.quantity) * position.mark;
+            }
+            const AccountPnl account = tracker.account();
+            return std::fabs(static_cast<double>(cash + value) - account.total()) <= 1e-9 * std::max(1.0, account.gross_exposure);
+        };
+        auto report = [&](const std::string& name, double seconds, const PositionTracker& tracker, const std::string& note) {
+            const AccountPnl account = tracker.account();
+            std::cout << name << ": " << events << " events, " << seconds * 1000.0 << " ms, "
+                      << seconds * 1e9 / static_cast<double>(events) << " ns/event, PnL " << account.total() << " ("
+                      << account.open_positions << " open)" << note << (matches(tracker) ? "" : " (MISMATCH)") << "\n";
+        };
+
+        {
+            PositionTracker tracker(kSymbols);
+            auto start = std::chrono::high_resolution_clock::now();
+            for (const Event& event : stream) {
+                if (event.quantity != 0) {
+                    tracker.onFill(event.symbol, event.quantity, event.price);
+                } else {
+                    tracker.onTick(event.symbol, event.price);
+                }
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            report("Positions, active list", std::chrono::duration<double>(end - start).count(), tracker, "");
+        }
+        {
+            // Baseline: every tick re-marks the whole book to recompute the account PnL.
+            PositionTracker tracker(kSymbols);
+            double unrealized = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (const Event& event : stream) {
+                if (event.quantity != 0) {
+                    tracker.onFill(event.symbol, event.quantity, event.price);
+                } else {
+                    tracker.onTick(event.symbol, event.price);
+                }
+                unrealized = 0;
+                for (uint32_t symbol = 0; symbol < kSymbols; ++symbol) {
+                    const Position position = tracker.position(symbol);
+                    unrealized += static_cast<double>(position.quantity) * (position.mark - position.average_cost);
+                }
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            const double error = std::fabs(unrealized - tracker.account().unrealized);
+            report("Positions, full re-mark per event", std::chrono::duration<double>(end - start).count(), tracker,
+                   error <= 1e-6 * std::max(1.0, tracker.account().gross_exposure) ? "" : " (UNREALISED MISMATCH)");
+        }
+        {
+            // A risk thread polls the account while the tracker runs; versions must never go back.
+            PositionTracker tracker(kSymbols);
+            std::atomic<bool> done{false};
+            uint64_t reads = 0;
+            bool ordered = true;
+            std::thread risk([&] {
+                uint64_t last = 0;
+                while (!done.load(std::memory_order_acquire)) {
+                    const AccountPnl account = tracker.account();
+                    ordered &= account.updates >= last && account.open_positions <= kTraded;
+                    last = account.updates;
+                    ++reads;
+                }
+            });
+            auto start = std::chrono::high_resolution_clock::now();
+            for (const Event& event : stream) {
+                if (event.quantity != 0) {
+                    tracker.onFill(event.symbol, event.quantity, event.price);
+                } else {
+                    tracker.onTick(event.symbol, event.price);
+                }
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            done.store(true, std::memory_order_release);
+            risk.join();
+            report("Positions, with a risk reader", std::chrono::duration<double>(end - start).count(), tracker,
+                   ", " + std::to_string(reads) + " account reads" + (ordered ? "" : " (TORN READ)"));
+        }
+    }
+    static void run_order_manager(size_t responses) {
+        // About 1000 working orders; each step submits and acks, fills part or all of an order,
+        // or cancels one (acked or rejected). Every 100th response is a fill for an order that
+        // already finished, which must be recognised as unknown.
+        constexpr size_t kWorking = 1000;
+
+        // Baseline: orders in a hash map keyed by client order ID, a node allocation per order,
+        // and the transitions written as branches.
+        struct HashedOrders {
+            std::unordered_map<ClientOrderId, Order> orders;
+            ClientOrderId next_id = 1;
+
+            ClientOrderId submit(uint32_t symbol, Side side, FixedPrice price, int64_t quantity) {
+                Order order;
+                order.id = next_id++;
+                order.symbol = symbol;
+                order.side = side;
+                order.price = price;
+                order.quantity = quantity;
+                orders.emplace(order.id, order);
+                return order.id;
+            }
+            bool requestCancel(ClientOrderId id) {
+                auto it = orders.find(id);
+                if (it == orders.end() || it->second.cancel_pending) return false;
+                it->second.cancel_pending = true;
+                return true;
+            }
+            OrderUpdate onExecution(const ExecutionReport& report) {
+                auto it = orders.find(report.id);
+                if (it == orders.end()) return {ExecResult::UnknownOrder, OrderState::PendingNew, Order{}};
+                Order& order = it->second;
+                const OrderState previous = order.state;
+                bool valid = !order.terminal();
+                if (report.type == ExecType::Ack && previous == OrderState::PartiallyFilled) {
+                    valid = true; // Late ack after a fill: no-op
+                } else if (report.type == ExecType::Ack || report.type == ExecType::Reject) {
+                    valid = previous == OrderState::PendingNew;
+                    if (valid) order.state = report.type == ExecType::Ack ? OrderState::New : OrderState::Rejected;
+                } else if (report.type == ExecType::Fill) {
+                    valid = report.quantity > 0 && report.quantity <= order.leaves();
+                    if (valid) {
+                        order.filled += report.quantity;
+                        order.state = order.leaves() == 0 ? OrderState::Filled : OrderState::PartiallyFilled;
+                    }
+                } else {
+                    valid = order.cancel_pending;
+                    if (valid) {
+                        order.cancel_pending = false;
+                        if (report.type == ExecType::CancelAck) order.state = OrderState::Cancelled;
+                    }
+                }
+                if (!valid) return {ExecResult::InvalidTransition, previous, order};
+                OrderUpdate update{ExecResult::Applied, previous, order};
+                if (order.terminal()) orders.erase(it);
+                return update;
+            }
+        };
+
+        struct Tally {
+            uint64_t applied = 0, unknown = 0, invalid = 0, filled = 0, stale = 0, finished[kOrderStates] = {};
+            bool operator==(const Tally&) const = default;
+        };
+        auto drive = [&](auto& manager, Tally& tally) {
+            std::mt19937_64 rng(31);
+            std::vector<ClientOrderId> working;
+            std::vector<int64_t> leaves;
+            ClientOrderId retired = kInvalidOrderId;
+            auto respond = [&](const ExecutionReport& report) {
+                const OrderUpdate update = manager.onExecution(report);
+                tally.applied += update.result == ExecResult::Applied;
+                tally.unknown += update.result == ExecResult::UnknownOrder;
+                tally.invalid += update.result == ExecResult::InvalidTransition;
+                if (update.result == ExecResult::Applied && report.type == ExecType::Fill) tally.filled += report.quantity;
+                if (update.result == ExecResult::Applied && update.order.terminal()) {
+                    ++tally.finished[static_cast<size_t>(update.order.state)];
+                    return true;
+                }
+                return false;
+            };
+            for (size_t sent = 0; sent < responses;) {
+                if (sent % 100 == 99 && retired != kInvalidOrderId) {
+                    respond({retired, ExecType::Fill, 100, kPriceScale});
+                    ++tally.stale;
+                    ++sent;
+                    continue;
+                }
+                if (working.size() < kWorking) {
+                    const auto quantity = static_cast<int64_t>(100 * (1 + rng() % 10));
+                    const ClientOrderId id = manager.submit(static_cast<uint32_t>(rng() % 500), rng() % 2 ? Side::Bid : Side::Ask,
+                                                            static_cast<FixedPrice>(100 + rng() % 100) * kPriceScale, quantity);
+                    respond({id, ExecType::Ack, 0, 0});
+                    working.push_back(id);
+                    leaves.push_back(quantity);
+                    ++sent;
+                    continue;
+                }
+                const size_t i = rng() % working.size();
+                const ClientOrderId id = working[i];
+                bool finished = false;
+                switch (rng() % 5) {
+                case 0:
+                case 1: { // Fill part, or all of what is left
+                    const int64_t quantity = rng() % 3 == 0 ? leaves[i] : std::max<int64_t>(1, leaves[i] / 2);
+                    leaves[i] -= quantity;
+                    finished = respond({id, ExecType::Fill, quantity, 150 * kPriceScale});
+                    break;
+                }
+                case 2:
+                case 3:
+                    manager.requestCancel(id);
+                    finished = respond({id, ExecType::CancelAck, 0, 0});
+                    break;
+                default:
+                    manager.requestCancel(id);
+                    respond({id, ExecType::CancelReject, 0, 0});
+                    break;
+                }
+                ++sent;
+                if (finished) {
+                    retired = id;
+                    working[i] = working.back();
+                    leaves[i] = leaves.back();
+                    working.pop_back();
+                    leaves.pop_back();
+                }
+            }
+        };
+        auto report = [&](const std::string& name, double seconds, const Tally& tally, bool ok) {
+            std::cout << name << ": " << responses << " responses, " << seconds * 1000.0 << " ms, "
+                      << seconds * 1e9 / static_cast<double>(responses) << " ns/response, "
+                      << tally.finished[static_cast<size_t>(OrderState::Filled)] << " filled, "
+                      << tally.finished[static_cast<size_t>(OrderState::Cancelled)] << " cancelled, " << tally.unknown
+                      << " stale" << (ok ? "" : " (MISMATCH)") << "\n";
+        };
+
+        Tally pooled_tally, hashed_tally;
+        OrderManager pooled(2 * kWorking);
+        auto start = std::chrono::high_resolution_clock::now();
+        drive(pooled, pooled_tally);
+        auto end = std::chrono::high_resolution_clock::now();
+        const double pooled_seconds = std::chrono::duration<double>(end - start).count();
+        HashedOrders hashed;
+        start = std::chrono::high_resolution_clock::now();
+        drive(hashed, hashed_tally);
+        end = std::chrono::high_resolution_clock::now();
+        const double hashed_seconds = std::chrono::duration<double>(end - start).count();
+        const bool ok = pooled_tally == hashed_tally && pooled_tally.invalid == 0 && pooled_tally.unknown == pooled_tally.stale;
+        report("Orders, pooled handles + table", pooled_seconds, pooled_tally, ok);
+        report("Orders, hash map + branches", hashed_seconds, hashed_tally, ok);
+    }
+    static void run_timer_wheel(size_t timers) {
+        // timers one-shot timers over 2^26 virtual units (all four levels), a quarter of them
+        // cancelled and replaced, then time stepped forward 16 units per advance(). Every timer
+        // must fire in the first step at or after its deadline, and no cancelled timer may fire.
+        constexpr uint64_t kHorizon = uint64_t{1} << 26;
+        constexpr uint64_t kStride = 16;
+        struct Fired {
+            uint64_t now = 0;
+            std::vector<uint64_t> at;
+        };
+        auto record = [](void* context, uint64_t key) {
+            Fired& fired = *static_cast<Fired*>(context);
+            fired.at[key] = fired.now;
+        };
+        std::mt19937_64 rng(41);
+        const size_t keys = timers + timers / 4;
+        std::vector<uint64_t> deadlines(keys);
+        for (uint64_t& deadline : deadlines) deadline = 1 + rng() % kHorizon;
+        std::vector<uint8_t> cancelled(keys, 0);
+        std::vector<size_t> victims;
+        for (size_t k = 0; k < timers; k += 4) victims.push_back(k);
+        std::shuffle(victims.begin(), victims.end(), rng);
+        for (size_t k : victims) cancelled[k] = 1;
+
+        // Baseline: a binary heap of (deadline, key) with lazy cancellation; a cancelled entry
+        // stays in the heap until it surfaces.
+        using Entry = std::pair<uint64_t, uint64_t>;
+        struct HeapTimers {
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<>> heap;
+            std::vector<uint8_t> dead;
+            Fired* fired;
+        };
+
+        struct Timing {
+            double schedule = 0, cancel = 0, advance = 0;
+        };
+        auto report = [&](const std::string& name, const Timing& timing, bool ok) {
+            std::cout << name << ": " << keys << " schedules " << timing.schedule * 1e9 / static_cast<double>(keys)
+                      << " ns, " << victims.size() << " cancels " << timing.cancel * 1e9 / static_cast<double>(victims.size())
+                      << " ns, " << kHorizon / kStride << " advances " << timing.advance * 1000.0 << " ms ("
+                      << timing.advance * 1e9 / static_cast<double>(kHorizon / kStride) << " ns/advance)"
+                      << (ok ? "" : " (MISMATCH)") << "\n";
+        };
+
+        Fired wheel_fired, heap_fired;
+        wheel_fired.at.assign(keys, UINT64_MAX);
+        heap_fired.at.assign(keys, UINT64_MAX);
+        Timing wheel_timing, heap_timing;
+        bool wheel_consistent = false;
+        {
+            TimerWheel wheel(timers, 1, 0);
+            std::vector<TimerId> ids(keys, kInvalidTimer);
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t k = 0; k < timers; ++k) ids[k] = wheel.schedule(deadlines[k], record, &wheel_fired, k);
+            auto end = std::chrono::high_resolution_clock::now();
+            wheel_timing.schedule = std::chrono::duration<double>(end - start).count();
+            start = std::chrono::high_resolution_clock::now();
+            size_t refused = 0;
+            for (size_t k : victims) refused += !wheel.cancel(ids[k]);
+            end = std::chrono::high_resolution_clock::now();
+            wheel_timing.cancel = std::chrono::duration<double>(end - start).count();
+            for (size_t k : victims) refused += wheel.cancel(ids[k]); // Second cancel must be refused
+            start = std::chrono::high_resolution_clock::now();
+            for (size_t k = timers; k < keys; ++k) ids[k] = wheel.schedule(deadlines[k], record, &wheel_fired, k);
+            end = std::chrono::high_resolution_clock::now();
+            wheel_timing.schedule += std::chrono::duration<double>(end - start).count();
+            const size_t active = wheel.size();
+            start = std::chrono::high_resolution_clock::now();
+            for (uint64_t now = kStride; now <= kHorizon; now += kStride) {
+                wheel_fired.now = now;
+                wheel.advance(now);
+            }
+            end = std::chrono::high_resolution_clock::now();
+            wheel_timing.advance = std::chrono::duration<double>(end - start).count();
+            wheel_consistent = refused == 0 && active == timers && wheel.size() == 0;
+        }
+        {
+            HeapTimers heap{{}, std::vector<uint8_t>(keys, 0), &heap_fired};
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t k = 0; k < timers; ++k) heap.heap.emplace(deadlines[k], k);
+            auto end = std::chrono::high_resolution_clock::now();
+            heap_timing.schedule = std::chrono::duration<double>(end - start).count();
+            start = std::chrono::high_resolution_clock::now();
+            for (size_t k : victims) heap.dead[k] = 1;
+            end = std::chrono::high_resolution_clock::now();
+            heap_timing.cancel = std::chrono::duration<double>(end - start).count();
+            start = std::chrono::high_resolution_clock::now();
+            for (size_t k = timers; k < keys; ++k) heap.heap.emplace(deadlines[k], k);
+            end = std::chrono::high_resolution_clock::now();
+            heap_timing.schedule += std::chrono::duration<double>(end - start).count();
+            start = std::chrono::high_resolution_clock::now();
+            for (uint64_t now = kStride; now <= kHorizon; now += kStride) {
+                heap_fired.now = now;
+                while (!heap.heap.empty() && heap.heap.top().first <= now) {
+                    const uint64_t key = heap.heap.top().second;
+                    heap.heap.pop();
+                    if (!heap.dead[key]) record(heap.fired, key);
+                }
+            }
+            end = std::chrono::high_resolution_clock::now();
+            heap_timing.advance = std::chrono::duration<double>(end - start).count();
+        }
+        bool ok = wheel_consistent && wheel_fired.at == heap_fired.at;
+        for (size_t k = 0; k < keys && ok; ++k) {
+            const uint64_t due = (deadlines[k] + kStride - 1) / kStride * kStride;
+            ok = wheel_fired.at[k] == (cancelled[k] ? UINT64_MAX : due);
+        }
+        report("Timers, timing wheel", wheel_timing, ok);
+        report("Timers, heap + lazy cancel", heap_timing, ok);
+
+        // The poll-loop cost: tick() on the TSC clock at 1 us units with every timer pending
+        // seconds ahead, so calls cross unit boundaries and cascade but fire nothing.
+        TimerWheel live(timers, TscClock::fromNanos(1000), TscClock::now());
+        const uint64_t second = TscClock::fromNanos(1'000'000'000);
+        for (size_t k = 0; k < timers; ++k) live.schedule(TscClock::now() + second + rng() % second, record, &wheel_fired, 0);
+        constexpr size_t kTicks = 10'000'000;
+        size_t fired = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < kTicks; ++i) fired += live.tick();
+        auto end = std::chrono::high_resolution_clock::now();
+        const double seconds = std::chrono::duration<double>(end - start).count();
+        std::cout << "Timers, tick() with " << live.size() << " pending: " << seconds * 1e9 / static_cast<double>(kTicks)
+                  << " ns/call" << (fired == 0 ? "" : " (MISMATCH)") << "\n";
+    }
+    static void run_simulated_exchange(size_t trades) {
+        // A trade tape over 100 symbols (cent random walks), one print per virtual microsecond, run
+        // through a SimulatedExchange by a toy strategy: every 500th print it sends a 100-lot order
+        // on that symbol, alternately 5 cents through the print (taker) and 3 cents behind it
+        // (resting), and it cancels its oldest resting order once 20 are working. Everything runs
+        // on a 1 ns TimerWheel in virtual time, as in MarketDataParser::simulate().
+        constexpr size_t kSymbols = 100;
+        constexpr uint64_t kSpacingNs = 1000;
+        constexpr size_t kOrderEvery = 500;
+        constexpr size_t kMaxResting = 20;
+        constexpr FixedPrice kTick = kPriceScale / 100;
+        constexpr uint64_t kOneWayNs = 50'000;
+        struct Trade {
+            uint32_t symbol;
+            FixedPrice price;
+            int64_t volume;
+        };
+        std::mt19937_64 rng(43);
+        std::vector<FixedPrice> prices(kSymbols, 100 * kPriceScale);
+        std::vector<Trade> tape(trades);
+        for (Trade& trade : tape) {
+            const auto symbol = static_cast<uint32_t>(rng() % kSymbols);
+            prices[symbol] = std::max(kTick, prices[symbol] + (static_cast<FixedPrice>(rng() % 5) - 2) * kTick);
+            trade = {symbol, prices[symbol], static_cast<int64_t>(100 + rng() % 900)};
+        }
+        const std::string histogram_path = "benchmark.latency";
+        {
+            std::ofstream out(histogram_path);
+            out << "# latency_ns,count: mode at 30-40 us, long tail to 200 us\n";
+            for (uint64_t us = 20; us <= 200; us += 10) out << us * 1000 << "," << (us <= 40 ? 100 * us : 160'000 / us) << "\n";
+        }
+
+        // The strategy side: orders, positions and what it saw when sending each order (by slot).
+        struct Session {
+            TimerWheel* wheel = nullptr;
+            OrderManager orders{4096};
+            PositionTracker positions{kSymbols};
+            std::vector<uint64_t> sent_at = std::vector<uint64_t>(4096);
+            std::vector<FixedPrice> seen = std::vector<FixedPrice>(4096); ///< Print price for takers, 0 for resting orders.
+            uint64_t acks = 0, round_trip_sum = 0, min_round_trip = UINT64_MAX, taker_fills = 0;
+            uint64_t late_cancel_rejects = 0; ///< Cancels that crossed the final fill (the order is gone).
+            int64_t filled = 0, signed_filled = 0, slippage_ticks = 0;
+            bool within_limits = true;
+        };
+        auto on_report = [](void* context, const ExecutionReport& report) {
+            Session& session = *static_cast<Session*>(context);
+            const auto slot = static_cast<uint32_t>(report.id);
+            if (report.type == ExecType::Ack) {
+                const uint64_t round_trip = session.wheel->now() - session.sent_at[slot];
+                ++session.acks;
+                session.round_trip_sum += round_trip;
+                session.min_round_trip = std::min(session.min_round_trip, round_trip);
+            }
+            const OrderUpdate update = session.orders.onExecution(report);
+            if (update.result == ExecResult::UnknownOrder && report.type == ExecType::CancelReject) ++session.late_cancel_rejects;
+            if (update.result != ExecResult::Applied || report.type != ExecType::Fill) return;
+            const bool buy = update.order.side == Side::Bid;
+            const int64_t quantity = buy ? report.quantity : -report.quantity;
+            session.positions.onFill(update.order.symbol, quantity, toDouble(report.price));
+            session.filled += report.quantity;
+            session.signed_filled += quantity;
+            session.within_limits &= buy ? report.price <= update.order.price : report.price >= update.order.price;
+            if (session.seen[slot] != 0) {
+                ++session.taker_fills;
+                session.slippage_ticks += (buy ? report.price - session.seen[slot] : session.seen[slot] - report.price) / kTick;
+            }
+        };
+
+        struct Run {
+            double seconds = 0;
+            uint64_t acks = 0, round_trip_sum = 0, min_round_trip = 0, taker_fills = 0;
+            int64_t signed_filled = 0, slippage_ticks = 0;
+            double realized = 0;
+            ExchangeStats exchange;
+            bool ok = true;
+            bool operator==(const Run& other) const {
+                return acks == other.acks && round_trip_sum == other.round_trip_sum && signed_filled == other.signed_filled &&
+                       slippage_ticks == other.slippage_ticks && realized == other.realized;
+            }
+        };
+        auto simulate = [&](LatencyModel outbound, LatencyModel inbound, bool trading) {
+            TimerWheel wheel(1 << 16, 1, 0);
+            Session session;
+            session.wheel = &wheel;
+            SimulatedExchange exchange(wheel, kSymbols, session.orders.capacity(), std::move(outbound), std::move(inbound),
+                                       on_report, &session);
+            std::deque<ClientOrderId> resting;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < trades; ++i) {
+                wheel.advance((i + 1) * kSpacingNs);
+                const Trade& trade = tape[i];
+                session.positions.onTick(trade.symbol, toDouble(trade.price));
+                if (!trading) continue;
+                exchange.onTrade(trade.symbol, trade.price, trade.volume);
+                if (i % kOrderEvery != kOrderEvery - 1) continue;
+                const bool taker = (i / kOrderEvery) % 2 == 0;
+                const Side side = (i / kOrderEvery / 2) % 2 == 0 ? Side::Bid : Side::Ask;
+                const FixedPrice offset = (taker ? 5 : -3) * kTick;
+                const FixedPrice price = side == Side::Bid ? trade.price + offset : trade.price - offset;
+                const ClientOrderId id = session.orders.submit(trade.symbol, side, price, 100);
+                if (id == kInvalidOrderId) continue;
+                session.sent_at[static_cast<uint32_t>(id)] = wheel.now();
+                session.seen[static_cast<uint32_t>(id)] = taker ? trade.price : 0;
+                exchange.send(id, trade.symbol, side, price, 100);
+                if (!taker) resting.push_back(id);
+                while (resting.size() > kMaxResting) {
+                    const ClientOrderId oldest = resting.front();
+                    resting.pop_front();
+                    if (session.orders.requestCancel(oldest)) exchange.sendCancel(oldest);
+                }
+            }
+            wheel.advance(trades * kSpacingNs + 1'000'000'000); // Let every message land
+            auto end = std::chrono::high_resolution_clock::now();
+
+            Run run;
+            run.seconds = std::chrono::duration<double>(end - start).count();
+            run.acks = session.acks;
+            run.round_trip_sum = session.round_trip_sum;
+            run.min_round_trip = session.acks == 0 ? 0 : session.min_round_trip;
+            run.taker_fills = session.taker_fills;
+            run.signed_filled = session.signed_filled;
+            run.slippage_ticks = session.slippage_ticks;
+            run.realized = session.positions.account().realized;
+            run.exchange = exchange.stats();
+            int64_t held = 0;
+            for (uint32_t symbol = 0; symbol < kSymbols; ++symbol) held += session.positions.position(symbol).quantity;
+            run.ok = session.orders.ignored() == session.late_cancel_rejects && session.within_limits && held == session.signed_filled &&
+                     session.filled == run.exchange.filled_quantity && run.exchange.dropped == 0 &&
+                     exchange.inFlight() == 0 && session.orders.live() == exchange.resting();
+            return run;
+        };
+        auto report = [&](const std::string& name, const Run& run, double baseline, bool ok) {
+            std::cout << name << ": " << trades << " prints, " << run.seconds * 1000.0 << " ms, "
+                      << run.seconds * 1e9 / static_cast<double>(trades) << " ns/print";
+            if (baseline > 0) {
+                std::cout << " (+" << (run.seconds - baseline) * 1e9 / static_cast<double>(trades) << "), "
+                          << run.exchange.orders << " orders, " << run.exchange.fills << " fills, " << run.exchange.cancels
+                          << " cancels, ack round trip "
+                          << static_cast<double>(run.round_trip_sum) / static_cast<double>(std::max<uint64_t>(run.acks, 1)) / 1000.0
+                          << " us, taker slippage "
+                          << static_cast<double>(run.slippage_ticks) / static_cast<double>(std::max<uint64_t>(run.taker_fills, 1))
+                          << " ticks";
+            }
+            std::cout << (ok ? "" : " (MISMATCH)") << "\n";
+        };
+
+        const Run idle = simulate(LatencyModel::fixed(0), LatencyModel::fixed(0), false);
+        report("Exchange, market data only", idle, 0, true);
+        const Run instant = simulate(LatencyModel::fixed(0), LatencyModel::fixed(0), true);
+        report("Exchange, no latency", instant, idle.seconds, instant.ok);
+        const Run fixed = simulate(LatencyModel::fixed(kOneWayNs), LatencyModel::fixed(kOneWayNs), true);
+        report("Exchange, fixed 50 us", fixed, idle.seconds, fixed.ok && fixed.min_round_trip >= 2 * kOneWayNs);
+        const Run empirical = simulate(loadLatencyHistogram(histogram_path, 7), loadLatencyHistogram(histogram_path, 8), true);
+        const Run again = simulate(loadLatencyHistogram(histogram_path, 7), loadLatencyHistogram(histogram_path, 8), true);
+        report("Exchange, empirical histogram", empirical, idle.seconds, empirical.ok && empirical == again);
+        const Run loaded = simulate(parseLatencyModel("load:20000,50,1000000"), parseLatencyModel("load:20000,50,1000000"), true);
+        report("Exchange, load-dependent", loaded, idle.seconds, loaded.ok);
+        std::remove(histogram_path.c_str());
+    }
+    static void run_tick_scan(size_t ticks) {
+        // "volume > 500 and 90 <= price <= 110 between 10:00 and 15:00", aggregated over five
+        // groups of 100 symbols, on raw and delta-encoded stores, at every ISA level.
+        constexpr size_t kSymbols = 500;
+        constexpr size_t kGroups = 5;
+        constexpr uint64_t kSessionStart = 1'699'954'200ULL * 1'000'000'000ULL; // 09:30 UTC
+        constexpr uint64_t kSessionNs = 23'400ULL * 1'000'000'000ULL;
+        const std::string path = "benchmark.scan";
+        struct Tick {
+            uint32_t symbol;
+            int32_t volume;
+            uint64_t timestamp;
+            FixedPrice price;
+        };
+        std::mt19937_64 rng(17);
+        std::vector<Tick> flat(ticks);
+        for (size_t i = 0; i < ticks; ++i) {
+            flat[i] = Tick{static_cast<uint32_t>(rng() % kSymbols), static_cast<int32_t>(1 + rng() % 1000),
+                           kSessionStart + kSessionNs / ticks * i,
+                           static_cast<FixedPrice>(80 * kPriceScale + static_cast<int64_t>(rng() % (40 * kPriceScale)))};
+        }
+        auto ticker = [](uint32_t symbol) { return packTicker("S" + std::to_string(symbol)); };
+        std::vector<std::vector<uint64_t>> groups(kGroups);
+        for (uint32_t symbol = 0; symbol < kSymbols; ++symbol) groups[symbol % kGroups].push_back(ticker(symbol));
+
+        TickFilter filter;
+        filter.from = kSessionStart + 1800ULL * 1'000'000'000ULL;
+        filter.to = kSessionStart + 19'800ULL * 1'000'000'000ULL;
+        filter.min_volume = 501;
+        filter.min_price = 90 * kPriceScale;
+        filter.max_price = 110 * kPriceScale;
+
+        std::vector<TickAggregate> expected(kGroups);
+        for (const Tick& tick : flat) {
+            if (tick.timestamp < filter.from || tick.timestamp > filter.to || tick.volume < filter.min_volume ||
+                tick.price < filter.min_price || tick.price > filter.max_price) {
+                continue;
+            }
+            TickAggregate one;
+            one.count = 1;
+            one.volume = tick.volume;
+            one.notional = toDouble(tick.price) * tick.volume;
+            one.min_price = one.max_price = tick.price;
+            expected[tick.symbol % kGroups].merge(one);
+        }
+        auto matches = [&](const std::vector<TickAggregate>& result) {
+            for (size_t g = 0; g < kGroups; ++g) {
+                const TickAggregate& a = result[g];
+                const TickAggregate& e = expected[g];
+                if (a.count != e.count || a.volume != e.volume || a.min_price != e.min_price || a.max_price != e.max_price ||
+                    std::abs(a.notional - e.notional) > 1e-9 * e.notional) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        ThreadPool serial(1);
+        ThreadPool parallel(std::max<size_t>(4, std::thread::hardware_concurrency())); // Parallel path checked on small hosts too
+        const IsaLevel startup_level = simd().level;
+        for (TickEncoding encoding : {TickEncoding::Raw, TickEncoding::Delta}) {
+            {
+                TickStoreWriter writer(path, encoding);
+                for (const Tick& tick : flat) writer.append(ticker(tick.symbol), tick.timestamp, tick.price, tick.volume);
+                writer.close();
+            }
+            TickStoreReader store(path);
+            for (IsaLevel level : {IsaLevel::Scalar, IsaLevel::SSE42, IsaLevel::AVX2, IsaLevel::AVX512}) {
+                if (level > detectedIsa()) break;
+                setSimdLevel(level);
+                for (ThreadPool* pool : {&serial, &parallel}) {
+                    TickScanner scanner(store, *pool);
+                    scanner.scan(groups, filter); // Warm the mapping and the worker scratch
+                    auto start = std::chrono::high_resolution_clock::now();
+                    std::vector<TickAggregate> result = scanner.scan(groups, filter);
+                    auto end = std::chrono::high_resolution_clock::now();
+                    double seconds = std::chrono::duration<double>(end - start).count();
+                    uint64_t selected = 0;
+                    for (const TickAggregate& group : result) selected += group.count;
+                    double bytes = static_cast<double>(scanner.scannedTicks() * (sizeof(uint64_t) + sizeof(FixedPrice) + sizeof(int32_t)));
+                    std::cout << "Tick scan (" << (encoding == TickEncoding::Raw ? "raw" : "delta") << ", " << isaName(level)
+                              << ", " << pool->size() << " threads): " << scanner.scannedTicks() << " ticks scanned, " << selected
+                              << " selected, " << seconds * 1000.0 << " ms, " << bytes / 1e9 / seconds << " GB/s, "
+                              << static_cast<double>(scanner.scannedTicks()) / 1e6 / seconds << " M ticks/s"
+                              << (matches(result) ? "" : " (MISMATCH)") << "\n";
+                }
+            }
+            setSimdLevel(startup_level);
+        }
+        std::remove(path.c_str());
+    }
 };
 
-int main() {
+int main(int argc, char** argv) {
+    // With no arguments every benchmark runs; otherwise only the named groups do.
+    auto selected = [&](std::string_view name) {
+        if (argc < 2) return true;
+        for (int i = 1; i < argc; ++i) {
+            if (name == argv[i]) return true;
+        }
+        return false;
+    };
+
     const size_t iterations = 1'000'000;
     std::cout << "sizeof(MarketData): " << sizeof(MarketData) << " bytes\n";
-    Benchmark::run_mutex_queue(iterations);
-    Benchmark::run_lock_free_queue(iterations);
-    Benchmark::run_allocation_benchmark(iterations);
+    if (selected("queue")) {
+        Benchmark::run_mutex_queue(iterations);
+        Benchmark::run_lock_free_queue(iterations);
+    }
+    if (selected("alloc")) Benchmark::run_allocation_benchmark(iterations);
+    if (selected("false_sharing")) Benchmark::run_false_sharing(iterations * 10);
+    if (selected("simd")) Benchmark::run_simd_dispatch(256 << 20);
+    if (selected("snapshot")) Benchmark::run_snapshot_restore(10'000, 10'000);
+    if (selected("io")) Benchmark::run_async_writer(256 << 20);
+    if (selected("net")) Benchmark::run_feed_receiver(200'000);
+    if (selected("pcap")) Benchmark::run_pcap_replay(1'000'000);
+    if (selected("filter")) Benchmark::run_subscription_filter(10'000'000);
+    if (selected("phash")) Benchmark::run_perfect_hash(10'000'000);
+    if (selected("price")) Benchmark::run_price_parser(10'000'000);
+    if (selected("ticks")) Benchmark::run_tick_store(10'000'000);
+    if (selected("codec")) Benchmark::run_tick_codec(10'000'000);
+    if (selected("sort")) Benchmark::run_radix_sort(10'000'000);
+    if (selected("scan")) Benchmark::run_tick_scan(20'000'000);
+    if (selected("ladder")) Benchmark::run_price_ladder(10'000'000);
+    if (selected("signals")) Benchmark::run_book_signals(10'000'000);
+    if (selected("baskets")) Benchmark::run_basket_calculator(10'000'000);
+    if (selected("nbbo")) Benchmark::run_nbbo(10'000'000);
+    if (selected("positions")) Benchmark::run_position_tracker(10'000'000);
+    if (selected("orders")) Benchmark::run_order_manager(10'000'000);
+    if (selected("timers")) Benchmark::run_timer_wheel(1'000'000);
+    if (selected("exchange")) Benchmark::run_simulated_exchange(10'000'000);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,202 @@
+#pragma once
+#include "order_book.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief Book-derived signals at one point in time. Fields that need both sides are 0 while the
+ * book is one-sided.
+ */
+struct BookSignalSnapshot {
+    FixedPrice bid = 0;          ///< Best bid (0 if none).
+    FixedPrice ask = 0;          ///< Best ask (0 if none).
+    int64_t bid_quantity = 0;    ///< Quantity at the best bid.
+    int64_t ask_quantity = 0;    ///< Quantity at the best ask.
+    int64_t spread_ticks = 0;    ///< ask - bid in ticks.
+    int64_t bid_depth = 0;       ///< Bid quantity within depth_ticks of the best bid.
+    int64_t ask_depth = 0;       ///< Ask quantity within depth_ticks of the best ask.
+    double microprice = 0;       ///< Touch prices weighted by the opposite side's quantity.
+    double weighted_mid = 0;     ///< Mean of the bid and ask VWAPs over the top levels.
+    double imbalance = 0;        ///< (bid - ask) / (bid + ask) quantity over the top levels, in [-1, 1].
+
+    bool operator==(const BookSignalSnapshot&) const = default;
+};
+
+/**
+ * @brief Signals attached to an OrderBook, kept current from the LevelDeltas the book returns.
+ *
+ * Per side, the calculator keeps the quantity and level-weighted quantity of the top N levels
+ * and the quantity within X ticks of the best price. A change inside the top set or the depth
+ * window is a couple of additions; a level entering or leaving the top set costs one bitmap
+ * search for the level that replaces it; the depth window is only re-summed (X + 1 contiguous
+ * quantities, empty levels included) when the best price moves. snapshot() turns the sums into
+ * prices and ratios, so a strategy pays for the divisions only when it reads the signals.
+ *
+ * Sums are kept in level indices, exactly, so the incremental state never drifts from a
+ * recomputation (compute()) of the same book.
+ */
+class BookSignals {
+public:
+    /**
+     * @brief Attaches to book (which must outlive the calculator) and computes the initial state.
+     * @param top_levels Levels per side for imbalance and weighted mid (at least 1).
+     * @param depth_ticks Width of the depth window behind each side's best price.
+     */
+    explicit BookSignals(const OrderBook& book, size_t top_levels = 5, size_t depth_ticks = 10) noexcept
+        : book_(book), top_levels_(std::max<size_t>(1, top_levels)), depth_ticks_(depth_ticks) {
+        reset();
+    }
+
+    /**
+     * @brief Follows one change, after the book has applied it.
+     */
+    void apply(const LevelDelta& delta) noexcept {
+        if (delta.before == delta.after) return;
+        const PriceLadder& ladder = book_.side(delta.side);
+        SideState& state = delta.side == Side::Bid ? bid_ : ask_;
+        applyTop(ladder, state, delta);
+        applyDepth(ladder, state, delta);
+    }
+
+    /**
+     * @brief Recomputes the state from the book, e.g. after it was cleared or bulk-loaded.
+     */
+    void reset() noexcept {
+        bid_ = rebuild(book_.bids(), top_levels_, depth_ticks_);
+        ask_ = rebuild(book_.asks(), top_levels_, depth_ticks_);
+    }
+
+    BookSignalSnapshot snapshot() const noexcept { return finish(book_, bid_, ask_); }
+
+    /**
+     * @brief Signals computed from scratch by walking the book; equal to an up-to-date snapshot().
+     */
+    static BookSignalSnapshot compute(const OrderBook& book, size_t top_levels, size_t depth_ticks) noexcept {
+        top_levels = std::max<size_t>(1, top_levels);
+        return finish(book, rebuild(book.bids(), top_levels, depth_ticks), rebuild(book.asks(), top_levels, depth_ticks));
+    }
+
+private:
+    static constexpr size_t npos = PriceLadder::npos;
+
+    struct SideState {
+        int64_t top_quantity = 0; ///< Quantity over the top set.
+        int64_t top_weighted = 0; ///< Sum of level index x quantity over the top set.
+        size_t top_count = 0;     ///< Levels in the top set (< top_levels only if the side has fewer).
+        size_t edge = npos;       ///< Worst level in the top set.
+        int64_t depth = 0;        ///< Quantity within depth_ticks of depth_anchor.
+        size_t depth_anchor = npos; ///< Best level the depth window is measured from.
+    };
+
+    static bool inDepth(const PriceLadder& ladder, size_t anchor, size_t level, size_t depth_ticks) noexcept {
+        return ladder.side() == Side::Bid ? level + depth_ticks >= anchor : level <= anchor + depth_ticks;
+    }
+
+    static SideState rebuild(const PriceLadder& ladder, size_t top_levels, size_t depth_ticks) noexcept {
+        SideState state;
+        for (size_t level = ladder.bestLevel(); level != npos && state.top_count < top_levels; level = ladder.nextLevel(level)) {
+            addTop(state, level, ladder.quantityAt(level));
+            ++state.top_count;
+            state.edge = level;
+        }
+        state.depth_anchor = ladder.bestLevel();
+        state.depth = depthFrom(ladder, state.depth_anchor, depth_ticks);
+        return state;
+    }
+
+    /// Sums the window's levels straight from the quantity array: X + 1 contiguous loads, no searches.
+    static int64_t depthFrom(const PriceLadder& ladder, size_t anchor, size_t depth_ticks) noexcept {
+        if (anchor == npos) return 0;
+        std::span<const int64_t> quantities = ladder.quantities();
+        const size_t first = ladder.side() == Side::Bid ? anchor - std::min(anchor, depth_ticks) : anchor;
+        const size_t last = ladder.side() == Side::Bid ? anchor : std::min(anchor + depth_ticks, quantities.size() - 1);
+        int64_t depth = 0;
+        for (size_t level = first; level <= last; ++level) depth += quantities[level];
+        return depth;
+    }
+
+    static void addTop(SideState& state, size_t level, int64_t quantity) noexcept {
+        state.top_quantity += quantity;
+        state.top_weighted += static_cast<int64_t>(level) * quantity;
+    }
+
+    /// Keeps the top set equal to the best top_levels_ levels of ladder (which already has delta).
+    void applyTop(const PriceLadder& ladder, SideState& state, const LevelDelta& delta) noexcept {
+        const size_t level = delta.level;
+        const bool in_top = state.top_count > 0 && (level == state.edge || ladder.isBetter(level, state.edge));
+        if (delta.before > 0 && delta.after > 0) { // Resized
+            if (in_top) addTop(state, level, delta.after - delta.before);
+        } else if (delta.after > 0) { // Added
+            if (state.top_count < top_levels_) { // Every level is in the set
+                addTop(state, level, delta.after);
+                ++state.top_count;
+                if (state.edge == npos || ladder.isBetter(state.edge, level)) state.edge = level;
+            } else if (ladder.isBetter(level, state.edge)) { // Displaces the edge level
+                addTop(state, level, delta.after);
+                addTop(state, state.edge, -ladder.quantityAt(state.edge));
+                state.edge = ladder.previousLevel(state.edge);
+            }
+        } else if (in_top) { // Removed: the next level behind the edge, if any, joins
+            addTop(state, level, -delta.before);
+            --state.top_count;
+            const size_t next = ladder.nextLevel(state.edge);
+            if (next != npos) {
+                addTop(state, next, ladder.quantityAt(next));
+                ++state.top_count;
+                state.edge = next;
+            } else if (level == state.edge) {
+                state.edge = ladder.previousLevel(level);
+            }
+        }
+    }
+
+    void applyDepth(const PriceLadder& ladder, SideState& state, const LevelDelta& delta) noexcept {
+        const size_t best = ladder.bestLevel();
+        if (best != state.depth_anchor) {
+            state.depth_anchor = best;
+            state.depth = depthFrom(ladder, best, depth_ticks_);
+        } else if (best != npos && inDepth(ladder, best, delta.level, depth_ticks_)) {
+            state.depth += delta.after - delta.before;
+        }
+    }
+
+    static BookSignalSnapshot finish(const OrderBook& book, const SideState& bid, const SideState& ask) noexcept {
+        BookSignalSnapshot out;
+        const PriceLadder& bids = book.bids();
+        const PriceLadder& asks = book.asks();
+        const size_t bid_level = bids.bestLevel();
+        const size_t ask_level = asks.bestLevel();
+        if (bid_level != npos) {
+            out.bid = bids.priceOf(bid_level);
+            out.bid_quantity = bids.quantityAt(bid_level);
+        }
+        if (ask_level != npos) {
+            out.ask = asks.priceOf(ask_level);
+            out.ask_quantity = asks.quantityAt(ask_level);
+        }
+        out.bid_depth = bid.depth;
+        out.ask_depth = ask.depth;
+        if (bid_level == npos || ask_level == npos) return out;
+
+        out.spread_ticks = static_cast<int64_t>(ask_level) - static_cast<int64_t>(bid_level);
+        const double bid_price = toDouble(out.bid), ask_price = toDouble(out.ask);
+        out.microprice = (bid_price * static_cast<double>(out.ask_quantity) + ask_price * static_cast<double>(out.bid_quantity)) /
+                         static_cast<double>(out.bid_quantity + out.ask_quantity);
+        auto vwap = [&](const SideState& side) {
+            const double level = static_cast<double>(side.top_weighted) / static_cast<double>(side.top_quantity);
+            return toDouble(bids.low()) + level * toDouble(bids.tick());
+        };
+        out.weighted_mid = (vwap(bid) + vwap(ask)) / 2;
+        out.imbalance = static_cast<double>(bid.top_quantity - ask.top_quantity) /
+                        static_cast<double>(bid.top_quantity + ask.top_quantity);
+        return out;
+    }
+
+    const OrderBook& book_;
+    size_t top_levels_;
+    size_t depth_ticks_;
+    SideState bid_;
+    SideState ask_;
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief Timestamp counter clock for cheap hot-path timestamps.
+ *
+ * now() is a single rdtsc (a few nanoseconds, no syscall, no vDSO call), which makes it suitable
+ * for stamping every message. Ticks are converted to nanoseconds with a ratio calibrated once
+ * against std::chrono::steady_clock. Assumes an invariant TSC, as on all modern x86 servers;
+ * other architectures fall back to steady_clock nanoseconds.
+ */
+class TscClock {
+public:
+    /**
+     * @brief Reads the current tick count.
+     */
+    static uint64_t now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /**
+     * @brief Nanoseconds per tick, calibrated on first use (~10 ms, thread-safe).
+     */
+    static double nsPerTick() {
+        static const double ratio = calibrate();
+        return ratio;
+    }
+
+    /**
+     * @brief Converts a tick delta to nanoseconds.
+     */
+    static uint64_t toNanos(uint64_t ticks) {
+        return static_cast<uint64_t>(static_cast<double>(ticks) * nsPerTick());
+    }
+
+    /**
+     * @brief Converts nanoseconds to a tick delta.
+     */
+    static uint64_t fromNanos(uint64_t nanos) {
+        return static_cast<uint64_t>(static_cast<double>(nanos) / nsPerTick());
+    }
+
+private:
+    static double calibrate() {
+#if defined(__x86_64__) || defined(__i386__)
+        auto wall_start = std::chrono::steady_clock::now();
+        uint64_t tsc_start = now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        auto wall_end = std::chrono::steady_clock::now();
+        uint64_t tsc_end = now();
+        auto elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wall_end - wall_start).count();
+        return static_cast<double>(elapsed_ns) / static_cast<double>(tsc_end - tsc_start);
+#else
+        return 1.0;
+#endif
+    }
+};
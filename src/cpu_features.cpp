@@ -0,0 +1,68 @@
+#include "cpu_features.h"
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace {
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * @brief Reads XCR0 to learn which register states the OS saves on context switch.
+ */
+uint64_t readXcr0() noexcept {
+    uint32_t eax = 0, edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+#endif
+
+IsaLevel probeIsa() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return IsaLevel::Scalar;
+    const bool sse42 = ecx & bit_SSE4_2;
+    const bool osxsave = ecx & bit_OSXSAVE;
+    const bool avx = ecx & bit_AVX;
+    if (!sse42) return IsaLevel::Scalar;
+    if (!osxsave || !avx) return IsaLevel::SSE42;
+
+    const uint64_t xcr0 = readXcr0();
+    const bool ymm_state = (xcr0 & 0x6) == 0x6;    // XMM + YMM
+    const bool zmm_state = (xcr0 & 0xE6) == 0xE6;  // + opmask, ZMM_Hi256, Hi16_ZMM
+    if (!ymm_state) return IsaLevel::SSE42;
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) return IsaLevel::SSE42;
+    const bool avx2 = (ebx & bit_AVX2) && (ebx & bit_BMI2);
+    const bool avx512 = (ebx & bit_AVX512F) && (ebx & bit_AVX512BW) && (ebx & bit_AVX512VL);
+    if (avx2 && avx512 && zmm_state) return IsaLevel::AVX512;
+    if (avx2) return IsaLevel::AVX2;
+    return IsaLevel::SSE42;
+#else
+    return IsaLevel::Scalar;
+#endif
+}
+
+} // namespace
+
+const char* isaName(IsaLevel level) noexcept {
+    switch (level) {
+    case IsaLevel::Scalar: return "scalar";
+    case IsaLevel::SSE42: return "sse42";
+    case IsaLevel::AVX2: return "avx2";
+    case IsaLevel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+std::optional<IsaLevel> parseIsa(std::string_view name) noexcept {
+    for (IsaLevel level : {IsaLevel::Scalar, IsaLevel::SSE42, IsaLevel::AVX2, IsaLevel::AVX512}) {
+        if (name == isaName(level)) return level;
+    }
+    return std::nullopt;
+}
+
+IsaLevel detectedIsa() noexcept {
+    static const IsaLevel level = probeIsa();
+    return level;
+}
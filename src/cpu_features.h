@@ -0,0 +1,31 @@
+#pragma once
+#include <optional>
+#include <string_view>
+
+/**
+ * @brief Instruction-set levels that SIMD kernels are specialised for, in ascending order.
+ */
+enum class IsaLevel {
+    Scalar = 0, ///< Portable C++, no vector intrinsics.
+    SSE42 = 1,  ///< SSE4.2 (128-bit), present on every x86-64 host we run.
+    AVX2 = 2,   ///< AVX2 (256-bit).
+    AVX512 = 3, ///< AVX-512 F/BW/VL (512-bit).
+};
+
+/**
+ * @brief Returns a short lowercase name ("scalar", "sse42", "avx2", "avx512").
+ */
+const char* isaName(IsaLevel level) noexcept;
+
+/**
+ * @brief Parses an ISA name as returned by isaName().
+ */
+std::optional<IsaLevel> parseIsa(std::string_view name) noexcept;
+
+/**
+ * @brief Highest ISA level supported by both the CPU and the OS.
+ *
+ * Detected once via cpuid (and xgetbv, so AVX state is only used when the kernel saves it);
+ * later calls return the cached result.
+ */
+IsaLevel detectedIsa() noexcept;
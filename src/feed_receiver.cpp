@@ -0,0 +1,224 @@
+#include "feed_receiver.h"
+#include "clock.h"
+#include "io_uring.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+std::runtime_error socketError(const std::string& what) {
+    return std::runtime_error("Feed receiver " + what + " failed: errno " + std::to_string(errno));
+}
+
+/**
+ * @brief Busy-polled recvmmsg(2) backend: one syscall per batch of up to kBatch datagrams.
+ */
+class RecvmmsgReceiver final : public FeedReceiver {
+public:
+    explicit RecvmmsgReceiver(const FeedEndpoint& endpoint)
+        : FeedReceiver(endpoint), buffers_(kBatch * kMaxDatagramSize) {
+        for (size_t i = 0; i < kBatch; ++i) {
+            iovecs_[i] = {buffers_.data() + i * kMaxDatagramSize, kMaxDatagramSize};
+            messages_[i] = {};
+            messages_[i].msg_hdr.msg_iov = &iovecs_[i];
+            messages_[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+
+    size_t poll(LockFreeQueue& queue) override {
+        size_t committed = 0;
+        for (;;) {
+            int received = ::recvmmsg(fd_, messages_, kBatch, MSG_DONTWAIT, nullptr);
+            if (received < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) break;
+                throw socketError("recvmmsg");
+            }
+            uint64_t now = TscClock::now();
+            for (int i = 0; i < received; ++i) {
+                committed += deliver(buffers_.data() + static_cast<size_t>(i) * kMaxDatagramSize,
+                                     messages_[i].msg_len, now, queue);
+            }
+            if (static_cast<size_t>(received) < kBatch) break;
+        }
+        return committed;
+    }
+
+    FeedBackend backend() const noexcept override { return FeedBackend::Recvmmsg; }
+
+private:
+    static constexpr size_t kBatch = 64;
+
+    std::vector<uint8_t> buffers_; ///< kBatch datagram buffers.
+    iovec iovecs_[kBatch];
+    mmsghdr messages_[kBatch];
+};
+
+/**
+ * @brief io_uring backend: one multishot recv keeps posting completions, each naming the
+ * provided buffer the kernel filled, so steady-state receive needs no syscalls at all.
+ *
+ * Buffers are recycled to the ring right after decoding and published with a single tail store
+ * per poll. If the kernel runs out of buffers or otherwise ends the multishot request (no
+ * IORING_CQE_F_MORE), it is re-armed on the next poll.
+ */
+class IoUringReceiver final : public FeedReceiver {
+public:
+    explicit IoUringReceiver(const FeedEndpoint& endpoint)
+        : FeedReceiver(endpoint),
+          buffer_ring_(static_cast<io_uring_buf_ring*>(std::aligned_alloc(4096, kBufferCount * sizeof(io_uring_buf)))),
+          buffers_(static_cast<uint8_t*>(std::aligned_alloc(4096, kBufferCount * kBufferSize))),
+          ring_(kRingEntries, 0, 2 * kBufferCount) {
+        if (!buffer_ring_ || !buffers_) throw std::bad_alloc();
+        for (uint16_t bid = 0; bid < kBufferCount; ++bid) recycle(bid);
+        publishBuffers();
+        if (!ring_.registerBufferRing(buffer_ring_.get(), kBufferCount, kBufferGroup)) {
+            throw std::runtime_error("io_uring provided buffer rings are not supported by this kernel");
+        }
+        arm();
+    }
+
+    size_t poll(LockFreeQueue& queue) override {
+        size_t committed = 0;
+        uint64_t now = TscClock::now();
+        // Every completion holds a buffer, so a CQ of 2x kBufferCount cannot overflow; stay
+        // correct if it ever does, since parked completions need a kernel entry to come back.
+        if (ring_.cqOverflowed()) ring_.flushOverflow();
+        while (io_uring_cqe* cqe = ring_.peekCqe()) {
+            int result = cqe->res;
+            uint32_t flags = cqe->flags;
+            ring_.cqeSeen();
+            if (flags & IORING_CQE_F_BUFFER) {
+                auto bid = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+                if (result > 0) committed += deliver(buffers_.get() + bid * kBufferSize, static_cast<size_t>(result), now, queue);
+                recycle(bid);
+            } else if (result == -ENOBUFS) {
+                ++decoder_.stats().no_buffers;
+            } else if (result < 0 && result != -EINTR && result != -EAGAIN) {
+                errno = -result;
+                throw socketError("io_uring recv");
+            }
+            if (!(flags & IORING_CQE_F_MORE)) armed_ = false;
+        }
+        publishBuffers();
+        if (!armed_) arm();
+        return committed;
+    }
+
+    FeedBackend backend() const noexcept override { return FeedBackend::IoUring; }
+
+private:
+    static constexpr unsigned kRingEntries = 8;      ///< Only the multishot recv is ever submitted.
+    static constexpr uint16_t kBufferCount = 1024;   ///< Provided buffers; a power of two.
+    static constexpr size_t kBufferSize = 2048;      ///< Bytes per buffer, >= kMaxDatagramSize.
+    static constexpr uint16_t kBufferGroup = 0;
+
+    /**
+     * @brief Queues buffer bid for reuse; visible to the kernel after publishBuffers().
+     */
+    void recycle(uint16_t bid) noexcept {
+        // Index the descriptors directly: in C++ the header's flex-array wrapper shifts `bufs`.
+        auto* bufs = reinterpret_cast<io_uring_buf*>(buffer_ring_.get());
+        io_uring_buf& buf = bufs[buffer_tail_ & (kBufferCount - 1)];
+        buf.addr = reinterpret_cast<uint64_t>(buffers_.get() + bid * kBufferSize);
+        buf.len = static_cast<uint32_t>(kBufferSize);
+        buf.bid = bid;
+        ++buffer_tail_;
+    }
+
+    void publishBuffers() noexcept { __atomic_store_n(&buffer_ring_->tail, buffer_tail_, __ATOMIC_RELEASE); }
+
+    /**
+     * @brief Submits the multishot recv that selects buffers from kBufferGroup.
+     */
+    void arm() {
+        io_uring_sqe* sqe = ring_.getSqe();
+        if (!sqe) throw std::runtime_error("io_uring submission queue full");
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = fd_;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = kBufferGroup;
+        ring_.submit();
+        armed_ = true;
+    }
+
+    struct FreeDeleter {
+        void operator()(void* p) const noexcept { std::free(p); }
+    };
+
+    std::unique_ptr<io_uring_buf_ring, FreeDeleter> buffer_ring_; ///< Provided buffer descriptors shared with the kernel.
+    std::unique_ptr<uint8_t, FreeDeleter> buffers_; ///< kBufferCount buffers of kBufferSize bytes.
+    IoUring ring_;             ///< Declared after the buffers: closed (cancelling the recv) before they are freed.
+    uint16_t buffer_tail_ = 0; ///< Local buffer ring tail.
+    bool armed_ = false;       ///< A multishot recv is outstanding.
+};
+
+} // namespace
+
+const char* feedBackendName(FeedBackend backend) noexcept {
+    return backend == FeedBackend::IoUring ? "io_uring" : "recvmmsg";
+}
+
+std::optional<FeedBackend> parseFeedBackend(std::string_view name) noexcept {
+    if (name == "recvmmsg") return FeedBackend::Recvmmsg;
+    if (name == "io_uring") return FeedBackend::IoUring;
+    return std::nullopt;
+}
+
+/**
+ * @brief Binds a non-blocking UDP socket with a large receive buffer, joining the group if any.
+ */
+FeedReceiver::FeedReceiver(const FeedEndpoint& endpoint) {
+    fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd_ < 0) throw socketError("socket");
+    try {
+        int reuse = 1;
+        ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        int buffer_size = 8 << 20; // Best effort; capped by net.core.rmem_max
+        ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(endpoint.port);
+        if (::inet_pton(AF_INET, endpoint.address.c_str(), &address.sin_addr) != 1) {
+            throw std::runtime_error("Invalid feed address " + endpoint.address);
+        }
+        if (::bind(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) throw socketError("bind");
+        socklen_t length = sizeof(address);
+        if (::getsockname(fd_, reinterpret_cast<sockaddr*>(&address), &length) != 0) throw socketError("getsockname");
+        port_ = ntohs(address.sin_port);
+
+        if (!endpoint.multicast_group.empty()) {
+            ip_mreq membership{};
+            if (::inet_pton(AF_INET, endpoint.multicast_group.c_str(), &membership.imr_multiaddr) != 1) {
+                throw std::runtime_error("Invalid multicast group " + endpoint.multicast_group);
+            }
+            membership.imr_interface.s_addr = htonl(INADDR_ANY);
+            if (::setsockopt(fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+                throw socketError("IP_ADD_MEMBERSHIP");
+            }
+        }
+    } catch (...) {
+        ::close(fd_);
+        throw;
+    }
+}
+
+FeedReceiver::~FeedReceiver() {
+    if (fd_ >= 0) ::close(fd_);
+}
+
+std::unique_ptr<FeedReceiver> makeFeedReceiver(FeedBackend backend, const FeedEndpoint& endpoint) {
+    if (backend == FeedBackend::IoUring) {
+        if (!IoUring::supported()) throw std::runtime_error("io_uring is not available");
+        return std::make_unique<IoUringReceiver>(endpoint);
+    }
+    return std::make_unique<RecvmmsgReceiver>(endpoint);
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include "lock_free_queue.h"
+#include "subscription_filter.h"
+#include "wire_format.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Kernel interface used to receive feed datagrams.
+ */
+enum class FeedBackend {
+    Recvmmsg, ///< Busy-polled non-blocking recvmmsg(2), up to 64 datagrams per call.
+    IoUring,  ///< io_uring multishot recv into a provided buffer ring, no per-packet syscalls.
+};
+
+const char* feedBackendName(FeedBackend backend) noexcept;
+
+/**
+ * @brief Parses "recvmmsg" or "io_uring".
+ */
+std::optional<FeedBackend> parseFeedBackend(std::string_view name) noexcept;
+
+/**
+ * @brief UDP endpoint a receiver binds to.
+ */
+struct FeedEndpoint {
+    std::string address = "0.0.0.0"; ///< Local IPv4 address to bind.
+    uint16_t port = 0;               ///< Local port; 0 picks an ephemeral port (see FeedReceiver::port()).
+    std::string multicast_group;     ///< IPv4 multicast group to join; empty for unicast.
+};
+
+/**
+ * @brief Receive-side counters, owned by the polling thread.
+ */
+struct ReceiverStats {
+    uint64_t datagrams = 0;   ///< Datagrams received.
+    uint64_t updates = 0;     ///< Updates committed to the queue.
+    uint64_t malformed = 0;   ///< Datagrams that failed to decode (truncated, foreign or with an empty ticker).
+    uint64_t gaps = 0;        ///< Datagrams missing from the sequence.
+    uint64_t queue_full = 0;  ///< Updates dropped because the queue was full.
+    uint64_t filtered = 0;    ///< Updates for unsubscribed symbols, skipped before taking a slot.
+    uint64_t no_buffers = 0;  ///< Times the kernel ran out of provided buffers (io_uring only).
+};
+
+/**
+ * @brief Decodes wire datagrams straight into LockFreeQueue slots and tracks sequence gaps.
+ *
+ * Shared by the live receivers and capture replay. They differ only in what happens when the
+ * queue is full, which the caller decides: a live feed drops, a replay waits. With a
+ * SubscriptionFilter attached, updates for unsubscribed tickers are skipped before a slot is claimed.
+ */
+class FeedDecoder {
+public:
+    /**
+     * @brief Decodes one datagram, claiming and committing a queue slot per update.
+     * @param timestamp Value stored in MarketData::timestamp for every update.
+     * @param on_full Called when no slot is free; return true to retry, false to drop the update.
+     * @return Number of updates committed.
+     */
+    template <typename OnFull>
+    size_t decode(const uint8_t* data, size_t size, uint64_t timestamp, LockFreeQueue& queue, OnFull&& on_full) {
+        ++stats_.datagrams;
+        size_t committed = 0;
+        bool valid = decodeDatagram(data, size, [&](const WireHeader&, const WireUpdate& update) {
+            if (filter_ && !filter_->accepts(update.ticker)) {
+                ++stats_.filtered;
+                return;
+            }
+            MarketData* slot;
+            while (!(slot = queue.claim())) {
+                if (!on_full()) {
+                    ++stats_.queue_full;
+                    return;
+                }
+            }
+            toMarketData(update, timestamp, *slot);
+            queue.commit();
+            ++committed;
+        });
+        if (!valid) {
+            ++stats_.malformed;
+            return 0;
+        }
+        uint64_t sequence;
+        std::memcpy(&sequence, data + offsetof(WireHeader, sequence), sizeof(sequence));
+        if (next_sequence_ != 0 && sequence > next_sequence_) stats_.gaps += sequence - next_sequence_;
+        if (sequence >= next_sequence_) next_sequence_ = sequence + 1;
+        stats_.updates += committed;
+        return committed;
+    }
+
+    ReceiverStats& stats() noexcept { return stats_; }
+    const ReceiverStats& stats() const noexcept { return stats_; }
+
+    /**
+     * @brief Attaches a subscription filter (nullptr passes everything); it must outlive the decoder.
+     */
+    void setFilter(const SubscriptionFilter* filter) noexcept { filter_ = filter; }
+
+private:
+    const SubscriptionFilter* filter_ = nullptr; ///< Optional subscription check per update.
+    uint64_t next_sequence_ = 0; ///< Expected datagram sequence (0 until the first datagram).
+    ReceiverStats stats_;
+};
+
+/**
+ * @brief Non-blocking UDP feed receiver that decodes datagrams straight into LockFreeQueue slots.
+ *
+ * Each backend owns its socket and receive buffers; poll() drains whatever the kernel has
+ * ready, decodes every update in place into a claimed queue slot and commits it, so no
+ * intermediate MarketData is built. Updates that find the queue full are dropped and counted,
+ * as a UDP feed cannot be back-pressured. Single thread: create, poll and destroy on one thread.
+ */
+class FeedReceiver {
+public:
+    virtual ~FeedReceiver();
+
+    FeedReceiver(const FeedReceiver&) = delete;
+    FeedReceiver& operator=(const FeedReceiver&) = delete;
+
+    /**
+     * @brief Receives all ready datagrams into queue without blocking.
+     * @return Number of updates committed to the queue.
+     * @throws std::runtime_error on socket or ring failure.
+     */
+    virtual size_t poll(LockFreeQueue& queue) = 0;
+
+    virtual FeedBackend backend() const noexcept = 0;
+
+    const ReceiverStats& stats() const noexcept { return decoder_.stats(); }
+
+    /**
+     * @brief Skips updates the filter rejects before they take a queue slot (see FeedDecoder).
+     */
+    void setFilter(const SubscriptionFilter* filter) noexcept { decoder_.setFilter(filter); }
+
+    /**
+     * @brief Port the socket is bound to (resolves an ephemeral port request).
+     */
+    uint16_t port() const noexcept { return port_; }
+
+protected:
+    /**
+     * @brief Opens, configures and binds the UDP socket.
+     * @throws std::runtime_error if the socket cannot be bound or the group joined.
+     */
+    explicit FeedReceiver(const FeedEndpoint& endpoint);
+
+    /**
+     * @brief Decodes one datagram into the queue, stamping updates with the receive time.
+     * Updates that find the queue full are dropped.
+     * @return Number of updates committed.
+     */
+    size_t deliver(const uint8_t* data, size_t size, uint64_t receive_time, LockFreeQueue& queue) {
+        return decoder_.decode(data, size, receive_time, queue, [] { return false; });
+    }
+
+    int fd_ = -1;          ///< Non-blocking UDP socket.
+    uint16_t port_ = 0;    ///< Bound port.
+    FeedDecoder decoder_;  ///< Datagram decoder and receive counters.
+};
+
+/**
+ * @brief Creates a receiver for the given backend.
+ * @throws std::runtime_error if the socket cannot be set up or the backend is unavailable
+ * (io_uring needs provided buffer rings, Linux 5.19+).
+ */
+std::unique_ptr<FeedReceiver> makeFeedReceiver(FeedBackend backend, const FeedEndpoint& endpoint);
@@ -0,0 +1,43 @@
+#pragma once
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief Writes the whole buffer to fd, retrying on short writes and EINTR.
+ * @throws std::runtime_error if the write fails.
+ */
+inline void writeAll(int fd, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t written = ::write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("write failed: errno " + std::to_string(errno));
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+/**
+ * @brief Makes a fully written temporary file durable and atomically moves it over target.
+ * @param fd Open descriptor of the temporary file; closed by this call.
+ * @param tmp_path Path of the temporary file.
+ * @param target_path Final path.
+ * @throws std::runtime_error if syncing or renaming fails.
+ */
+inline void commitFile(int fd, const std::string& tmp_path, const std::string& target_path) {
+    if (::fdatasync(fd) != 0) {
+        ::close(fd);
+        throw std::runtime_error("fdatasync failed for " + tmp_path);
+    }
+    ::close(fd);
+    if (::rename(tmp_path.c_str(), target_path.c_str()) != 0) {
+        throw std::runtime_error("rename failed for " + target_path);
+    }
+}
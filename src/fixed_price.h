@@ -0,0 +1,121 @@
+#pragma once
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/// Fixed-point price: an integer count of 10^-kPriceDecimals units.
+using FixedPrice = int64_t;
+
+inline constexpr int kPriceDecimals = 8;               ///< Decimal places carried by FixedPrice.
+inline constexpr int64_t kPriceScale = 100'000'000;    ///< 10^kPriceDecimals.
+
+/**
+ * @brief Converts a fixed-point price to double.
+ *
+ * Both operands are exact and IEEE division rounds correctly, so for prices below 2^53 units
+ * (~90 million) the result is the double nearest the decimal text, exactly what strtod returns.
+ */
+inline double toDouble(FixedPrice price) noexcept {
+    return static_cast<double>(price) / static_cast<double>(kPriceScale);
+}
+
+/**
+ * @brief Rounds a double price to the nearest fixed-point unit.
+ */
+inline FixedPrice fromDouble(double price) noexcept {
+    return static_cast<FixedPrice>(std::llround(price * static_cast<double>(kPriceScale)));
+}
+
+namespace fixed_price_detail {
+
+/**
+ * @brief Loads up to 8 bytes from [p, end) little-endian, zero-filling past end.
+ * Zero bytes are not digits, so a number is always terminated by the end of the buffer.
+ */
+inline uint64_t load8(const char* p, const char* end) noexcept {
+    uint64_t word = 0;
+    size_t available = static_cast<size_t>(end - p);
+    if (available >= 8) {
+        std::memcpy(&word, p, 8); // Constant size: a single unaligned load
+    } else {
+        std::memcpy(&word, p, available);
+    }
+    return word;
+}
+
+/**
+ * @brief Counts the leading ASCII digits of a loaded word (0..8), testing all 8 bytes at once.
+ *
+ * A byte is a digit iff its high nibble is 3 and adding 6 does not carry it out of that nibble.
+ */
+inline unsigned leadingDigits(uint64_t word) noexcept {
+    uint64_t tag = (word & 0xF0F0F0F0F0F0F0F0ULL) | (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4);
+    uint64_t non_digits = tag ^ 0x3333333333333333ULL;
+    return non_digits == 0 ? 8 : static_cast<unsigned>(std::countr_zero(non_digits)) / 8;
+}
+
+/**
+ * @brief Converts 8 digit values (byte i holds digit i, most significant first) to an integer.
+ *
+ * Three multiply-add steps combine pairs, then quads, then the two halves (Lemire's SWAR method).
+ */
+inline uint64_t combineDigits(uint64_t digits) noexcept {
+    digits = (digits * 10) + (digits >> 8);
+    digits = (((digits & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+              (((digits >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return digits;
+}
+
+/// Keeps the low `bytes` bytes of a word (bytes in 0..8).
+inline uint64_t lowBytes(uint64_t word, unsigned bytes) noexcept {
+    uint64_t mask = bytes >= 8 ? ~0ULL : (1ULL << (8 * bytes)) - 1;
+    return word & mask;
+}
+
+} // namespace fixed_price_detail
+
+/**
+ * @brief Parses an ASCII decimal price ("150.25", "-0.5", "2750", ".75") into fixed point.
+ * @param begin First character of the price.
+ * @param end End of the buffer; the parser never reads at or past it.
+ * @param out Receives the price in units of 10^-kPriceDecimals.
+ * @return Pointer past the last character consumed, or nullptr if there are no digits or more
+ * than 8 integer digits. Decimals beyond the eighth are consumed and truncated.
+ *
+ * The integer and fractional parts are each loaded as one 64-bit word; digits are found with a
+ * SWAR byte test and converted 8 at a time, so the number of decimal places changes a shift and
+ * a mask, never the number of branches taken.
+ */
+inline const char* parsePrice(const char* begin, const char* end, FixedPrice& out) noexcept {
+    using namespace fixed_price_detail;
+    if (begin >= end) return nullptr;
+    const bool negative = *begin == '-';
+    const char* p = begin + negative;
+
+    // Integer part: right-align its digits so the zero-filled low bytes read as leading zeros.
+    uint64_t word = load8(p, end);
+    unsigned int_digits = leadingDigits(word);
+    uint64_t digits = lowBytes(word - 0x3030303030303030ULL, int_digits);
+    uint64_t integer = int_digits == 0 ? 0 : combineDigits(digits << (8 * (8 - int_digits)));
+    p += int_digits;
+    if (int_digits == 8 && p < end && static_cast<unsigned char>(*p - '0') < 10) return nullptr;
+
+    // Fraction: left-aligned, so missing decimals are trailing zeros and the scale is implicit.
+    uint64_t fraction = 0;
+    unsigned frac_digits = 0;
+    if (p < end && *p == '.') {
+        ++p;
+        word = load8(p, end);
+        frac_digits = leadingDigits(word);
+        fraction = combineDigits(lowBytes(word - 0x3030303030303030ULL, frac_digits));
+        p += frac_digits;
+        while (frac_digits == 8 && p < end && static_cast<unsigned char>(*p - '0') < 10) ++p; // Truncated
+    }
+    if (int_digits + frac_digits == 0) return nullptr;
+
+    auto value = static_cast<FixedPrice>(integer * kPriceScale + fraction);
+    out = negative ? -value : value;
+    return p;
+}
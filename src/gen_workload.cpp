@@ -0,0 +1,140 @@
+#include "pcap_writer.h"
+#include "symbol_directory.h"
+#include "wire_format.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Generates a replay workload in the data/ file format ("SYMBOL,price,volume").
+ *
+ * Usage: gen_workload <template.txt> <output.txt|output.pcap|output.pcapng> [messages] [symbols]
+ *
+ * Symbols, prices and volumes from the template seed a universe of `symbols` instruments
+ * (template tickers first, then synthetic ones priced off them). Messages follow a skewed
+ * (Zipf-like) symbol mix with random-walk prices and a varying number of decimal places,
+ * approximating a real feed's message mix. A fixed seed keeps the workload reproducible,
+ * which profile-guided optimisation builds rely on.
+ *
+ * With a .pcap/.pcapng output the same messages are packed 1-8 per binary feed datagram
+ * (wire_format.h) and written as a VLAN-tagged capture of multicast group 239.1.1.1:30001, with
+ * interleaved datagrams of a second feed on 239.1.1.2:30002 for filters to skip.
+ */
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "usage: gen_workload <template.txt> <output.txt|output.pcap|output.pcapng> [messages] [symbols]\n";
+        return 1;
+    }
+    const size_t messages = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 2'000'000;
+    const size_t symbols = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 500;
+
+    struct Instrument {
+        std::string symbol;
+        double price;
+        int volume;
+    };
+    std::vector<Instrument> templates;
+    std::ifstream in(argv[1]);
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        Instrument inst;
+        std::string price, volume;
+        if (std::getline(fields, inst.symbol, ',') && std::getline(fields, price, ',') &&
+            std::getline(fields, volume)) {
+            inst.price = std::strtod(price.c_str(), nullptr);
+            inst.volume = std::atoi(volume.c_str());
+            templates.push_back(inst);
+        }
+    }
+    if (templates.empty()) {
+        std::cerr << "gen_workload: no records in " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::vector<Instrument> universe(templates);
+    for (size_t i = universe.size(); i < symbols; ++i) {
+        const Instrument& base = templates[i % templates.size()];
+        char ticker[24]; // Room for any size_t, so snprintf never truncates
+        std::snprintf(ticker, sizeof(ticker), "S%04zu", i);
+        universe.push_back({ticker, base.price * (0.5 + static_cast<double>(i % 97) / 97.0), base.volume});
+    }
+
+    // Zipf-like weights: a few symbols dominate traffic, as on real feeds.
+    std::vector<double> weights(universe.size());
+    for (size_t i = 0; i < weights.size(); ++i) weights[i] = 1.0 / static_cast<double>(i + 1);
+    std::mt19937_64 rng(42);
+    std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+    std::normal_distribution<double> step(0.0, 0.0005);
+    std::uniform_int_distribution<int> decimals(0, 9);
+
+    auto next_message = [&](Instrument*& inst, int& volume, int& places) {
+        inst = &universe[pick(rng)];
+        inst->price = std::max(0.01, inst->price * (1.0 + step(rng)));
+        volume = std::max(1, inst->volume / 2 + static_cast<int>(rng() % static_cast<uint64_t>(inst->volume + 1)));
+        // Mostly 2 decimal places, sometimes 1, 3 or 4, like the mixed precision in data/.
+        places = decimals(rng);
+        places = places < 6 ? 2 : places < 8 ? 1 : places < 9 ? 3 : 4;
+    };
+
+    const std::string output = argv[2];
+    auto ends_with = [&](const std::string& suffix) {
+        return output.size() >= suffix.size() && output.compare(output.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    if (ends_with(".pcap") || ends_with(".pcapng")) {
+        constexpr uint32_t kFeedGroup = 0xef010101;  // 239.1.1.1
+        constexpr uint32_t kOtherGroup = 0xef010102; // 239.1.1.2
+        constexpr uint32_t kSource = 0x0a000001;     // 10.0.0.1
+        try {
+            PcapWriter capture(output, ends_with(".pcapng") ? CaptureFormat::PcapNg : CaptureFormat::Pcap);
+            uint64_t timestamp_ns = 1'699'954'200ULL * 1'000'000'000ULL; // 2023-11-14 09:30 UTC
+            uint64_t sequence = 0;
+            uint8_t packet[kMaxDatagramSize];
+            WireUpdate updates[8];
+            for (size_t n = 0; n < messages;) {
+                size_t count = std::min<size_t>(1 + rng() % 8, messages - n);
+                for (size_t i = 0; i < count; ++i) {
+                    Instrument* inst;
+                    int volume, places;
+                    next_message(inst, volume, places);
+                    double scale = std::pow(10.0, places);
+                    updates[i] = WireUpdate{packTicker(inst->symbol), std::round(inst->price * scale) / scale,
+                                            volume, 0};
+                }
+                n += count;
+                timestamp_ns += 500 + rng() % 3000;
+                size_t size = encodeDatagram(packet, ++sequence, timestamp_ns, updates, count);
+                capture.writeUdp(timestamp_ns, kSource, kFeedGroup, 40000, 30001, packet, size, 100);
+                if (sequence % 10 == 0) {
+                    capture.writeUdp(timestamp_ns + 1, kSource, kOtherGroup, 40000, 30002, packet, size, 100);
+                }
+            }
+            capture.close();
+        } catch (const std::exception& e) {
+            std::cerr << "gen_workload: " << e.what() << "\n";
+            return 1;
+        }
+    } else {
+        FILE* out = std::fopen(argv[2], "w");
+        if (!out) {
+            std::cerr << "gen_workload: cannot write " << argv[2] << "\n";
+            return 1;
+        }
+        for (size_t n = 0; n < messages; ++n) {
+            Instrument* inst;
+            int volume, places;
+            next_message(inst, volume, places);
+            std::fprintf(out, "%s,%.*f,%d\n", inst->symbol.c_str(), places, inst->price, volume);
+        }
+        std::fclose(out);
+    }
+    std::cout << "Wrote " << messages << " messages over " << universe.size() << " symbols to " << argv[2] << "\n";
+    return 0;
+}
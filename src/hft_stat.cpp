@@ -0,0 +1,95 @@
+#include "metrics.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+/**
+ * @brief Returns the upper bound in ns of the histogram bucket containing the given percentile.
+ */
+uint64_t percentile(const uint64_t (&buckets)[kLatencyBuckets], uint64_t total, double pct) {
+    if (total == 0) return 0;
+    uint64_t target = static_cast<uint64_t>(static_cast<double>(total) * pct / 100.0);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kLatencyBuckets; ++i) {
+        seen += buckets[i];
+        if (seen > target) return (uint64_t{1} << i) - 1;
+    }
+    return (uint64_t{1} << (kLatencyBuckets - 1)) - 1;
+}
+
+/**
+ * @brief Parses a whole decimal argument, or returns false.
+ */
+bool parseLong(const char* text, long& value) {
+    char* end = nullptr;
+    errno = 0;
+    value = std::strtol(text, &end, 10);
+    return end != text && *end == '\0' && errno == 0;
+}
+
+} // namespace
+
+/**
+ * @brief Attaches read-only to a running hft_system's metrics segment and prints live values.
+ *
+ * Usage: hft_stat [interval_ms] [samples]. The interval must be positive; with samples == 0
+ * (default) it runs until killed.
+ * Queue depth is derived as pushed - processed, so the hot threads never maintain it.
+ */
+int main(int argc, char** argv) {
+    long interval_ms = 1000;
+    long samples = 0;
+    if ((argc > 1 && (!parseLong(argv[1], interval_ms) || interval_ms <= 0)) ||
+        (argc > 2 && (!parseLong(argv[2], samples) || samples < 0))) {
+        std::cerr << "Usage: hft_stat [interval_ms > 0] [samples >= 0]\n";
+        return 1;
+    }
+
+    try {
+        MetricsReader reader;
+        const MetricsSegment& m = reader.segment();
+        std::cout << "Attached to hft_system pid " << m.header.pid
+                  << ", queue capacity " << m.header.queue_capacity << "\n";
+        std::cout << std::setw(12) << "pushed" << std::setw(12) << "processed" << std::setw(8) << "depth"
+                  << std::setw(12) << "push/s" << std::setw(12) << "proc/s" << std::setw(10) << "full"
+                  << std::setw(10) << "filtered"
+                  << std::setw(14) << "empty_polls" << std::setw(10) << "p50(ns)" << std::setw(10) << "p99(ns)"
+                  << std::setw(11) << "p99.9(ns)" << "\n";
+
+        uint64_t last_pushed = m.producer.messages_pushed.load(std::memory_order_relaxed);
+        uint64_t last_processed = m.consumer.messages_processed.load(std::memory_order_relaxed);
+        for (long n = 0; samples == 0 || n < samples; ++n) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+            uint64_t pushed = m.producer.messages_pushed.load(std::memory_order_relaxed);
+            uint64_t processed = m.consumer.messages_processed.load(std::memory_order_relaxed);
+            uint64_t buckets[kLatencyBuckets];
+            uint64_t total = 0;
+            for (size_t i = 0; i < kLatencyBuckets; ++i) {
+                buckets[i] = m.consumer.latency_buckets[i].load(std::memory_order_relaxed);
+                total += buckets[i];
+            }
+            double seconds = static_cast<double>(interval_ms) / 1000.0;
+            std::cout << std::setw(12) << pushed << std::setw(12) << processed
+                      << std::setw(8) << (pushed > processed ? pushed - processed : 0)
+                      << std::setw(12) << static_cast<uint64_t>((pushed - last_pushed) / seconds)
+                      << std::setw(12) << static_cast<uint64_t>((processed - last_processed) / seconds)
+                      << std::setw(10) << m.producer.queue_full_retries.load(std::memory_order_relaxed)
+                      << std::setw(10) << m.producer.messages_filtered.load(std::memory_order_relaxed)
+                      << std::setw(14) << m.consumer.empty_polls.load(std::memory_order_relaxed)
+                      << std::setw(10) << percentile(buckets, total, 50.0)
+                      << std::setw(10) << percentile(buckets, total, 99.0)
+                      << std::setw(11) << percentile(buckets, total, 99.9) << "\n";
+            last_pushed = pushed;
+            last_processed = processed;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "hft_stat: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,281 @@
+#include "pcap_reader.h"
+#include "radix_sort.h"
+#include "tick_scan.h"
+#include "tick_store.h"
+#include "wire_format.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t kNanosPerSecond = 1'000'000'000;
+constexpr uint64_t kNanosPerDay = 86'400 * kNanosPerSecond;
+
+/**
+ * @brief Parses a query bound: nanoseconds since the epoch, or HH:MM[:SS[.fff]] (UTC) on the
+ * day of day_start_ns.
+ */
+std::optional<uint64_t> parseTime(const std::string& text, uint64_t day_start_ns) {
+    if (text.find(':') == std::string::npos) {
+        char* end = nullptr;
+        uint64_t value = std::strtoull(text.c_str(), &end, 10);
+        if (end == text.c_str() || *end != '\0') return std::nullopt;
+        return value;
+    }
+    unsigned hours = 0, minutes = 0;
+    double seconds = 0;
+    int fields = std::sscanf(text.c_str(), "%u:%u:%lf", &hours, &minutes, &seconds);
+    if (fields < 2 || hours > 23 || minutes > 59 || seconds < 0 || seconds >= 61) return std::nullopt;
+    return day_start_ns + (hours * 3600ULL + minutes * 60ULL) * kNanosPerSecond +
+           static_cast<uint64_t>(seconds * static_cast<double>(kNanosPerSecond));
+}
+
+std::string formatTime(uint64_t ns) {
+    uint64_t in_day = ns % kNanosPerDay;
+    char text[32];
+    std::snprintf(text, sizeof(text), "%02llu:%02llu:%02llu.%09llu",
+                  static_cast<unsigned long long>(in_day / (3600 * kNanosPerSecond)),
+                  static_cast<unsigned long long>(in_day / (60 * kNanosPerSecond) % 60),
+                  static_cast<unsigned long long>(in_day / kNanosPerSecond % 60),
+                  static_cast<unsigned long long>(in_day % kNanosPerSecond));
+    return text;
+}
+
+int build(const std::string& capture_paths, const std::string& store_path, const std::string& filter_text,
+          const std::string& encoding_text) {
+    std::optional<CaptureFilter> filter = CaptureFilter::parse(filter_text);
+    if (!filter) {
+        std::cerr << "Invalid capture filter: " << filter_text << " (expected group:port, group or :port)\n";
+        return 1;
+    }
+    if (encoding_text != "delta" && encoding_text != "raw") {
+        std::cerr << "Invalid encoding: " << encoding_text << " (expected delta or raw)\n";
+        return 1;
+    }
+    // Captures of several lines, or with late recovery data, are not in time order: collect every
+    // tick, then sort by (capture time, datagram sequence) before writing. The sort is stable, so
+    // updates of one datagram keep their order.
+    struct CapturedTick {
+        uint64_t timestamp;
+        uint64_t sequence;
+        uint64_t ticker;
+        FixedPrice price;
+        int32_t volume;
+    };
+    auto start = std::chrono::steady_clock::now();
+    std::vector<CapturedTick> ticks;
+    uint64_t datagrams = 0, malformed = 0;
+    for (size_t begin = 0; begin <= capture_paths.size();) {
+        size_t end = std::min(capture_paths.find(',', begin), capture_paths.size());
+        PcapReader reader(capture_paths.substr(begin, end - begin));
+        datagrams += reader.forEachUdp(*filter, [&](const UdpDatagram& datagram) {
+            // Datagrams with an empty ticker count as malformed, so append() never sees one.
+            bool valid = decodeDatagram(datagram.payload, datagram.size, [&](const WireHeader& header, const WireUpdate& update) {
+                ticks.push_back({datagram.timestamp_ns, header.sequence, update.ticker, fromDouble(update.price), update.volume});
+            });
+            malformed += !valid;
+        }).matched;
+        begin = end + 1;
+    }
+    auto decoded = std::chrono::steady_clock::now();
+    radixSort(std::span<CapturedTick>(ticks), 0, [](const CapturedTick& t) { return t.timestamp; },
+              [](const CapturedTick& t) { return t.sequence; });
+    auto sorted = std::chrono::steady_clock::now();
+
+    TickStoreWriter writer(store_path, encoding_text == "raw" ? TickEncoding::Raw : TickEncoding::Delta);
+    for (const CapturedTick& tick : ticks) writer.append(tick.ticker, tick.timestamp, tick.price, tick.volume);
+    writer.close();
+    auto ms = [](auto from, auto to) { return std::chrono::duration<double, std::milli>(to - from).count(); };
+    std::cout << "Stored " << writer.tickCount() << " ticks from " << datagrams << " datagrams (" << malformed
+              << " malformed): decode " << ms(start, decoded) << " ms, sort " << ms(decoded, sorted) << " ms, write "
+              << ms(sorted, std::chrono::steady_clock::now()) << " ms\n";
+    return 0;
+}
+
+int info(const std::string& store_path) {
+    TickStoreReader store(store_path);
+    const TickStoreTrailer& trailer = store.trailer();
+    std::cout << trailer.tick_count << " ticks, " << trailer.symbol_count << " symbols, " << trailer.block_count
+              << " blocks of up to " << trailer.block_ticks << " ticks, "
+              << (trailer.encoding == TickEncoding::Delta ? "delta" : "raw") << " encoding, "
+              << (trailer.tick_count > 0 ? static_cast<double>(trailer.file_size) / static_cast<double>(trailer.tick_count) : 0.0)
+              << " bytes/tick\n";
+    std::cout << std::left << std::setw(10) << "symbol" << std::right << std::setw(12) << "ticks" << std::setw(8)
+              << "blocks" << std::setw(20) << "first" << std::setw(20) << "last" << "\n";
+    for (const TickSymbolEntry& symbol : store.symbols()) {
+        std::cout << std::left << std::setw(10) << unpackTicker(symbol.ticker) << std::right << std::setw(12)
+                  << symbol.tick_count << std::setw(8) << symbol.block_count << std::setw(20)
+                  << formatTime(symbol.first_timestamp) << std::setw(20) << formatTime(symbol.last_timestamp) << "\n";
+    }
+    return 0;
+}
+
+int query(const std::string& store_path, const std::string& ticker, const std::string& from_text,
+          const std::string& to_text) {
+    TickStoreReader store(store_path);
+    const TickSymbolEntry* symbol = store.findSymbol(ticker);
+    if (!symbol) {
+        std::cout << ticker << ": no ticks\n";
+        return 0;
+    }
+    uint64_t day_start = symbol->first_timestamp - symbol->first_timestamp % kNanosPerDay;
+    std::optional<uint64_t> from = parseTime(from_text, day_start);
+    std::optional<uint64_t> to = parseTime(to_text, day_start);
+    if (!from || !to) {
+        std::cerr << "Invalid time (expected nanoseconds or HH:MM[:SS[.fff]])\n";
+        return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
+    FixedPrice low = INT64_MAX, high = INT64_MIN;
+    double notional = 0;
+    int64_t volume = 0;
+    uint64_t first = 0, last = 0;
+    uint64_t count = store.query(*symbol, *from, *to, [&](const TickColumns& run) {
+        if (first == 0) first = run.timestamps[0];
+        last = run.timestamps[run.count - 1];
+        for (size_t i = 0; i < run.count; ++i) {
+            low = std::min(low, run.prices[i]);
+            high = std::max(high, run.prices[i]);
+            notional += toDouble(run.prices[i]) * run.volumes[i];
+            volume += run.volumes[i];
+        }
+    });
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << ticker << " " << formatTime(*from) << " - " << formatTime(*to) << ": " << count << " ticks";
+    if (count > 0) {
+        std::cout << ", " << formatTime(first) << " - " << formatTime(last) << ", low " << toDouble(low) << ", high "
+                  << toDouble(high) << ", volume " << volume << ", VWAP " << (volume > 0 ? notional / volume : 0.0);
+    }
+    std::cout << " (" << elapsed * 1e6 << " us)\n";
+    return 0;
+}
+
+/**
+ * @brief Parses a whole-string decimal price into price.
+ */
+bool parsePriceText(const std::string& text, FixedPrice& price) {
+    const char* end = text.data() + text.size();
+    return parsePrice(text.data(), end, price) == end;
+}
+
+int scan(const std::string& store_path, const std::string& symbols_text, const std::string& from_text,
+         const std::string& to_text, const std::vector<std::string>& bounds) {
+    TickStoreReader store(store_path);
+    std::vector<std::string> names;
+    std::vector<std::vector<uint64_t>> groups;
+    if (symbols_text == "all") {
+        for (const TickSymbolEntry& symbol : store.symbols()) {
+            names.push_back(unpackTicker(symbol.ticker));
+            groups.push_back({symbol.ticker});
+        }
+    } else {
+        std::istringstream list(symbols_text);
+        for (std::string name; std::getline(list, name, ',');) {
+            if (name.empty()) continue;
+            names.push_back(name);
+            groups.push_back({packTicker(name)});
+        }
+    }
+    if (store.symbols().empty()) {
+        std::cout << "no ticks\n";
+        return 0;
+    }
+
+    TickFilter filter;
+    uint64_t first_timestamp = store.symbols().front().first_timestamp;
+    uint64_t day_start = first_timestamp - first_timestamp % kNanosPerDay;
+    std::optional<uint64_t> from = parseTime(from_text, day_start);
+    std::optional<uint64_t> to = parseTime(to_text, day_start);
+    if (!from || !to) {
+        std::cerr << "Invalid time (expected nanoseconds or HH:MM[:SS[.fff]])\n";
+        return 1;
+    }
+    filter.from = *from;
+    filter.to = *to;
+    if (bounds.size() >= 2 && (!parsePriceText(bounds[0], filter.min_price) || !parsePriceText(bounds[1], filter.max_price))) {
+        std::cerr << "Invalid price bound (expected a decimal price)\n";
+        return 1;
+    }
+    if (bounds.size() >= 3) {
+        char* end = nullptr;
+        long volume = std::strtol(bounds[2].c_str(), &end, 10);
+        if (end == bounds[2].c_str() || *end != '\0' || volume < 0 || volume > INT32_MAX) {
+            std::cerr << "Invalid minimum volume: " << bounds[2] << "\n";
+            return 1;
+        }
+        filter.min_volume = static_cast<int32_t>(volume);
+    }
+
+    ThreadPool pool;
+    TickScanner scanner(store, pool);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<TickAggregate> results = scanner.scan(groups, filter);
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << std::left << std::setw(10) << "SYMBOL" << std::right << std::setw(12) << "TICKS" << std::setw(14)
+              << "VOLUME" << std::setw(14) << "LOW" << std::setw(14) << "HIGH" << std::setw(14) << "VWAP" << "\n";
+    for (size_t group = 0; group < groups.size(); ++group) {
+        const TickAggregate& result = results[group];
+        std::cout << std::left << std::setw(10) << names[group] << std::right << std::setw(12) << result.count
+                  << std::setw(14) << result.volume;
+        if (result.count > 0) {
+            std::cout << std::setw(14) << toDouble(result.min_price) << std::setw(14) << toDouble(result.max_price)
+                      << std::setw(14) << result.vwap();
+        }
+        std::cout << "\n";
+    }
+    std::cout << scanner.scannedTicks() << " ticks scanned on " << pool.size() << " threads ("
+              << isaName(simd().level) << ") in " << elapsed * 1e3 << " ms\n";
+    return 0;
+}
+
+} // namespace
+
+/**
+ * @brief Builds and queries columnar tick stores (tick_store.h).
+ *
+ * Usage:
+ *   hft_ticks build <capture>[,<capture>...] <store> [group:port] [delta|raw]
+ *                                                                decode feed captures (pcap/pcapng),
+ *                                                                merged in time order, into a store
+ *                                                                (delta-encoded unless raw is given)
+ *   hft_ticks info <store>                                       per-symbol counts and time ranges
+ *   hft_ticks query <store> <SYMBOL> <from> <to>                 ticks with from <= time <= to
+ *   hft_ticks scan <store> <SYMBOL[,SYMBOL...]|all> <from> <to> [min_price max_price [min_volume]]
+ *                                                                filtered per-symbol aggregates,
+ *                                                                scanned in parallel
+ * Times are nanoseconds since the epoch or HH:MM[:SS[.fff]] (UTC) on the symbol's first day (for
+ * scan, the first symbol's).
+ */
+int main(int argc, char** argv) {
+    try {
+        if (argc >= 4 && argc <= 6 && std::strcmp(argv[1], "build") == 0) {
+            // The filter is optional, so a lone fifth argument may be the encoding.
+            const bool encoding_only = argc == 5 && (std::strcmp(argv[4], "delta") == 0 || std::strcmp(argv[4], "raw") == 0);
+            const char* filter = argc >= 5 && !encoding_only ? argv[4] : "";
+            const char* encoding = argc == 6 ? argv[5] : encoding_only ? argv[4] : "delta";
+            return build(argv[2], argv[3], filter, encoding);
+        }
+        if (argc == 3 && std::strcmp(argv[1], "info") == 0) return info(argv[2]);
+        if (argc == 6 && std::strcmp(argv[1], "query") == 0) return query(argv[2], argv[3], argv[4], argv[5]);
+        if ((argc == 6 || argc == 8 || argc == 9) && std::strcmp(argv[1], "scan") == 0) {
+            return scan(argv[2], argv[3], argv[4], argv[5], std::vector<std::string>(argv + 6, argv + argc));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "hft_ticks: " << e.what() << "\n";
+        return 1;
+    }
+    std::cerr << "usage: hft_ticks build <capture>[,<capture>...] <store> [group:port] [delta|raw]\n"
+                 "       hft_ticks info <store>\n"
+                 "       hft_ticks query <store> <SYMBOL> <from> <to>\n"
+                 "       hft_ticks scan <store> <SYMBOL[,SYMBOL...]|all> <from> <to> [min_price max_price [min_volume]]\n";
+    return 1;
+}
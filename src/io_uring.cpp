@@ -0,0 +1,162 @@
+#include "io_uring.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int fd, unsigned opcode, const void* arg, unsigned nr_args) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template <typename T>
+T* offsetPtr(void* base, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<uint8_t*>(base) + offset);
+}
+
+} // namespace
+
+/**
+ * @brief Sets up the ring and maps its queues, following the io_uring_setup(2) layout.
+ */
+IoUring::IoUring(unsigned entries, unsigned flags, unsigned cq_entries) {
+    io_uring_params params{};
+    params.flags = flags;
+    if (cq_entries > 0) {
+        params.flags |= IORING_SETUP_CQSIZE;
+        params.cq_entries = cq_entries;
+    }
+    fd_ = ioUringSetup(entries, &params);
+    if (fd_ < 0) throw std::system_error(errno, std::system_category(), "io_uring_setup");
+
+    sq_map_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_map_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) sq_map_size_ = cq_map_size_ = std::max(sq_map_size_, cq_map_size_);
+
+    sq_map_ = ::mmap(nullptr, sq_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                     IORING_OFF_SQ_RING);
+    if (sq_map_ == MAP_FAILED) {
+        int err = errno;
+        ::close(fd_);
+        throw std::system_error(err, std::system_category(), "mmap io_uring SQ");
+    }
+    cq_map_ = sq_map_;
+    if (!single_mmap) {
+        cq_map_ = ::mmap(nullptr, cq_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                         IORING_OFF_CQ_RING);
+        if (cq_map_ == MAP_FAILED) {
+            int err = errno;
+            ::munmap(sq_map_, sq_map_size_);
+            ::close(fd_);
+            throw std::system_error(err, std::system_category(), "mmap io_uring CQ");
+        }
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                        IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        int err = errno;
+        if (cq_map_ != sq_map_) ::munmap(cq_map_, cq_map_size_);
+        ::munmap(sq_map_, sq_map_size_);
+        ::close(fd_);
+        throw std::system_error(err, std::system_category(), "mmap io_uring SQEs");
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    sq_head_ = offsetPtr<unsigned>(sq_map_, params.sq_off.head);
+    sq_tail_ = offsetPtr<unsigned>(sq_map_, params.sq_off.tail);
+    sq_array_ = offsetPtr<unsigned>(sq_map_, params.sq_off.array);
+    sq_flags_ = offsetPtr<unsigned>(sq_map_, params.sq_off.flags);
+    sq_mask_ = *offsetPtr<unsigned>(sq_map_, params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    sqe_tail_ = *sq_tail_;
+
+    cq_head_ = offsetPtr<unsigned>(cq_map_, params.cq_off.head);
+    cq_tail_ = offsetPtr<unsigned>(cq_map_, params.cq_off.tail);
+    cqes_ = offsetPtr<io_uring_cqe>(cq_map_, params.cq_off.cqes);
+    cq_mask_ = *offsetPtr<unsigned>(cq_map_, params.cq_off.ring_mask);
+}
+
+IoUring::~IoUring() {
+    ::munmap(sqes_, sqes_size_);
+    if (cq_map_ != sq_map_) ::munmap(cq_map_, cq_map_size_);
+    ::munmap(sq_map_, sq_map_size_);
+    ::close(fd_);
+}
+
+bool IoUring::supported() noexcept {
+    static const bool available = [] {
+        io_uring_params params{};
+        int fd = ioUringSetup(2, &params);
+        if (fd < 0) return false;
+        ::close(fd);
+        return true;
+    }();
+    return available;
+}
+
+io_uring_sqe* IoUring::getSqe() noexcept {
+    unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (sqe_tail_ - head >= sq_entries_) return nullptr;
+    io_uring_sqe* sqe = &sqes_[sqe_tail_ & sq_mask_];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sq_array_[sqe_tail_ & sq_mask_] = sqe_tail_ & sq_mask_;
+    ++sqe_tail_;
+    return sqe;
+}
+
+unsigned IoUring::submit(unsigned wait_for) {
+    unsigned to_submit = sqe_tail_ - *sq_tail_;
+    // Release so the kernel sees fully written SQEs before the new tail.
+    __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+    if (to_submit == 0 && wait_for == 0) return 0;
+    unsigned flags = wait_for > 0 ? IORING_ENTER_GETEVENTS : 0;
+    for (;;) {
+        int ret = ioUringEnter(fd_, to_submit, wait_for, flags);
+        if (ret >= 0) return static_cast<unsigned>(ret);
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EBUSY) return 0;
+        throw std::system_error(errno, std::system_category(), "io_uring_enter");
+    }
+}
+
+io_uring_cqe* IoUring::peekCqe() noexcept {
+    unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) return nullptr;
+    return &cqes_[head & cq_mask_];
+}
+
+void IoUring::cqeSeen() noexcept {
+    __atomic_store_n(cq_head_, *cq_head_ + 1, __ATOMIC_RELEASE);
+}
+
+void IoUring::flushOverflow() {
+    while (ioUringEnter(fd_, 0, 0, IORING_ENTER_GETEVENTS) < 0) {
+        if (errno != EINTR) throw std::system_error(errno, std::system_category(), "io_uring_enter");
+    }
+}
+
+bool IoUring::registerBuffers(const iovec* buffers, unsigned count) noexcept {
+    return ioUringRegister(fd_, IORING_REGISTER_BUFFERS, buffers, count) == 0;
+}
+
+bool IoUring::registerBufferRing(io_uring_buf_ring* ring, unsigned entries, uint16_t group) noexcept {
+    io_uring_buf_reg reg{};
+    reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+    reg.ring_entries = entries;
+    reg.bgid = group;
+    return ioUringRegister(fd_, IORING_REGISTER_PBUF_RING, &reg, 1) == 0;
+}
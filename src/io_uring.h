@@ -0,0 +1,112 @@
+#pragma once
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Minimal dependency-free io_uring instance built on the raw system calls.
+ *
+ * Wraps ring setup, the mmapped submission/completion queues and buffer registration, which is
+ * all the async writer and the feed receiver need; no liburing required. Not thread-safe: one thread owns the ring.
+ */
+class IoUring {
+public:
+    /**
+     * @brief Creates a ring with at least `entries` submission slots.
+     * @param entries Submission queue size (rounded up to a power of two by the kernel).
+     * @param flags IORING_SETUP_* flags.
+     * @param cq_entries Completion queue size; 0 keeps the kernel default of twice `entries`.
+     * @throws std::system_error if io_uring is unavailable or setup fails.
+     */
+    explicit IoUring(unsigned entries, unsigned flags = 0, unsigned cq_entries = 0);
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    /**
+     * @brief True if the running kernel permits io_uring (probed once).
+     */
+    static bool supported() noexcept;
+
+    /**
+     * @brief Returns a zeroed submission entry, or nullptr if the submission queue is full.
+     *
+     * The entry is queued locally and handed to the kernel by the next submit().
+     */
+    io_uring_sqe* getSqe() noexcept;
+
+    /**
+     * @brief Publishes queued entries and optionally waits for completions with one io_uring_enter.
+     * @param wait_for Number of completions to wait for (0 = don't block).
+     * @return Number of entries submitted.
+     * @throws std::system_error on failure other than EINTR/EAGAIN/EBUSY.
+     */
+    unsigned submit(unsigned wait_for = 0);
+
+    /**
+     * @brief Returns the oldest unconsumed completion, or nullptr if none is ready.
+     */
+    io_uring_cqe* peekCqe() noexcept;
+
+    /**
+     * @brief Marks the completion returned by peekCqe() as consumed.
+     */
+    void cqeSeen() noexcept;
+
+    /**
+     * @brief True if completions overflowed the CQ and are parked in the kernel.
+     *
+     * Parked completions only reappear after an io_uring_enter (flushOverflow()); a poller that
+     * never enters the kernel must check this when the CQ looks empty.
+     */
+    bool cqOverflowed() const noexcept {
+        return __atomic_load_n(sq_flags_, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW;
+    }
+
+    /**
+     * @brief Enters the kernel to move parked completions back into the CQ.
+     */
+    void flushOverflow();
+
+    /**
+     * @brief Registers fixed buffers for IORING_OP_{READ,WRITE}_FIXED.
+     * @return True on success, false if the kernel refused (e.g. memlock limit).
+     */
+    bool registerBuffers(const iovec* buffers, unsigned count) noexcept;
+
+    /**
+     * @brief Registers a provided-buffer ring for IOSQE_BUFFER_SELECT requests.
+     * @param ring Page-aligned ring of `entries` io_uring_buf descriptors, owned by the caller.
+     * @param entries Ring size; a power of two.
+     * @param group Buffer group ID referenced by sqe->buf_group.
+     * @return True on success, false if the kernel lacks IORING_REGISTER_PBUF_RING (pre-5.19).
+     */
+    bool registerBufferRing(io_uring_buf_ring* ring, unsigned entries, uint16_t group) noexcept;
+
+    int fd() const noexcept { return fd_; }
+    unsigned sqEntries() const noexcept { return sq_entries_; }
+
+private:
+    int fd_ = -1;                        ///< Ring file descriptor.
+    void* sq_map_ = nullptr;             ///< Submission ring mapping (shared with CQ when single-mmap).
+    size_t sq_map_size_ = 0;
+    void* cq_map_ = nullptr;             ///< Completion ring mapping (== sq_map_ when single-mmap).
+    size_t cq_map_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;       ///< Submission entry array.
+    size_t sqes_size_ = 0;
+
+    unsigned* sq_head_ = nullptr;        ///< Kernel-written SQ head.
+    unsigned* sq_tail_ = nullptr;        ///< SQ tail published to the kernel.
+    unsigned* sq_array_ = nullptr;       ///< SQ index array.
+    unsigned* sq_flags_ = nullptr;       ///< Kernel-written IORING_SQ_* flags.
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned sqe_tail_ = 0;              ///< Local tail including unpublished entries.
+
+    unsigned* cq_head_ = nullptr;        ///< CQ head consumed by us.
+    unsigned* cq_tail_ = nullptr;        ///< Kernel-written CQ tail.
+    io_uring_cqe* cqes_ = nullptr;       ///< Completion entry array.
+    unsigned cq_mask_ = 0;
+};
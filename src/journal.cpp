@@ -0,0 +1,115 @@
+#include "journal.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <dirent.h>
+
+/**
+ * @brief Opens the active segment after the newest existing one, and the spare after it.
+ */
+Journal::Journal(std::string path) : path_(std::move(path)) {
+    std::vector<std::string> existing = segmentPaths(path_, UINT64_MAX);
+    active_segment_ = existing.empty() ? 1 : std::stoull(existing.back().substr(path_.size() + 1)) + 1;
+    writers_[active_].open(segmentPath(active_segment_), kWriterOptions);
+    writers_[spare_].open(segmentPath(active_segment_ + 1), kWriterOptions);
+    spare_ready_.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Writes out pending records; errors are swallowed since destructors must not throw.
+ */
+Journal::~Journal() {
+    for (AsyncFileWriter& writer : writers_) {
+        try {
+            writer.close();
+        } catch (...) {
+        }
+    }
+    if (spare_ready_.load(std::memory_order_acquire)) std::remove(segmentPath(active_segment_ + 1).c_str());
+}
+
+/**
+ * @brief Hands the partial block to the writer thread and waits for every block to land.
+ */
+void Journal::flush() {
+    writers_[active_].sync();
+}
+
+bool Journal::rotate() noexcept {
+    if (!spare_ready_.load(std::memory_order_acquire)) return false;
+    writers_[active_].flush();
+    spare_ = active_;
+    retired_segment_ = active_segment_;
+    active_ ^= 1;
+    ++active_segment_;
+    spare_segment_ = active_segment_ + 1;
+    spare_ready_.store(false, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Drains the rotated-out writer (its thread join and file close happen here, off the
+ * appending thread), deletes covered segments and reopens the writer as the next spare.
+ */
+size_t Journal::retire(bool discard) {
+    if (spare_ready_.load(std::memory_order_acquire)) return 0; // Nothing rotated out
+    AsyncFileWriter& writer = writers_[spare_];
+    std::exception_ptr error;
+    try {
+        writer.close();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    size_t removed = discard && retired_segment_ != 0 ? removeSegments(path_, retired_segment_) : 0;
+    writer.open(segmentPath(spare_segment_), kWriterOptions);
+    spare_ready_.store(true, std::memory_order_release);
+    if (error) std::rethrow_exception(error);
+    return removed;
+}
+
+size_t Journal::removeSegments(const std::string& path, uint64_t through) {
+    size_t removed = 0;
+    for (const std::string& segment : segmentPaths(path, through)) removed += std::remove(segment.c_str()) == 0;
+    return removed;
+}
+
+/**
+ * @brief Lists path's directory for names of the form <file name>.<number>.
+ */
+std::vector<std::string> Journal::segmentPaths(const std::string& path, uint64_t through) {
+    const size_t slash = path.rfind('/');
+    const std::string directory = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+    const std::string prefix = (slash == std::string::npos ? path : path.substr(slash + 1)) + ".";
+    std::vector<std::pair<uint64_t, std::string>> found;
+    if (DIR* dir = ::opendir(directory.c_str())) {
+        while (const dirent* entry = ::readdir(dir)) {
+            std::string_view name(entry->d_name);
+            if (name.size() <= prefix.size() || name.substr(0, prefix.size()) != prefix) continue;
+            std::string_view digits = name.substr(prefix.size());
+            uint64_t segment = 0;
+            auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), segment);
+            if (ec != std::errc() || ptr != digits.data() + digits.size() || segment == 0 || segment > through) continue;
+            found.emplace_back(segment, path + "." + std::string(digits));
+        }
+        ::closedir(dir);
+    }
+    std::sort(found.begin(), found.end());
+    std::vector<std::string> paths;
+    paths.reserve(found.size());
+    for (auto& [segment, segment_path] : found) paths.push_back(std::move(segment_path));
+    return paths;
+}
+
+/**
+ * @brief Sequences are monotonic within a journal, so a binary search finds the replay start.
+ */
+size_t Journal::firstAfter(const JournalRecord* records, size_t count, uint64_t after_sequence) {
+    const JournalRecord* it = std::upper_bound(
+        records, records + count, after_sequence,
+        [](uint64_t sequence, const JournalRecord& record) { return sequence < record.sequence; });
+    return static_cast<size_t>(it - records);
+}
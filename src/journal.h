@@ -0,0 +1,140 @@
+#pragma once
+#include "async_file_writer.h"
+#include "mapped_file.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Fixed-size binary journal entry for one market data update.
+ */
+struct JournalRecord {
+    uint64_t sequence; ///< Monotonic sequence number.
+    uint64_t ticker;   ///< Packed ticker (see packTicker).
+    double price;      ///< Update price.
+    int32_t volume;    ///< Update volume.
+    uint32_t reserved; ///< Padding, always zero.
+};
+static_assert(sizeof(JournalRecord) == 32, "JournalRecord is persisted verbatim");
+
+/**
+ * @brief Append-only binary journal of market data updates, kept as numbered segment files.
+ *
+ * Records are copied into AsyncFileWriter blocks; full blocks are written by the writer thread,
+ * so the consumer never blocks on write(2) on the hot path. Segments are named path.1, path.2,
+ * ...: appends go to the active segment while a spare writer stands open on the next one.
+ * rotate() switches to the spare without a system call, so the appending thread only marks where
+ * a snapshot starts; closing the rotated-out segment, deleting the segments a durable snapshot
+ * covers and opening the next spare (retire()) happen on another thread. Together with a snapshot
+ * the journal gives restart-by-replay: restore the snapshot, then replay only records newer than
+ * the snapshot's sequence.
+ */
+class Journal {
+public:
+    /**
+     * @brief Starts a new segment after any existing ones at path, plus the spare after it.
+     * @throws std::runtime_error if a segment cannot be opened.
+     */
+    explicit Journal(std::string path);
+
+    /**
+     * @brief Flushes buffered records, closes the segments and removes the unused spare.
+     */
+    ~Journal();
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    /**
+     * @brief Appends a record to the current block; full blocks are written asynchronously.
+     * @throws std::runtime_error once a write to the active segment has failed.
+     */
+    void append(const JournalRecord& record) { writers_[active_].append(&record, sizeof(record)); }
+
+    /**
+     * @brief Writes any buffered records to the active segment and waits for them to land.
+     * @throws std::runtime_error if a write failed.
+     */
+    void flush();
+
+    /**
+     * @brief Appending thread: hands the active segment's partial block over and moves appends
+     * to the spare segment, so every record appended so far is in earlier segments. Makes no
+     * system call.
+     * @return False (appends stay in the active segment) if the spare is not open yet, i.e. the
+     * last rotation has not been retired or reopening the spare failed.
+     */
+    bool rotate() noexcept;
+
+    /**
+     * @brief Maintenance thread, after rotate(): closes the rotated-out segment and opens a new
+     * spare. With discard (a durable snapshot covers every record appended before the rotation),
+     * that segment and all older ones are deleted first.
+     * @return Number of segment files deleted.
+     * @throws std::runtime_error if the rotated-out segment had a write error or the new spare
+     * cannot be opened (rotate() then keeps returning false until a retire() succeeds).
+     *
+     * Call from one thread at a time; it touches only the writer rotate() gave up.
+     */
+    size_t retire(bool discard);
+
+    const std::string& path() const noexcept { return path_; }
+
+    /**
+     * @brief Replays records with sequence > after_sequence from the journal at path.
+     * @param path Journal path as passed to the constructor; no segments replays nothing.
+     * @param after_sequence Records at or below this sequence are skipped.
+     * @param apply Callable invoked with each JournalRecord, in segment and file order.
+     * @return Number of records replayed.
+     *
+     * Segments are mapped and walked in place, so replay cost is dominated by apply().
+     */
+    template <typename Apply>
+    static size_t replay(const std::string& path, uint64_t after_sequence, Apply&& apply) {
+        size_t replayed = 0;
+        for (const std::string& segment : segmentPaths(path, UINT64_MAX)) {
+            MappedFile file(segment);
+            const auto* records = reinterpret_cast<const JournalRecord*>(file.data());
+            size_t count = file.size() / sizeof(JournalRecord);
+            size_t first = firstAfter(records, count, after_sequence);
+            for (size_t i = first; i < count; ++i) apply(records[i]);
+            replayed += count - first;
+        }
+        return replayed;
+    }
+
+    /**
+     * @brief Deletes the segment files of the journal at path numbered up to through.
+     * @return Number of files deleted.
+     */
+    static size_t removeSegments(const std::string& path, uint64_t through = UINT64_MAX);
+
+private:
+    /**
+     * @brief Binary-searches for the first record with sequence > after_sequence.
+     */
+    static size_t firstAfter(const JournalRecord* records, size_t count, uint64_t after_sequence);
+
+    /**
+     * @brief Segment files of the journal at path numbered up to through, oldest first.
+     */
+    static std::vector<std::string> segmentPaths(const std::string& path, uint64_t through);
+
+    std::string segmentPath(uint64_t segment) const { return path_ + "." + std::to_string(segment); }
+
+    /// 64 KiB blocks through io_uring. Segments are always new files, so they are truncated rather
+    /// than opened in append mode (which writes with write(2) and bypasses the ring).
+    static constexpr AsyncWriterOptions kWriterOptions{64 * 1024, 16, false, false};
+
+    std::string path_;                 ///< Journal path; segments are path_.N.
+    AsyncFileWriter writers_[2];       ///< Active and spare segment writers.
+    size_t active_ = 0;                ///< Index of the active writer (appending thread).
+    uint64_t active_segment_ = 0;      ///< Number of the active segment (appending thread).
+    // Published to the maintenance thread by rotate() through spare_ready_.
+    size_t spare_ = 1;                 ///< Index of the writer rotate() gave up.
+    uint64_t retired_segment_ = 0;     ///< Segment that writer holds (0: none yet).
+    uint64_t spare_segment_ = 0;       ///< Segment the next spare opens.
+    std::atomic<bool> spare_ready_{false}; ///< The spare writer is open on active_segment_ + 1.
+};
@@ -0,0 +1,119 @@
+#include "latency_model.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Parses a whole field as an unsigned decimal number.
+ */
+bool parseNumber(std::string_view text, uint64_t& value) noexcept {
+    const char* end = text.data() + text.size();
+    auto [ptr, ec] = std::from_chars(text.data(), end, value);
+    return ec == std::errc() && ptr == end && !text.empty();
+}
+
+} // namespace
+
+LatencyModel LatencyModel::fixed(uint64_t latency_ns) noexcept {
+    LatencyModel model;
+    model.base_ns_ = latency_ns;
+    return model;
+}
+
+/**
+ * @brief Builds the alias table with Vose's method: columns holding less than the average weight
+ * are topped up from one holding more, so every column splits between at most two buckets.
+ */
+LatencyModel LatencyModel::empirical(const std::vector<Bucket>& histogram, uint64_t seed) {
+    double total = 0;
+    for (const Bucket& bucket : histogram) total += static_cast<double>(bucket.count);
+    if (histogram.empty() || total == 0) throw std::runtime_error("LatencyModel: empty latency histogram");
+    if (histogram.size() > UINT32_MAX) throw std::runtime_error("LatencyModel: too many histogram buckets");
+
+    LatencyModel model;
+    model.kind_ = Kind::Empirical;
+    model.state_ = seed;
+    const size_t n = histogram.size();
+    model.values_.reserve(n);
+    for (const Bucket& bucket : histogram) model.values_.emplace_back(bucket.latency_ns);
+    model.thresholds_.assign(n, 0);
+    model.aliases_.resize(n);
+    std::vector<double> scaled(n);
+    std::vector<uint32_t> small, large;
+    for (size_t i = 0; i < n; ++i) {
+        scaled[i] = static_cast<double>(histogram[i].count) * static_cast<double>(n) / total;
+        model.aliases_[i] = static_cast<uint32_t>(i);
+        (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+    }
+    constexpr double kScale = 4294967296.0; // 2^32: thresholds compare against 32 random bits
+    while (!small.empty() && !large.empty()) {
+        const uint32_t less = small.back(), more = large.back();
+        small.pop_back();
+        model.thresholds_[less] = static_cast<uint64_t>(scaled[less] * kScale);
+        model.aliases_[less] = more;
+        scaled[more] -= 1.0 - scaled[less];
+        if (scaled[more] < 1.0) {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    for (uint32_t full : large) model.thresholds_[full] = uint64_t{1} << 32; // Rounding leftovers: always itself
+    for (uint32_t full : small) model.thresholds_[full] = uint64_t{1} << 32;
+    return model;
+}
+
+LatencyModel LatencyModel::loadDependent(uint64_t base_ns, uint64_t per_message_ns, uint64_t window_ns, uint64_t max_ns) {
+    if (window_ns == 0) throw std::runtime_error("LatencyModel: load window must be positive");
+    LatencyModel model;
+    model.kind_ = Kind::LoadDependent;
+    model.base_ns_ = base_ns;
+    model.per_message_ns_ = per_message_ns;
+    model.window_ns_ = window_ns;
+    model.max_ns_ = std::max(max_ns, base_ns);
+    return model;
+}
+
+LatencyModel loadLatencyHistogram(const std::string& path, uint64_t seed) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open latency histogram " + path);
+    std::vector<LatencyModel::Bucket> histogram;
+    std::string line;
+    for (size_t number = 1; std::getline(in, line); ++number) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        const size_t comma = line.find(',');
+        LatencyModel::Bucket bucket;
+        if (comma == std::string::npos || !parseNumber(std::string_view(line).substr(0, comma), bucket.latency_ns) ||
+            !parseNumber(std::string_view(line).substr(comma + 1), bucket.count)) {
+            throw std::runtime_error(path + ":" + std::to_string(number) + ": expected latency_ns,count");
+        }
+        histogram.push_back(bucket);
+    }
+    return LatencyModel::empirical(histogram, seed);
+}
+
+LatencyModel parseLatencyModel(std::string_view spec, uint64_t seed) {
+    const size_t colon = spec.find(':');
+    const std::string_view shape = spec.substr(0, colon);
+    const std::string_view arguments = colon == std::string_view::npos ? std::string_view() : spec.substr(colon + 1);
+    if (shape == "histogram") return loadLatencyHistogram(std::string(arguments), seed);
+
+    std::vector<uint64_t> values;
+    bool valid = !arguments.empty();
+    for (size_t begin = 0; valid && begin <= arguments.size();) {
+        const size_t comma = std::min(arguments.find(',', begin), arguments.size());
+        uint64_t value = 0;
+        valid = parseNumber(arguments.substr(begin, comma - begin), value);
+        values.push_back(value);
+        begin = comma + 1;
+    }
+    if (valid && shape == "fixed" && values.size() == 1) return LatencyModel::fixed(values[0]);
+    if (valid && shape == "load" && (values.size() == 3 || values.size() == 4)) {
+        return LatencyModel::loadDependent(values[0], values[1], values[2], values.size() == 4 ? values[3] : UINT64_MAX);
+    }
+    throw std::runtime_error("Invalid latency model '" + std::string(spec) +
+                             "' (expected fixed:NS, histogram:PATH or load:BASE,PER_MESSAGE,WINDOW[,MAX])");
+}
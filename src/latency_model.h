@@ -0,0 +1,124 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief One-way latency of a simulated link (strategy to exchange, or exchange to strategy),
+ * sampled per message in virtual nanoseconds.
+ *
+ * Three shapes:
+ * - Fixed: the same latency for every message.
+ * - Empirical: drawn from a measured histogram through an alias table (Walker/Vose), so a sample
+ *   is one random number, a multiply and a compare regardless of the bucket count. The generator
+ *   is a seeded splitmix64, so a seed gives the same latencies run to run.
+ * - LoadDependent: base + per_message x messages seen in the busier of the current and previous
+ *   window (capped), so bursts of market data queue orders behind them. Messages are counted by
+ *   sample() and observe().
+ *
+ * sample() is a switch over the shape with no allocation; owned by a single thread.
+ */
+class LatencyModel {
+public:
+    enum class Kind : uint8_t { Fixed, Empirical, LoadDependent };
+
+    /// A histogram bucket: count messages observed at latency_ns.
+    struct Bucket {
+        uint64_t latency_ns;
+        uint64_t count;
+    };
+
+    static LatencyModel fixed(uint64_t latency_ns) noexcept;
+
+    /**
+     * @throws std::runtime_error if the histogram is empty or all counts are 0.
+     */
+    static LatencyModel empirical(const std::vector<Bucket>& histogram, uint64_t seed = 1);
+
+    /**
+     * @throws std::runtime_error if window_ns is 0.
+     */
+    static LatencyModel loadDependent(uint64_t base_ns, uint64_t per_message_ns, uint64_t window_ns,
+                                      uint64_t max_ns = UINT64_MAX);
+
+    /**
+     * @brief Latency of a message sent at now_ns.
+     */
+    uint64_t sample(uint64_t now_ns) noexcept {
+        switch (kind_) {
+        case Kind::Fixed:
+            return base_ns_;
+        case Kind::Empirical: {
+            const uint64_t random = next();
+            const size_t column = static_cast<size_t>(((random >> 32) * values_.size()) >> 32);
+            return (random & 0xFFFFFFFFULL) < thresholds_[column] ? values_[column] : values_[aliases_[column]];
+        }
+        case Kind::LoadDependent:
+            count(now_ns);
+            return std::min(base_ns_ + per_message_ns_ * load_, max_ns_);
+        }
+        return base_ns_;
+    }
+
+    /**
+     * @brief Counts a message that shares the link without being timed (e.g. a market data update
+     * the venue is also processing); only LoadDependent uses it.
+     */
+    void observe(uint64_t now_ns) noexcept {
+        if (kind_ == Kind::LoadDependent) count(now_ns);
+    }
+
+    Kind kind() const noexcept { return kind_; }
+
+private:
+    LatencyModel() = default;
+
+    uint64_t next() noexcept { // splitmix64
+        uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    void count(uint64_t now_ns) noexcept {
+        if (now_ns >= window_end_) {
+            previous_ = now_ns < window_end_ + window_ns_ ? current_ : 0; // Idle windows in between count as 0
+            current_ = 0;
+            window_end_ = now_ns - now_ns % window_ns_ + window_ns_;
+        }
+        ++current_;
+        load_ = std::max(current_, previous_);
+    }
+
+    Kind kind_ = Kind::Fixed;
+    uint64_t base_ns_ = 0;
+    // Empirical: column i yields values_[i] if the low 32 random bits are below thresholds_[i], else values_[aliases_[i]].
+    std::vector<uint64_t> values_;
+    std::vector<uint64_t> thresholds_;
+    std::vector<uint32_t> aliases_;
+    uint64_t state_ = 0;
+    // LoadDependent.
+    uint64_t per_message_ns_ = 0;
+    uint64_t window_ns_ = 1;
+    uint64_t max_ns_ = UINT64_MAX;
+    uint64_t window_end_ = 0;
+    uint64_t current_ = 0;  ///< Messages in the window ending at window_end_.
+    uint64_t previous_ = 0; ///< Messages in the window before it.
+    uint64_t load_ = 0;
+};
+
+/**
+ * @brief Reads an empirical latency histogram: "latency_ns,count" lines ('#' starts a comment).
+ * @throws std::runtime_error if the file cannot be read, a line is malformed or all counts are 0.
+ */
+LatencyModel loadLatencyHistogram(const std::string& path, uint64_t seed = 1);
+
+/**
+ * @brief Builds a model from "fixed:NS", "histogram:PATH" or "load:BASE,PER_MESSAGE,WINDOW[,MAX]"
+ * (all times in nanoseconds), e.g. from a command line.
+ * @throws std::runtime_error on an unknown shape or malformed numbers.
+ */
+LatencyModel parseLatencyModel(std::string_view spec, uint64_t seed = 1);
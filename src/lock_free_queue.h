@@ -1,8 +1,10 @@
 #pragma once
 #include <atomic>
+#include <new>
 #include <vector>
 #include "types.h"
 #include "memory_pool.h"
+#include "padded_counter.h"
 #include <stdexcept>
 
 /**
@@ -11,6 +13,8 @@
  * Designed for low-latency systems, this queue uses std::atomic operations to ensure thread safety
  * without locks. It integrates with a MemoryPool for fast, cache-aligned allocations of MarketData.
  * The queue operates as a circular buffer, minimizing memory overhead and ensuring O(1) operations.
+ * The consumer-written head and producer-written tail each sit on their own cache line, apart from
+ * the read-only members, so the two threads do not false-share.
  */
 class LockFreeQueue {
 public:
@@ -20,23 +24,27 @@ public:
      * @param pool Reference to a MemoryPool for allocating MarketData objects.
      * @throws std::runtime_error if memory pool allocation fails.
      * 
-     * Pre-allocates buffer pointers from the pool to eliminate runtime allocations.
+     * Pre-allocates buffer pointers from the pool to eliminate runtime allocations. Pool memory
+     * is raw, so each slot is constructed here; push() and claim() then always see a live object.
      */
     LockFreeQueue(size_t capacity, MemoryPool& pool) 
-        : buffer(capacity), pool(pool), head(0), tail(0), capacity(capacity) {
+        : buffer(capacity), pool(pool), capacity(capacity), head(0), tail(0) {
         for (size_t i = 0; i < capacity; ++i) {
-            buffer[i] = pool.allocate();
-            if (!buffer[i]) throw std::runtime_error("Memory pool exhausted");
+            MarketData* slot = pool.allocate();
+            if (!slot) throw std::runtime_error("Memory pool exhausted");
+            buffer[i] = new (slot) MarketData{};
         }
     }
 
     /**
      * @brief Destructs the LockFreeQueue, deallocating buffer pointers.
      * 
-     * Returns all allocated MarketData objects to the MemoryPool for reuse.
+     * Destroys the slot objects and returns their memory to the MemoryPool for reuse.
      */
     ~LockFreeQueue() {
         for (size_t i = 0; i < capacity; ++i) {
+            if (!buffer[i]) continue; // Constructor threw before reaching this slot
+            buffer[i]->~MarketData();
             pool.deallocate(buffer[i]);
         }
     }
@@ -62,6 +70,30 @@ public:
         return true;
     }
 
+    /**
+     * @brief Claims the next free slot for in-place construction (producer operation).
+     * @return Pointer to the slot, or nullptr if the queue is full.
+     *
+     * Lets a decoder write straight into pooled storage instead of building a MarketData and
+     * copying it in with push(). The slot becomes visible to the consumer only after commit();
+     * claiming again without committing returns the same slot.
+     */
+    MarketData* claim() {
+        size_t current_tail = tail.load(std::memory_order_relaxed);
+        if ((current_tail + 1) % capacity == head.load(std::memory_order_acquire)) {
+            return nullptr; // Queue full
+        }
+        return buffer[current_tail];
+    }
+
+    /**
+     * @brief Publishes the slot returned by the last successful claim() (producer operation).
+     */
+    void commit() {
+        size_t current_tail = tail.load(std::memory_order_relaxed);
+        tail.store((current_tail + 1) % capacity, std::memory_order_release);
+    }
+
     /**
      * @brief Pops a MarketData item from the queue (consumer operation).
      * @param item Output parameter to store the popped item.
@@ -84,7 +116,7 @@ public:
 private:
     std::vector<MarketData*> buffer; ///< Circular buffer of pointers to pooled MarketData objects.
     MemoryPool& pool;                ///< Reference to MemoryPool for allocations.
-    std::atomic<size_t> head;        ///< Atomic head index for consumer.
-    std::atomic<size_t> tail;        ///< Atomic tail index for producer.
     const size_t capacity;           ///< Fixed queue capacity.
+    alignas(kCacheLineSize) std::atomic<size_t> head; ///< Atomic head index, written by consumer.
+    alignas(kCacheLineSize) std::atomic<size_t> tail; ///< Atomic tail index, written by producer.
 };
\ No newline at end of file
@@ -1,14 +1,22 @@
 #pragma once
-#include <fstream>
+#include "async_file_writer.h"
+#include <chrono>
+#include <condition_variable>
+#include <exception>
 #include <mutex>
 #include <string>
 #include <iostream>
+#include <thread>
 
 /**
  * @brief Singleton logger for thread-safe logging to file and console.
  * 
  * Provides synchronized logging for low-latency systems, using a mutex to prevent file access conflicts.
- * Falls back to console if file operations fail, ensuring debug output is captured.
+ * File output goes through an AsyncFileWriter in append mode, so a log call only copies the line
+ * into a block and the write(2) happens on the writer thread, off the caller's hot path. Lines are
+ * batched: a flusher thread hands the partial block over every kFlushInterval.
+ * Falls back to console if the file cannot be opened, and to std::cerr once a write to it fails
+ * (e.g. on a full disk), so logging never throws into the caller's error handling.
  */
 class Logger {
 public:
@@ -26,17 +34,25 @@ public:
      * @param message The message to log.
      * @param to_console If true, also logs to console.
      * 
-     * Uses std::mutex to ensure thread-safe file writes.
+     * Uses std::mutex to ensure thread-safe file writes. The line reaches the file within about
+     * kFlushInterval without the caller waiting on I/O.
      */
     void log(const std::string& message, bool to_console = false) {
         std::lock_guard<std::mutex> lock(mutex_);
-        if (log_file_.is_open()) {
-            log_file_ << message << "\n";
-            log_file_.flush();
+        if (!file_failed_) {
+            try {
+                log_file_.append(message.data(), message.size());
+                log_file_.append("\n", 1);
+                dirty_ = true;
+            } catch (const std::exception& e) {
+                fail(e);
+            }
         }
-        if (to_console || !log_file_.is_open()) {
+        if (to_console) {
             std::cout << message << "\n";
             std::cout.flush();
+        } else if (file_failed_) {
+            std::cerr << message << "\n";
         }
     }
 
@@ -44,23 +60,69 @@ private:
     /**
      * @brief Constructs the Logger, opening the log file.
      * 
-     * Opens hft_system.log in append mode. File remains open for performance.
+     * Opens hft_system.log in append mode and starts the flusher. File remains open for performance.
      */
     Logger() {
-        log_file_.open("hft_system.log", std::ios::app);
+        try {
+            log_file_.open("hft_system.log", AsyncWriterOptions{64 * 1024, 16, false, true});
+            flusher_ = std::thread(&Logger::flushLoop, this);
+        } catch (const std::exception&) {
+            file_failed_ = true;
+        }
     }
 
     /**
-     * @brief Destructs the Logger, closing the log file.
+     * @brief Destructs the Logger, writing out pending lines and closing the log file.
      */
     ~Logger() {
-        if (log_file_.is_open()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_one();
+        if (flusher_.joinable()) flusher_.join();
+        try {
             log_file_.close();
+        } catch (const std::exception& e) {
+            if (!file_failed_) fail(e);
+        }
+    }
+
+    /**
+     * @brief Flusher thread: hands buffered lines to the writer thread every kFlushInterval.
+     */
+    void flushLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_) {
+            wake_.wait_for(lock, kFlushInterval);
+            if (!dirty_ || file_failed_) continue;
+            try {
+                log_file_.flush();
+            } catch (const std::exception& e) {
+                fail(e);
+            }
+            dirty_ = false;
         }
     }
 
-    std::ofstream log_file_; ///< Output file stream for logging.
+    /**
+     * @brief Stops writing to the file after an error; later lines go to std::cerr.
+     * Called with mutex_ held (or from the destructor, once the flusher has stopped).
+     */
+    void fail(const std::exception& e) {
+        file_failed_ = true;
+        std::cerr << "Log file write failed, logging to stderr: " << e.what() << "\n";
+    }
+
+    static constexpr std::chrono::milliseconds kFlushInterval{100}; ///< Batching window for file writes.
+
+    AsyncFileWriter log_file_; ///< Asynchronous writer for the log file.
     std::mutex mutex_;       ///< Mutex for thread-safe logging.
+    std::condition_variable wake_; ///< Wakes the flusher on shutdown.
+    std::thread flusher_;    ///< Periodically flushes buffered lines.
+    bool dirty_ = false;     ///< Lines appended since the last flush.
+    bool file_failed_ = false; ///< File not open or a write failed; log to std::cerr instead.
+    bool stop_ = false;      ///< Set by the destructor to end the flusher.
 
     // Delete copy and move operations for singleton
     Logger(const Logger&) = delete;
@@ -1,18 +1,130 @@
 #include "market_data.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+
+namespace {
+
+/**
+ * @brief Subscribes to a comma-separated ticker list, or to the first field of each line of a file.
+ * @return False if a ticker could not be added (filter full).
+ */
+bool loadSubscriptions(SubscriptionFilter& filter, const std::string& spec) {
+    std::ifstream file(spec);
+    std::istringstream list(file ? std::string() : spec);
+    std::istream& in = file ? static_cast<std::istream&>(file) : list;
+    std::string ticker;
+    try {
+        while (std::getline(in, ticker, file ? '\n' : ',')) {
+            ticker = ticker.substr(0, ticker.find_first_of(",\r"));
+            if (!ticker.empty()) filter.subscribe(ticker);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return false;
+    }
+    filter.setAcceptAll(false);
+    return true;
+}
+
+/**
+ * @brief Waits for an empty line; "+SYM" and "-SYM" lines change subscriptions in the meantime.
+ * The first "+SYM" switches from accepting everything to filtering; until then there is nothing
+ * to remove, so "-SYM" is refused.
+ */
+void runUntilEnter(SubscriptionFilter& filter) {
+    std::string line;
+    while (std::getline(std::cin, line) && !line.empty()) {
+        try {
+            if (line[0] == '+') {
+                filter.subscribe(line.substr(1));
+                filter.setAcceptAll(false);
+            } else if (line[0] == '-') {
+                if (filter.acceptAll()) {
+                    std::cerr << "Accepting all symbols: subscribe with +SYM before removing any\n";
+                    continue;
+                }
+                filter.unsubscribe(line.substr(1));
+            } else {
+                continue;
+            }
+            std::cout << "Subscribed to " << filter.size() << " symbols\n";
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+        }
+    }
+}
+
+} // namespace
 
 /**
  * @brief Entry point for the low-latency system demonstration.
- * 
+ *
  * Initializes a MarketDataParser, starts producer and consumer threads, and waits for user input
  * to stop the system. Demonstrates concurrency and low-latency design principles.
+ * With --replay <file> [group:port], instead streams a CSV data file or a pcap/pcapng capture of
+ * the binary feed (optionally filtered to one multicast group/port) and exits when done.
+ * With --simulate [file [group:port]], runs the file (or the demo feed) on one thread in virtual
+ * time instead, with bit-identical results run to run, and exits when done.
+ * With --listen <port> [recvmmsg|io_uring], receives the binary UDP feed (wire_format.h) instead
+ * of generating data.
+ * A leading --subscribe <SYM,SYM,...|file> restricts every mode to those symbols; while running,
+ * "+SYM" and "-SYM" lines on stdin add and remove subscriptions ("-SYM" only once filtering).
+ * A leading --baskets <file> prices the baskets defined there ("BASKET,SYMBOL,weight" lines)
+ * from every update, logging their fair values when the consumer stops.
  */
-int main() {
+int main(int argc, char** argv) {
     std::cout << "Starting HFT system\n";
     MarketDataParser parser;
-    parser.start();
-    std::cin.get(); // Wait for Enter
-    parser.stop();
+    while (argc >= 3 && (std::strcmp(argv[1], "--subscribe") == 0 || std::strcmp(argv[1], "--baskets") == 0)) {
+        if (std::strcmp(argv[1], "--subscribe") == 0) {
+            if (!loadSubscriptions(parser.subscriptions(), argv[2])) return 1;
+            std::cout << "Subscribed to " << parser.subscriptions().size() << " symbols\n";
+        } else {
+            try {
+                size_t loaded = loadBaskets(argv[2], parser.baskets());
+                std::cout << "Loaded " << loaded << " baskets\n";
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << "\n";
+                return 1;
+            }
+        }
+        argv[2] = argv[0];
+        argv += 2;
+        argc -= 2;
+    }
+    if ((argc == 3 || argc == 4) && std::strcmp(argv[1], "--replay") == 0) {
+        std::optional<CaptureFilter> filter = CaptureFilter::parse(argc == 4 ? argv[3] : "");
+        if (!filter) {
+            std::cerr << "Invalid capture filter: " << argv[3] << " (expected group:port, group or :port)\n";
+            return 1;
+        }
+        parser.replay(argv[2], *filter);
+    } else if (argc >= 2 && argc <= 4 && std::strcmp(argv[1], "--simulate") == 0) {
+        std::optional<CaptureFilter> filter = CaptureFilter::parse(argc == 4 ? argv[3] : "");
+        if (!filter) {
+            std::cerr << "Invalid capture filter: " << argv[3] << " (expected group:port, group or :port)\n";
+            return 1;
+        }
+        parser.simulate(argc >= 3 ? argv[2] : "", SimulationConfig{}, nullptr, *filter);
+    } else if ((argc == 3 || argc == 4) && std::strcmp(argv[1], "--listen") == 0) {
+        FeedEndpoint endpoint;
+        endpoint.port = static_cast<uint16_t>(std::atoi(argv[2]));
+        std::optional<FeedBackend> backend = parseFeedBackend(argc == 4 ? argv[3] : "recvmmsg");
+        if (!backend) {
+            std::cerr << "Unknown feed backend: " << argv[3] << " (expected recvmmsg or io_uring)\n";
+            return 1;
+        }
+        parser.listen(endpoint, *backend);
+        runUntilEnter(parser.subscriptions());
+        parser.stop();
+    } else {
+        parser.start();
+        runUntilEnter(parser.subscriptions());
+        parser.stop();
+    }
     std::cout << "HFT system stopped\n";
     return 0;
-}
\ No newline at end of file
+}
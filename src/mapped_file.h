@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Read-only RAII memory mapping of a whole file.
+ *
+ * Used by the journal, snapshot and capture readers so on-disk data can be consumed in place
+ * without a parsing or copying step. The mapping is MAP_PRIVATE, so pages stay shared with the
+ * page cache until (and unless) a caller writes to them.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Maps the file at path read-only.
+     * @param path File to map.
+     * @param populate Prefault the whole file up front (MAP_POPULATE). Pass false for files
+     *        streamed once front to back, e.g. multi-GB captures: pages are then read ahead
+     *        aggressively (MADV_SEQUENTIAL) instead of all being faulted in before the first byte.
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     *
+     * An empty file yields a valid object with size() == 0 and data() == nullptr.
+     */
+    explicit MappedFile(const std::string& path, bool populate = true) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) throw std::runtime_error("Failed to open " + path);
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE | (populate ? MAP_POPULATE : 0), fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Failed to mmap " + path);
+            }
+            if (!populate) ::madvise(addr, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const uint8_t*>(addr);
+        }
+        ::close(fd);
+    }
+
+    /**
+     * @brief Unmaps the file.
+     */
+    ~MappedFile() {
+        if (data_) ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr; ///< Start of the mapping, or nullptr for an empty file.
+    size_t size_ = 0;               ///< Mapped length in bytes.
+};
@@ -1,28 +1,139 @@
 #include "market_data.h"
+#include "clock.h"
+#include "fixed_price.h"
 #include "thread_affinity.h"
 #include "logger.h"
+#include "mapped_file.h"
+#include "simd_kernels.h"
+#include "snapshot.h"
+#include "wire_format.h"
+#include <algorithm>
+#include <charconv>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <thread>
 #include <vector>
 
+namespace {
+constexpr size_t kQueueCapacity = 10000;       ///< Capacity of the pool and data queue.
+constexpr size_t kMaxSymbols = 10000;          ///< Capacity of the symbol directory.
+constexpr size_t kMaxTimers = 65536;           ///< Capacity of the consumer's timer wheel.
+constexpr uint64_t kTimerResolutionNs = 1000;  ///< Timer wheel unit (rounded to a power of two in ticks).
+constexpr int kDemoBatches = 10;               ///< Batches in the demo feed.
+constexpr uint64_t kSnapshotInterval = 100000; ///< Updates between periodic snapshots.
+const char* const kSnapshotPath = "hft_system.snap";
+const char* const kJournalPath = "hft_system.journal";
+
+enum class LineStatus {
+    Parsed,       ///< data holds the line.
+    Malformed,    ///< Blank or malformed line, skipped.
+    Unsubscribed, ///< Symbol rejected by the subscription filter before the rest was parsed.
+};
+
+/**
+ * @brief Copies [begin, end), at most 63 bytes, into field and NUL-terminates it. Lines are walked
+ * in place in an unterminated mapping, so strtod/strtol only ever see such a copy.
+ * @return Bytes copied.
+ */
+size_t copyField(const char* begin, const char* end, char (&field)[64]) noexcept {
+    const size_t length = std::min(static_cast<size_t>(end - begin), sizeof(field) - 1);
+    std::memcpy(field, begin, length);
+    field[length] = '\0';
+    return length;
+}
+
+/**
+ * @brief Parses one "SYMBOL,price,volume" line in the data/ file format.
+ * The symbol is checked against filter first, so unsubscribed lines cost no number parsing.
+ * Plain decimal prices go through the SWAR fixed-point parser: up to 8 decimals and below ~90
+ * million the double it yields is the one strtod would, and further decimals are truncated.
+ * Anything it does not take (exponents, a leading '+' or whitespace, more than 8 integer digits)
+ * falls back to strtod, so every price strtod accepts still parses. Numbers are parsed within
+ * [begin, end) only, never past the end of the line.
+ */
+LineStatus parseMarketDataLine(const char* begin, const char* end, const SubscriptionFilter& filter, MarketData& data) {
+    const char* comma = static_cast<const char*>(std::memchr(begin, ',', static_cast<size_t>(end - begin)));
+    if (!comma || comma == begin) return LineStatus::Malformed;
+    if (!filter.accepts(std::string_view(begin, static_cast<size_t>(comma - begin)))) return LineStatus::Unsubscribed;
+    data.symbol.assign(begin, comma);
+    FixedPrice price;
+    const char* next = parsePrice(comma + 1, end, price);
+    char field[64];
+    if (next && next < end && *next == ',') {
+        data.price = toDouble(price);
+    } else {
+        copyField(comma + 1, end, field);
+        char* stop = nullptr;
+        data.price = std::strtod(field, &stop);
+        next = comma + 1 + (stop - field);
+        if (stop == field || next >= end || *next != ',') return LineStatus::Malformed;
+    }
+    // Volumes are plain integers; anything else (e.g. a leading '+') gets strtol's lenient parse.
+    int volume = 0;
+    if (std::from_chars(next + 1, end, volume).ec != std::errc()) {
+        copyField(next + 1, end, field);
+        volume = static_cast<int>(std::strtol(field, nullptr, 10));
+    }
+    data.volume = volume;
+    return LineStatus::Parsed;
+}
+
+/**
+ * @brief One batch of the demo feed: three symbols, priced and sized up by the batch number.
+ */
+std::vector<MarketData> demoBatch(int batch) {
+    return {
+        {"AAPL", 150.25 + batch, 1000 + batch, 0},
+        {"GOOG", 2750.1 + batch, 500 + batch, 0},
+        {"MSFT", 300.75 + batch, 800 + batch, 0}
+    };
+}
+
+/**
+ * @brief FNV-1a over size bytes, continuing from hash.
+ */
+uint64_t fnv1a(uint64_t hash, const void* data, size_t size) noexcept {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+    return hash;
+}
+} // namespace
+
 /**
  * @brief Constructs a MarketDataParser with a memory pool and lock-free queue.
  * Initializes packet_count to 0 for tracking processed data batches.
  * Uses MemoryPool to pre-allocate MarketData objects, minimizing runtime allocations.
+ * Restores per-symbol state from the last snapshot plus the journal tail written after it.
  */
 MarketDataParser::MarketDataParser() 
-    : running(false), pool(10000), dataQueue(10000, pool), packet_count(0) {
-    Logger::getInstance().log("MarketDataParser constructed, packet_count: " + std::to_string(packet_count));
+    : running(false), producer_done(false), packet_count(0), pool(kQueueCapacity),
+      dataQueue(kQueueCapacity, pool), log_messages(true), state(kMaxSymbols), journal(kJournalPath), snapshot_state(kMaxSymbols), metrics(kQueueCapacity),
+      subscription_filter(kMaxSymbols), basket_calculator(kMaxSymbols), position_tracker(kMaxSymbols),
+      timer_wheel(kMaxTimers, TscClock::fromNanos(kTimerResolutionNs), TscClock::now()) {
+    if (!metrics.shared()) {
+        Logger::getInstance().log("Shared-memory metrics unavailable, using private counters");
+    }
+    RecoveryResult recovery = recoverMarketState(kSnapshotPath, kJournalPath, state);
+    Logger::getInstance().log("Recovered " + std::to_string(state.directory().size()) + " symbols at sequence " +
+                              std::to_string(state.sequence()) + " (snapshot: " +
+                              (recovery.snapshot_loaded ? "yes" : "no") + ", journal records replayed: " +
+                              std::to_string(recovery.replayed) + ")");
+    snapshotThread = std::thread(&MarketDataParser::writeSnapshots, this);
+    Logger::getInstance().log("MarketDataParser constructed, packet_count: " + std::to_string(packet_count.load()));
     Logger::getInstance().log("MarketDataParser constructed", true);
 }
 
 /**
  * @brief Destructor ensures threads are stopped to prevent resource leaks.
+ * The snapshot thread finishes any pending snapshot before it exits.
  */
 MarketDataParser::~MarketDataParser() {
     stop();
+    snapshot_stop.store(true, std::memory_order_release);
+    if (snapshotThread.joinable()) snapshotThread.join();
 }
 
 /**
@@ -31,8 +142,9 @@ MarketDataParser::~MarketDataParser() {
  */
 void MarketDataParser::start() {
     running = true;
-    packet_count = 0;
-    Logger::getInstance().log("Starting producer thread, initial packet_count: " + std::to_string(packet_count));
+    producer_done = false;
+    packet_count.store(0);
+    Logger::getInstance().log("Starting producer thread, initial packet_count: " + std::to_string(packet_count.load()));
     Logger::getInstance().log("Starting consumer thread");
     producerThread = std::thread(&MarketDataParser::generateData, this);
     consumerThread = std::thread(&MarketDataParser::processData, this);
@@ -43,8 +155,10 @@ void MarketDataParser::start() {
 /**
  * @brief Stops threads and joins them, ensuring queue is drained.
  * Uses delays to allow producer to complete and consumer to process remaining items.
+ * Takes a final snapshot once the consumer has exited so the next start replays nothing.
  */
 void MarketDataParser::stop() {
+    if (!producerThread.joinable() && !consumerThread.joinable()) return;
     std::this_thread::sleep_for(std::chrono::milliseconds(1100));
     running = false;
     Logger::getInstance().log("Stopping consumer thread");
@@ -57,11 +171,251 @@ void MarketDataParser::stop() {
     if (consumerThread.joinable()) {
         Logger::getInstance().log("Joining consumer thread");
         consumerThread.join();
+        takeSnapshot();
     }
     Logger::getInstance().log("All threads stopped");
     Logger::getInstance().log("All threads stopped", true);
 }
 
+/**
+ * @brief Replays a data file (data/ CSV format) or a pcap/pcapng feed capture through the
+ * pipeline as fast as possible.
+ * @param path File of "SYMBOL,price,volume" lines, or a capture of the binary UDP feed.
+ * @param filter Multicast group/port selecting the feed within a capture (ignored for CSV).
+ * @return Number of messages processed by the consumer.
+ * Blocks until the consumer has drained every message, logging end-to-end throughput.
+ * Per-message logging is disabled so the measured path is the pipeline itself.
+ */
+size_t MarketDataParser::replay(const std::string& path, const CaptureFilter& filter) {
+    Logger& logger = Logger::getInstance();
+    log_messages = false;
+    running = true;
+    producer_done = false;
+    packet_count.store(0);
+    uint64_t first_sequence = state.sequence();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if (PcapReader::isCapture(path)) {
+        producerThread = std::thread(&MarketDataParser::replayCapture, this, path, filter);
+    } else {
+        producerThread = std::thread(&MarketDataParser::replayData, this, path);
+    }
+    consumerThread = std::thread(&MarketDataParser::processData, this);
+    producerThread.join();
+    consumerThread.join();
+    auto end = std::chrono::high_resolution_clock::now();
+    running = false;
+    takeSnapshot();
+
+    size_t processed = static_cast<size_t>(state.sequence() - first_sequence);
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::ostringstream oss;
+    oss << "Replayed " << processed << " messages from " << path << " in " << duration / 1000.0 << " ms, "
+        << static_cast<uint64_t>(processed * 1e6 / (duration > 0 ? duration : 1)) << " msgs/sec";
+    logger.log(oss.str(), true);
+    return processed;
+}
+
+/**
+ * @brief Walks a feed capture and decodes every matching datagram straight into queue slots.
+ * Unlike the live receiver a replay never drops: a full queue is waited out, as in replayData().
+ * Pins to CPU 0 and signals producer_done when the capture is exhausted.
+ */
+void MarketDataParser::replayCapture(const std::string& path, CaptureFilter filter) {
+    Logger& logger = Logger::getInstance();
+    ProducerMetrics& stats = metrics.segment().producer;
+    try {
+        setThreadAffinity(std::this_thread::get_id(), 0);
+        PcapReader reader(path);
+        FeedDecoder decoder;
+        decoder.setFilter(&subscription_filter);
+        uint64_t filtered = 0;
+        uint64_t first_capture_ns = 0;
+        uint64_t last_capture_ns = 0;
+        auto wait_for_slot = [&] {
+            bumpCounter(stats.queue_full_retries);
+            if (!running) return false;
+            std::this_thread::yield();
+            return true;
+        };
+        CaptureStats capture = reader.forEachUdp(filter, [&](const UdpDatagram& datagram) {
+            if (!running) return;
+            if (first_capture_ns == 0) first_capture_ns = datagram.timestamp_ns;
+            last_capture_ns = datagram.timestamp_ns;
+            size_t pushed = decoder.decode(datagram.payload, datagram.size, TscClock::now(), dataQueue, wait_for_slot);
+            bumpCounter(stats.messages_pushed, pushed);
+            bumpCounter(stats.batches);
+            if (decoder.stats().filtered != filtered) {
+                bumpCounter(stats.messages_filtered, decoder.stats().filtered - filtered);
+                filtered = decoder.stats().filtered;
+            }
+        });
+        const ReceiverStats& feed = decoder.stats();
+        std::ostringstream oss;
+        oss << "Capture " << path << ": " << capture.frames << " frames, " << capture.udp << " UDP, "
+            << capture.matched << " matched, " << capture.truncated << " truncated; " << feed.updates
+            << " updates, " << feed.filtered << " filtered, " << feed.gaps << " sequence gaps, " << feed.malformed << " malformed; capture spans "
+            << (last_capture_ns - first_capture_ns) / 1e6 << " ms";
+        logger.log(oss.str(), true);
+    } catch (const std::exception& e) {
+        logger.log("Capture replay error: " + std::string(e.what()), true);
+    }
+    producer_done.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief Starts a UDP feed receiver as the producer, with the usual consumer.
+ * @param endpoint Local address/port (and optional multicast group) to receive on.
+ * @param backend recvmmsg or io_uring receive path.
+ * Runs until stop(); per-message logging is disabled as for replays.
+ */
+void MarketDataParser::listen(const FeedEndpoint& endpoint, FeedBackend backend) {
+    log_messages = false;
+    running = true;
+    producer_done = false;
+    packet_count.store(0);
+    producerThread = std::thread(&MarketDataParser::receiveData, this, endpoint, backend);
+    consumerThread = std::thread(&MarketDataParser::processData, this);
+    Logger::getInstance().log("Listening on " + endpoint.address + ":" + std::to_string(endpoint.port) + " (" +
+                                  feedBackendName(backend) + ")\nPress Enter to stop the program...", true);
+}
+
+/**
+ * @brief Runs a CSV data file, a feed capture or (with an empty path) the demo feed through the
+ * pipeline on the calling thread in virtual time, as fast as the CPU allows.
+ * @param path File as for replay(), or "" for generateData()'s batches.
+ * @param config Virtual times of CSV lines and demo batches, and how long timers run afterwards.
+ * @param handler Strategy hooks, or nullptr.
+ * @param filter Multicast group/port selecting the feed within a capture (ignored otherwise).
+ * @return Counts, the virtual time span and a digest of the final state.
+ * Capture updates take their packet timestamps; the clock never moves backwards. For each event,
+ * timers due by its time fire, then the update is applied, then the handler runs. There are no
+ * threads, queue, sleeps or TSC reads, so equal runs give bit-identical results. Starts from
+ * empty market state and leaves the snapshot and journal alone; positions and baskets start as
+ * the parser has them, so use a fresh parser per run. Timers pending beforehand are dropped.
+ */
+SimulationResult MarketDataParser::simulate(const std::string& path, const SimulationConfig& config,
+                                            SimulationHandler* handler, const CaptureFilter& filter) {
+    Logger& logger = Logger::getInstance();
+    SimulationResult result;
+    log_messages = false;
+    state.clear();
+    simulating = true;
+    bool started = false;
+    // The clock and a nanosecond timer wheel start at the first event, so captures keep their times.
+    auto begin = [&](uint64_t time_ns) {
+        started = true;
+        result.first_ns = time_ns;
+        timer_wheel = TimerWheel(kMaxTimers, 1, time_ns);
+        if (handler) handler->onStart(*this);
+    };
+    auto event = [&](MarketData& data, uint64_t time_ns) {
+        if (!started) begin(time_ns);
+        simulateEvent(data, time_ns, handler, result);
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    try {
+        MarketData data;
+        if (path.empty()) {
+            for (int batch = 0; batch < kDemoBatches; ++batch) {
+                const uint64_t time_ns = config.start_ns + static_cast<uint64_t>(batch) * config.batch_spacing_ns;
+                for (MarketData& update : demoBatch(batch)) {
+                    if (subscription_filter.accepts(update.symbol)) {
+                        event(update, time_ns);
+                    } else {
+                        ++result.filtered;
+                    }
+                }
+            }
+        } else if (PcapReader::isCapture(path)) {
+            PcapReader reader(path);
+            reader.forEachUdp(filter, [&](const UdpDatagram& datagram) {
+                decodeDatagram(datagram.payload, datagram.size, [&](const WireHeader&, const WireUpdate& update) {
+                    if (!subscription_filter.accepts(update.ticker)) {
+                        ++result.filtered;
+                        return;
+                    }
+                    toMarketData(update, datagram.timestamp_ns, data);
+                    event(data, datagram.timestamp_ns);
+                });
+            });
+        } else {
+            MappedFile file(path);
+            const char* cursor = reinterpret_cast<const char*>(file.data());
+            const char* const file_end = cursor + file.size();
+            uint64_t line = 0;
+            while (cursor < file_end) {
+                const char* line_end = simd().find_delimiter(cursor, file_end, '\n', '\r');
+                LineStatus status = parseMarketDataLine(cursor, line_end, subscription_filter, data);
+                if (status != LineStatus::Malformed) {
+                    const uint64_t time_ns = config.start_ns + line++ * config.spacing_ns; // Filtering does not shift times
+                    if (status == LineStatus::Parsed) {
+                        event(data, time_ns);
+                    } else {
+                        ++result.filtered;
+                    }
+                }
+                cursor = line_end + 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        logger.log("Simulation error: " + std::string(e.what()), true);
+    }
+    if (!started) begin(config.start_ns);
+    result.timers_fired += timer_wheel.advance(timer_wheel.now() + config.linger_ns);
+    if (handler) handler->onFinish(*this);
+    auto end = std::chrono::high_resolution_clock::now();
+    result.wall_seconds = std::chrono::duration<double>(end - start).count();
+    result.last_ns = timer_wheel.now();
+
+    uint64_t digest = 0xCBF29CE484222325ULL;
+    const std::vector<uint64_t>& tickers = state.directory().tickers();
+    digest = fnv1a(digest, tickers.data(), tickers.size() * sizeof(uint64_t));
+    digest = fnv1a(digest, state.states().data(), state.states().size() * sizeof(SymbolState));
+    for (uint32_t symbol = 0; symbol < tickers.size(); ++symbol) {
+        const Position position = position_tracker.position(symbol);
+        digest = fnv1a(digest, &position, sizeof(position));
+    }
+    const AccountPnl account = position_tracker.account();
+    digest = fnv1a(digest, &account, sizeof(account));
+    for (uint32_t basket = 0; basket < basket_calculator.size(); ++basket) {
+        const double value = basket_calculator.value(basket);
+        digest = fnv1a(digest, &value, sizeof(value));
+    }
+    result.digest = digest;
+
+    simulating = false;
+    timer_wheel = TimerWheel(kMaxTimers, TscClock::fromNanos(kTimerResolutionNs), TscClock::now());
+    std::ostringstream oss;
+    oss << "Simulated " << result.events << " updates (" << result.filtered << " filtered, " << result.dropped
+        << " dropped) spanning "
+        << static_cast<double>(result.last_ns - result.first_ns) / 1e6 << " ms of virtual time in "
+        << result.wall_seconds * 1000.0 << " ms, "
+        << static_cast<uint64_t>(static_cast<double>(result.events) / std::max(result.wall_seconds, 1e-9))
+        << " updates/sec, " << result.timers_fired << " timers fired, digest " << std::hex << result.digest;
+    logger.log(oss.str(), true);
+    return result;
+}
+
+/**
+ * @brief One simulated event: moves the virtual clock to time_ns, fires the timers due by then,
+ * applies the update and hands it to the handler.
+ */
+void MarketDataParser::simulateEvent(MarketData& data, uint64_t time_ns, SimulationHandler* handler,
+                                     SimulationResult& result) {
+    result.timers_fired += timer_wheel.advance(time_ns); // Never moves the clock backwards
+    data.timestamp = timer_wheel.now();
+    const uint32_t symbol = applyUpdate(data);
+    bumpCounter(metrics.segment().consumer.messages_processed);
+    if (symbol == kInvalidSymbol) {
+        ++result.dropped;
+        return;
+    }
+    ++result.events;
+    if (handler) handler->onUpdate(*this, symbol, data);
+}
+
 /**
  * @brief Processes the next MarketData item from the lock-free queue.
  * @param data Output parameter for the popped data.
@@ -89,21 +443,24 @@ void MarketDataParser::generateData() {
         return;
     }
 
-    logger.log("Producer thread started, packet_count: " + std::to_string(packet_count));
+    logger.log("Producer thread started, packet_count: " + std::to_string(packet_count.load()));
     size_t items_pushed = 0;
+    ProducerMetrics& stats = metrics.segment().producer;
 
     try {
-        for (int batch = 0; batch < 10 && running; ++batch) {
-            std::vector<MarketData> batch_data = {
-                {"AAPL", 150.25 + batch, 1000 + batch},
-                {"GOOG", 2750.1 + batch, 500 + batch},
-                {"MSFT", 300.75 + batch, 800 + batch}
-            };
+        for (int batch = 0; batch < kDemoBatches && running; ++batch) {
+            std::vector<MarketData> batch_data = demoBatch(batch);
 
-            logger.log("Generating batch " + std::to_string(batch + 1) + "/10");
+            logger.log("Generating batch " + std::to_string(batch + 1) + "/" + std::to_string(kDemoBatches));
 
-            for (const auto& data : batch_data) {
+            for (auto& data : batch_data) {
+                if (!subscription_filter.accepts(data.symbol)) {
+                    bumpCounter(stats.messages_filtered);
+                    continue;
+                }
+                data.timestamp = TscClock::now();
                 while (!dataQueue.push(data) && running) {
+                    bumpCounter(stats.queue_full_retries);
                     logger.log("Queue full, retrying for: " + std::string(data.symbol));
                     std::this_thread::sleep_for(std::chrono::microseconds(1));
                 }
@@ -112,10 +469,12 @@ void MarketDataParser::generateData() {
                 oss << "Pushed to queue: " << data.symbol << ", " << data.price << ", " << data.volume;
                 logger.log(oss.str());
                 ++items_pushed;
+                bumpCounter(stats.messages_pushed);
             }
 
             ++packet_count;
-            logger.log("Processed batch " + std::to_string(packet_count) + ", items pushed: " + std::to_string(items_pushed));
+            bumpCounter(stats.batches);
+            logger.log("Processed batch " + std::to_string(packet_count.load()) + ", items pushed: " + std::to_string(items_pushed));
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
     } catch (const std::exception& e) {
@@ -126,41 +485,138 @@ void MarketDataParser::generateData() {
     logger.log("Producer thread exiting, total items pushed: " + std::to_string(items_pushed));
 }
 
+/**
+ * @brief Reads a data file and pushes each line to the lock-free queue without delays.
+ * The file is memory-mapped and walked in place; timestamps are taken at enqueue.
+ * Lines for unsubscribed symbols are dropped after the symbol field, before any number parsing.
+ * Pins to CPU 0 like generateData() and signals producer_done when the file is exhausted.
+ */
+void MarketDataParser::replayData(const std::string& path) {
+    Logger& logger = Logger::getInstance();
+    ProducerMetrics& stats = metrics.segment().producer;
+    size_t items_pushed = 0;
+    try {
+        setThreadAffinity(std::this_thread::get_id(), 0);
+        MappedFile file(path);
+        const char* cursor = reinterpret_cast<const char*>(file.data());
+        const char* const file_end = cursor + file.size();
+        MarketData data;
+        while (cursor < file_end && running) {
+            const char* line_end = simd().find_delimiter(cursor, file_end, '\n', '\r');
+            LineStatus status = parseMarketDataLine(cursor, line_end, subscription_filter, data);
+            if (status == LineStatus::Unsubscribed) {
+                bumpCounter(stats.messages_filtered);
+            } else if (status == LineStatus::Parsed) {
+                data.timestamp = TscClock::now();
+                while (!dataQueue.push(data)) {
+                    bumpCounter(stats.queue_full_retries);
+                    if (!running) break;
+                    std::this_thread::yield();
+                }
+                if (!running) break;
+                ++items_pushed;
+                bumpCounter(stats.messages_pushed);
+            }
+            cursor = line_end + 1;
+        }
+    } catch (const std::exception& e) {
+        logger.log("Replay producer error: " + std::string(e.what()), true);
+    }
+    producer_done.store(true, std::memory_order_release);
+    logger.log("Replay producer exiting, total items pushed: " + std::to_string(items_pushed));
+}
+
+/**
+ * @brief Busy-polls a FeedReceiver, which decodes datagrams straight into queue slots.
+ * Pins to CPU 0 like the other producers; updates dropped on a full queue are counted as retries.
+ */
+void MarketDataParser::receiveData(FeedEndpoint endpoint, FeedBackend backend) {
+    Logger& logger = Logger::getInstance();
+    ProducerMetrics& stats = metrics.segment().producer;
+    try {
+        setThreadAffinity(std::this_thread::get_id(), 0);
+        std::unique_ptr<FeedReceiver> receiver = makeFeedReceiver(backend, endpoint);
+        receiver->setFilter(&subscription_filter);
+        uint64_t dropped = 0;
+        uint64_t filtered = 0;
+        while (running) {
+            size_t received = receiver->poll(dataQueue);
+            if (received > 0) {
+                bumpCounter(stats.messages_pushed, received);
+                bumpCounter(stats.batches);
+            }
+            if (receiver->stats().queue_full != dropped) {
+                bumpCounter(stats.queue_full_retries, receiver->stats().queue_full - dropped);
+                dropped = receiver->stats().queue_full;
+            }
+            if (receiver->stats().filtered != filtered) {
+                bumpCounter(stats.messages_filtered, receiver->stats().filtered - filtered);
+                filtered = receiver->stats().filtered;
+            }
+        }
+        const ReceiverStats& totals = receiver->stats();
+        logger.log("Feed receiver exiting: " + std::to_string(totals.datagrams) + " datagrams, " +
+                   std::to_string(totals.updates) + " updates, " + std::to_string(totals.filtered) + " filtered, " +
+                   std::to_string(totals.gaps) + " gaps, " +
+                   std::to_string(totals.malformed) + " malformed, " + std::to_string(totals.queue_full) +
+                   " dropped on full queue");
+    } catch (const std::exception& e) {
+        logger.log("Feed receiver error: " + std::string(e.what()), true);
+        running = false;
+    }
+}
+
 /**
  * @brief Consumes MarketData from the lock-free queue and processes it.
  * Uses adaptive polling to balance low-latency and CPU efficiency.
- * Pins to CPU 1 to avoid contention with producer, optimizing NUMA performance.
+ * Pins to CPU 1 to avoid contention with producer, optimizing NUMA performance
+ * (CPU 0 on single-core hosts, where CPU 1 does not exist).
+ * Exits once the queue is empty and a replay producer has signalled producer_done.
  */
 void MarketDataParser::processData() {
     Logger& logger = Logger::getInstance();
+    const int cpu_core = std::thread::hardware_concurrency() > 1 ? 1 : 0;
     try {
-        setThreadAffinity(std::this_thread::get_id(), 1);
-        logger.log("Consumer thread affinity set to CPU 1");
+        setThreadAffinity(std::this_thread::get_id(), cpu_core);
+        logger.log("Consumer thread affinity set to CPU " + std::to_string(cpu_core));
     } catch (const std::exception& e) {
         logger.log("Consumer thread failed to set affinity: " + std::string(e.what()));
         logger.log("Consumer affinity error", true);
+        running = false; // Nothing will drain the queue; release the producer
         return;
     }
 
     logger.log("Consumer thread started");
+    seedBaskets();
     size_t processed_count = 0;
     auto start = std::chrono::high_resolution_clock::now();
     size_t empty_count = 0;
     size_t yield_count = 0;
     size_t sleep_count = 0;
+    ConsumerMetrics& stats = metrics.segment().consumer;
+    // Warm the TSC calibration here so the first latency sample does not pay for it.
+    const double ns_per_tick = TscClock::nsPerTick();
 
     try {
         while (running) {
+            timer_wheel.tick(); // One rdtsc and a compare unless a timer unit has passed
             MarketData data;
             if (dataQueue.pop(data)) {
-                std::ostringstream oss;
-                oss << "Processed: " << data.symbol << ", Price: " << data.price << ", Volume: " << data.volume;
-                logger.log(oss.str());
+                stats.recordLatency(static_cast<uint64_t>((TscClock::now() - data.timestamp) * ns_per_tick));
+                bumpCounter(stats.messages_processed);
+                applyUpdate(data);
+                if (log_messages) {
+                    std::ostringstream oss;
+                    oss << "Processed: " << data.symbol << ", Price: " << data.price << ", Volume: " << data.volume;
+                    logger.log(oss.str());
+                }
                 ++processed_count;
                 empty_count = 0;
                 yield_count = 0;
                 sleep_count = 0;
             } else {
+                bumpCounter(stats.empty_polls);
+                if (producer_done.load(std::memory_order_acquire)) break; // Drained below
                 ++empty_count;
                 if (empty_count < 10000) continue; // Busy-wait for low latency
                 if (empty_count < 100000) {
@@ -181,21 +637,140 @@ void MarketDataParser::processData() {
         // Drain remaining items in queue
         MarketData data;
         while (dataQueue.pop(data)) {
-            std::ostringstream oss;
-            oss << "Processed: " << data.symbol << ", Price: " << data.price << ", Volume: " << data.volume;
-            logger.log(oss.str());
+            stats.recordLatency(static_cast<uint64_t>((TscClock::now() - data.timestamp) * ns_per_tick));
+            bumpCounter(stats.messages_processed);
+            applyUpdate(data);
+            if (log_messages) {
+                std::ostringstream oss;
+                oss << "Processed: " << data.symbol << ", Price: " << data.price << ", Volume: " << data.volume;
+                logger.log(oss.str());
+            }
             ++processed_count;
         }
+        timer_wheel.tick();
 
         auto end = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
         std::ostringstream oss;
         oss << "Consumer processed " << processed_count << " items in "
-            << duration / 1000.0 << " ms, " << (processed_count * 1e6 / duration) << " items/sec";
+            << duration / 1000.0 << " ms, " << (processed_count * 1e6 / duration) << " items/sec, "
+            << stats.symbols_dropped.load(std::memory_order_relaxed) << " dropped with the symbol directory full";
         logger.log(oss.str());
+        logBaskets();
         logger.log("Consumer thread exiting");
     } catch (const std::exception& e) {
         logger.log("Consumer error: " + std::string(e.what()));
         logger.log("Consumer error", true);
+        running = false; // Nothing will drain the queue; release the producer
+    }
+}
+
+/**
+ * @brief Applies a consumed update to the per-symbol books and journals it (unless simulating).
+ * @return Symbol ID of the update, or kInvalidSymbol if it was dropped: once the symbol directory
+ * is full, updates for new symbols are counted in symbols_dropped and the pipeline keeps running.
+ * Every kSnapshotInterval updates a copy of the state goes to the snapshot thread, which writes it
+ * and deletes the journal segments it covers, bounding restart time to one snapshot load plus at most one interval of replay.
+ */
+uint32_t MarketDataParser::applyUpdate(const MarketData& data) {
+    uint64_t sequence = state.sequence() + 1;
+    uint64_t ticker = packTicker(data.symbol);
+    const SymbolDirectory& directory = state.directory();
+    if (directory.size() == directory.capacity() && directory.find(ticker) == kInvalidSymbol) {
+        bumpCounter(metrics.segment().consumer.symbols_dropped);
+        return kInvalidSymbol;
+    }
+    uint32_t symbol = state.apply(ticker, data.price, data.volume, sequence);
+    position_tracker.onTick(symbol, data.price);
+    if (!basket_calculator.empty()) basket_calculator.update(ticker, data.price);
+    if (simulating) return symbol; // Backtests leave the live recovery files alone
+    journal.append(JournalRecord{sequence, ticker, data.price, data.volume, 0});
+    if (sequence % kSnapshotInterval == 0) {
+        requestSnapshot();
+    }
+    return symbol;
+}
+
+/**
+ * @brief Prices basket constituents from the last prices in state (e.g. recovered from the
+ * snapshot and journal), so baskets defined after a restart do not start from zero. Symbols
+ * already priced at the same value are unchanged.
+ */
+void MarketDataParser::seedBaskets() noexcept {
+    if (basket_calculator.empty()) return;
+    const std::vector<uint64_t>& tickers = state.directory().tickers();
+    const std::vector<SymbolState>& states = state.states();
+    for (uint32_t id = 0; id < tickers.size(); ++id) {
+        if (states[id].update_count != 0) basket_calculator.update(tickers[id], states[id].last_price);
+    }
+}
+
+/**
+ * @brief Logs each basket's fair value (to the console too), e.g. when the consumer exits.
+ */
+void MarketDataParser::logBaskets() {
+    for (uint32_t basket = 0; basket < basket_calculator.size(); ++basket) {
+        std::ostringstream oss;
+        oss << "Basket " << basket_calculator.name(basket) << ": fair value " << basket_calculator.value(basket)
+            << " (" << basket_calculator.constituents(basket) << " constituents"
+            << (basket_calculator.ready(basket) ? "" : ", not all priced") << ")";
+        Logger::getInstance().log(oss.str(), true);
+    }
+}
+
+/**
+ * @brief Consumer side of a snapshot: copies the state (flat arrays, no allocation) and rotates
+ * the journal at the same point, so the retired segments hold exactly the records the copy
+ * covers. No system call; the snapshot thread does the I/O.
+ * @return False, skipping this snapshot, while the previous one is still being written.
+ */
+bool MarketDataParser::requestSnapshot() {
+    if (snapshot_pending.load(std::memory_order_acquire)) return false;
+    snapshot_state.copyFrom(state);
+    snapshot_rotated = journal.rotate();
+    snapshot_pending.store(true, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Snapshots the current state and waits until it is written; for the control thread once
+ * the consumer has exited, so the next start replays nothing.
+ */
+void MarketDataParser::takeSnapshot() {
+    while (!requestSnapshot()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    while (snapshot_pending.load(std::memory_order_acquire)) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+/**
+ * @brief Snapshot thread: writes each copy handed over by requestSnapshot(), then retires the
+ * journal segments it covers (or, if the write failed, keeps them and just reopens the spare).
+ * Polls with 1 ms sleeps so handing a snapshot over costs the consumer no wake-up system call.
+ */
+void MarketDataParser::writeSnapshots() {
+    Logger& logger = Logger::getInstance();
+    for (;;) {
+        if (!snapshot_pending.load(std::memory_order_acquire)) {
+            if (snapshot_stop.load(std::memory_order_acquire)) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        bool written = false;
+        try {
+            writeSnapshot(kSnapshotPath, snapshot_state);
+            written = true;
+            size_t removed = journal.retire(snapshot_rotated);
+            logger.log("Snapshot written at sequence " + std::to_string(snapshot_state.sequence()) +
+                       ", journal segments removed: " + std::to_string(removed));
+        } catch (const std::exception& e) {
+            logger.log(std::string(written ? "Journal error: " : "Snapshot error: ") + e.what());
+            if (!written) {
+                try {
+                    journal.retire(false); // Keep the segments, reopen the spare
+                } catch (const std::exception& retire_error) {
+                    logger.log("Journal error: " + std::string(retire_error.what()));
+                }
+            }
+        }
+        snapshot_pending.store(false, std::memory_order_release);
     }
 }
\ No newline at end of file
@@ -1,13 +1,27 @@
 #pragma once
+#include "basket_calculator.h"
+#include "feed_receiver.h"
+#include "journal.h"
 #include "lock_free_queue.h"
+#include "market_state.h"
 #include "memory_pool.h"
+#include "metrics.h"
+#include "pcap_reader.h"
+#include "padded_counter.h"
+#include "position_tracker.h"
+#include "simulation.h"
+#include "subscription_filter.h"
+#include "timer_wheel.h"
 #include "types.h"
 #include <atomic>
+#include <string>
 #include <thread>
 
 /**
  * @brief Parses and processes MarketData using a lock-free queue and memory pool.
  * Manages producer and consumer threads for low-latency data handling.
+ * Every field written by one thread and read by another starts its own cache line;
+ * the remaining members are either read-only while running or owned by a single thread.
  */
 class MarketDataParser {
 public:
@@ -16,15 +30,75 @@ public:
     void start();
     void stop();
     bool processNext(MarketData& data);
+    size_t replay(const std::string& path, const CaptureFilter& filter = {});
+    void listen(const FeedEndpoint& endpoint, FeedBackend backend);
+    SimulationResult simulate(const std::string& path, const SimulationConfig& config = {},
+                              SimulationHandler* handler = nullptr, const CaptureFilter& filter = {});
+
+    /**
+     * @brief Symbols producers enqueue; accepts everything until setAcceptAll(false).
+     * May be changed at any time, including while a producer is running.
+     */
+    SubscriptionFilter& subscriptions() noexcept { return subscription_filter; }
+
+    /**
+     * @brief Baskets priced by the consumer from every update; define them before start(),
+     * replay() or listen(), which first price them from the recovered market state.
+     */
+    BasketCalculator& baskets() noexcept { return basket_calculator; }
+
+    /**
+     * @brief Positions keyed by MarketState symbol IDs, marked to market by the consumer on every
+     * update. Fills are applied on the consumer thread; account() may be read from any thread.
+     */
+    PositionTracker& positions() noexcept { return position_tracker; }
+
+    /**
+     * @brief Timers run by the consumer between messages (order timeouts, heartbeats). Schedule
+     * and cancel only from callbacks or from another thread while the consumer is stopped.
+     * Deadlines are in now()'s units.
+     */
+    TimerWheel& timers() noexcept { return timer_wheel; }
+
+    /**
+     * @brief Pipeline time: TSC ticks, or virtual nanoseconds inside simulate() (in a timer
+     * callback, the time the timer fired).
+     */
+    uint64_t now() const noexcept { return simulating ? timer_wheel.now() : TscClock::now(); }
 
 private:
     void generateData();
+    void replayData(const std::string& path);
+    void replayCapture(const std::string& path, CaptureFilter filter);
+    void receiveData(FeedEndpoint endpoint, FeedBackend backend);
     void processData();
+    uint32_t applyUpdate(const MarketData& data);
+    void simulateEvent(MarketData& data, uint64_t time_ns, SimulationHandler* handler, SimulationResult& result);
+    bool requestSnapshot();
+    void takeSnapshot();
+    void writeSnapshots();
+    void seedBaskets() noexcept;
+    void logBaskets();
 
-    std::atomic<bool> running;
-    MemoryPool pool;
-    LockFreeQueue dataQueue;
+    alignas(kCacheLineSize) std::atomic<bool> running; ///< Written by the control thread, polled by both workers.
+    alignas(kCacheLineSize) std::atomic<bool> producer_done; ///< Set by the producer once its input is exhausted.
+    PaddedCounter packet_count;   ///< Batches produced, written by the producer only.
+    MemoryPool pool;              ///< Backing store for dataQueue, untouched after construction.
+    LockFreeQueue dataQueue;      ///< Producer-to-consumer queue with padded head/tail.
     std::thread producerThread;
     std::thread consumerThread;
-    size_t packet_count;
+    bool log_messages;      ///< Log every message (demo mode); disabled for replays.
+    MarketState state;      ///< Per-symbol books, owned by the consumer thread while running.
+    Journal journal;        ///< Journal of applied updates since the last snapshot.
+    MarketState snapshot_state;   ///< Copy of state being snapshotted, owned by whoever snapshot_pending says.
+    bool snapshot_rotated = false; ///< The journal rotated when snapshot_state was copied.
+    alignas(kCacheLineSize) std::atomic<bool> snapshot_pending{false}; ///< A copy awaits the snapshot thread.
+    std::atomic<bool> snapshot_stop{false}; ///< Ends the snapshot thread once nothing is pending.
+    std::thread snapshotThread;   ///< Writes snapshots and retires journal segments off the consumer.
+    SharedMetrics metrics;  ///< Shared-memory counters read by hft_stat.
+    SubscriptionFilter subscription_filter; ///< Checked by producers before enqueueing; lock-free to read.
+    BasketCalculator basket_calculator;     ///< Basket fair values, owned by the consumer thread while running.
+    PositionTracker position_tracker;       ///< Positions and PnL, written by the consumer thread while running.
+    TimerWheel timer_wheel;                 ///< Ticked by the consumer thread on every poll.
+    bool simulating = false;                ///< Inside simulate(): timer_wheel is the virtual clock; no journal or snapshots.
 };
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+#include "symbol_directory.h"
+#include "types.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Per-symbol book state maintained by the consumer thread.
+ *
+ * Plain-old-data with a fixed 32-byte layout so the whole table can be written to and mapped
+ * from a snapshot file without serialisation.
+ */
+struct SymbolState {
+    double last_price;      ///< Last traded price.
+    int64_t total_volume;   ///< Cumulative traded volume.
+    uint64_t last_sequence; ///< Sequence number of the last applied update.
+    int32_t last_volume;    ///< Volume of the last update.
+    uint32_t update_count;  ///< Number of updates applied.
+};
+static_assert(sizeof(SymbolState) == 32, "SymbolState is persisted verbatim in snapshots");
+
+/**
+ * @brief Flat per-symbol market state: a symbol directory plus a SymbolState per symbol ID.
+ *
+ * Owned and mutated by a single thread. Everything lives in contiguous arrays so snapshots are a
+ * handful of sequential writes and restores a handful of memcpys.
+ */
+class MarketState {
+public:
+    /**
+     * @brief Constructs state for up to max_symbols symbols.
+     */
+    explicit MarketState(size_t max_symbols) : directory_(max_symbols) {
+        states_.reserve(max_symbols);
+    }
+
+    /**
+     * @brief Applies an update for a packed ticker.
+     * @param ticker Packed ticker (see packTicker).
+     * @param price Update price.
+     * @param volume Update volume.
+     * @param sequence Monotonic sequence number of the update.
+     * @return Symbol ID of the updated symbol.
+     * @throws std::runtime_error if the ticker is empty or a new symbol does not fit in the directory.
+     */
+    uint32_t apply(uint64_t ticker, double price, int32_t volume, uint64_t sequence) {
+        uint32_t id = directory_.intern(ticker);
+        if (id == states_.size()) states_.push_back(SymbolState{});
+        SymbolState& state = states_[id];
+        state.last_price = price;
+        state.total_volume += volume;
+        state.last_sequence = sequence;
+        state.last_volume = volume;
+        ++state.update_count;
+        sequence_ = sequence;
+        return id;
+    }
+
+    uint32_t apply(const MarketData& data, uint64_t sequence) {
+        return apply(packTicker(data.symbol), data.price, data.volume, sequence);
+    }
+
+    /**
+     * @brief Replaces the per-symbol table and sequence, e.g. from a snapshot.
+     * @param states SymbolState array in symbol ID order; count must match the directory size.
+     * @param count Number of entries.
+     * @param sequence Sequence number the state corresponds to.
+     */
+    void restoreStates(const SymbolState* states, size_t count, uint64_t sequence) {
+        states_.assign(states, states + count);
+        sequence_ = sequence;
+    }
+
+    /**
+     * @brief Makes this a copy of other, which must have the same capacity. The flat arrays are
+     * copied into storage reserved at construction, so this never allocates; used to hand a
+     * consistent state to a background snapshot writer.
+     * @throws std::runtime_error if the capacities differ.
+     */
+    void copyFrom(const MarketState& other) {
+        const SymbolDirectory& directory = other.directory_;
+        directory_.restore(directory.tickers().data(), directory.slotKeys().data(), directory.slotIds().data(),
+                           directory.size(), directory.slotKeys().size());
+        restoreStates(other.states_.data(), other.states_.size(), other.sequence_);
+    }
+
+    /**
+     * @brief Drops every symbol and resets the sequence to 0.
+     */
+    void clear() noexcept {
+        directory_.clear();
+        states_.clear();
+        sequence_ = 0;
+    }
+
+    SymbolDirectory& directory() noexcept { return directory_; }
+    const SymbolDirectory& directory() const noexcept { return directory_; }
+    const std::vector<SymbolState>& states() const noexcept { return states_; }
+
+    /**
+     * @brief Sequence number of the last applied update (0 if none).
+     */
+    uint64_t sequence() const noexcept { return sequence_; }
+
+private:
+    SymbolDirectory directory_;        ///< Ticker to symbol ID mapping.
+    std::vector<SymbolState> states_;  ///< State per symbol ID.
+    uint64_t sequence_ = 0;            ///< Last applied sequence number.
+};
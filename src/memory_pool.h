@@ -41,7 +41,7 @@ public:
      */
     ~MemoryPool() {
         if (storage_) {
-            delete[] storage_;
+            ::operator delete[](storage_, std::align_val_t{alignof(MarketData)}); // Matches the aligned new
         }
     }
 
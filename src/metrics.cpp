@@ -0,0 +1,109 @@
+#include "metrics.h"
+#include "clock.h"
+#include <cerrno>
+#include <new>
+#include <stdexcept>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief True if an existing segment under name belongs to a process that is still running.
+ *
+ * A segment without a pid yet is being initialised by its creator and counts as owned.
+ */
+bool segmentOwnerAlive(const std::string& name) {
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return errno != ENOENT;
+    struct stat st {};
+    uint32_t pid = 0;
+    if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(MetricsSegment)) {
+        void* addr = ::mmap(nullptr, sizeof(MetricsSegment), PROT_READ, MAP_SHARED, fd, 0);
+        if (addr != MAP_FAILED) {
+            pid = static_cast<const MetricsSegment*>(addr)->header.pid;
+            ::munmap(addr, sizeof(MetricsSegment));
+        }
+    }
+    ::close(fd);
+    if (pid == 0) return st.st_size != 0; // Empty: creator died before ftruncate
+    return ::kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH;
+}
+
+} // namespace
+
+/**
+ * @brief Creates the segment exclusively. A stale segment left by a crashed process is unlinked
+ * and replaced; a segment whose owner is still running is left alone and this process falls back
+ * to private counters, so a second instance never resets or unlinks a live one's metrics.
+ */
+SharedMetrics::SharedMetrics(uint64_t queue_capacity, std::string name) : name_(std::move(name)) {
+    void* addr = MAP_FAILED;
+    int fd = ::shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST && !segmentOwnerAlive(name_)) {
+        ::shm_unlink(name_.c_str());
+        fd = ::shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd >= 0) {
+        if (::ftruncate(fd, sizeof(MetricsSegment)) == 0) {
+            addr = ::mmap(nullptr, sizeof(MetricsSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (addr == MAP_FAILED) ::shm_unlink(name_.c_str());
+    }
+    if (addr != MAP_FAILED) {
+        shared_ = true;
+    } else {
+        addr = ::operator new(sizeof(MetricsSegment), std::align_val_t{alignof(MetricsSegment)});
+    }
+
+    segment_ = new (addr) MetricsSegment{};
+    segment_->header.pid = static_cast<uint32_t>(::getpid());
+    segment_->header.queue_capacity = queue_capacity;
+    segment_->header.ns_per_tick = TscClock::nsPerTick();
+    // Publish the version last: readers treat a zero version as "not initialised yet".
+    std::atomic_thread_fence(std::memory_order_release);
+    segment_->header.version = kMetricsVersion;
+}
+
+/**
+ * @brief Unmaps and unlinks the segment so stale metrics are never attached to. Only the owner
+ * unlinks: a process running on private counters leaves the live instance's segment in place.
+ */
+SharedMetrics::~SharedMetrics() {
+    if (shared_) {
+        ::munmap(segment_, sizeof(MetricsSegment));
+        ::shm_unlink(name_.c_str());
+    } else {
+        ::operator delete(segment_, std::align_val_t{alignof(MetricsSegment)});
+    }
+}
+
+/**
+ * @brief Opens the segment O_RDONLY and maps it PROT_READ, so a reader can never perturb it.
+ */
+MetricsReader::MetricsReader(const std::string& name) {
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) throw std::runtime_error("No metrics segment " + name + " (is hft_system running?)");
+    // An empty segment (creator not yet past ftruncate, or died before it) would SIGBUS on first read.
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(MetricsSegment)) {
+        ::close(fd);
+        throw std::runtime_error("Metrics segment " + name + " is not initialised yet");
+    }
+    void* addr = ::mmap(nullptr, sizeof(MetricsSegment), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) throw std::runtime_error("Failed to map metrics segment " + name);
+    segment_ = static_cast<const MetricsSegment*>(addr);
+    if (segment_->header.version != kMetricsVersion) {
+        ::munmap(addr, sizeof(MetricsSegment));
+        throw std::runtime_error("Unsupported metrics segment version");
+    }
+}
+
+MetricsReader::~MetricsReader() {
+    ::munmap(const_cast<MetricsSegment*>(segment_), sizeof(MetricsSegment));
+}
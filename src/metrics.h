@@ -0,0 +1,116 @@
+#pragma once
+#include "padded_counter.h"
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <string>
+
+/// Name of the POSIX shared-memory object published by hft_system.
+inline constexpr const char* kMetricsSegmentName = "/hft_system_metrics";
+inline constexpr uint32_t kMetricsVersion = 3;
+/// Latency histogram buckets; bucket i counts samples with bit_width(ns) == i.
+inline constexpr size_t kLatencyBuckets = 32;
+
+/**
+ * @brief Static description of the segment, written once at startup.
+ */
+struct alignas(kCacheLineSize) MetricsHeader {
+    uint32_t version;        ///< kMetricsVersion.
+    uint32_t pid;            ///< Process publishing the segment.
+    uint64_t queue_capacity; ///< Capacity of the data queue.
+    double ns_per_tick;      ///< TscClock calibration, for readers that see raw ticks.
+};
+
+/**
+ * @brief Counters written only by the producer thread.
+ *
+ * Cache-line aligned so producer writes never invalidate lines the consumer writes.
+ */
+struct alignas(kCacheLineSize) ProducerMetrics {
+    std::atomic<uint64_t> messages_pushed;    ///< Messages pushed to the data queue.
+    std::atomic<uint64_t> batches;            ///< Batches generated.
+    std::atomic<uint64_t> queue_full_retries; ///< Push attempts that found the queue full.
+    std::atomic<uint64_t> messages_filtered;  ///< Messages for unsubscribed symbols, never enqueued.
+};
+
+/**
+ * @brief Counters and latency histogram written only by the consumer thread.
+ */
+struct alignas(kCacheLineSize) ConsumerMetrics {
+    std::atomic<uint64_t> messages_processed; ///< Messages popped and processed.
+    std::atomic<uint64_t> empty_polls;        ///< Polls that found the queue empty.
+    std::atomic<uint64_t> symbols_dropped;    ///< Updates for new symbols dropped with the symbol directory full.
+    std::atomic<uint64_t> latency_buckets[kLatencyBuckets]; ///< Queue latency, log2(ns) buckets.
+
+    /**
+     * @brief Records one enqueue-to-dequeue latency sample.
+     */
+    void recordLatency(uint64_t nanos) noexcept {
+        size_t bucket = static_cast<size_t>(std::bit_width(nanos));
+        bumpCounter(latency_buckets[bucket < kLatencyBuckets ? bucket : kLatencyBuckets - 1]);
+    }
+};
+
+/**
+ * @brief Fixed layout of the shared-memory metrics segment.
+ *
+ * Each section occupies its own cache lines, so a hot thread only ever touches the lines it owns
+ * and an external reader can never cause a miss on anything else.
+ */
+struct MetricsSegment {
+    MetricsHeader header;
+    ProducerMetrics producer;
+    ConsumerMetrics consumer;
+};
+
+/**
+ * @brief Owner of the metrics segment in the publishing process.
+ *
+ * Creates and maps the shared-memory object, and unlinks it on destruction. If shared memory is
+ * unavailable, or another running process already owns the segment, the segment falls back to
+ * process-private memory, so hot threads always have valid counters to write to.
+ */
+class SharedMetrics {
+public:
+    /**
+     * @brief Creates the segment under name and initialises its header.
+     */
+    explicit SharedMetrics(uint64_t queue_capacity, std::string name = kMetricsSegmentName);
+    ~SharedMetrics();
+
+    SharedMetrics(const SharedMetrics&) = delete;
+    SharedMetrics& operator=(const SharedMetrics&) = delete;
+
+    MetricsSegment& segment() noexcept { return *segment_; }
+
+    /**
+     * @brief True if the segment is visible to other processes.
+     */
+    bool shared() const noexcept { return shared_; }
+
+private:
+    std::string name_;                 ///< Shared-memory object name.
+    MetricsSegment* segment_ = nullptr;///< Mapped (or private) segment.
+    bool shared_ = false;              ///< Whether segment_ is a shared mapping.
+};
+
+/**
+ * @brief Read-only attachment to a running process's metrics segment.
+ */
+class MetricsReader {
+public:
+    /**
+     * @brief Maps the segment read-only.
+     * @throws std::runtime_error if no segment exists or its version is unknown.
+     */
+    explicit MetricsReader(const std::string& name = kMetricsSegmentName);
+    ~MetricsReader();
+
+    MetricsReader(const MetricsReader&) = delete;
+    MetricsReader& operator=(const MetricsReader&) = delete;
+
+    const MetricsSegment& segment() const noexcept { return *segment_; }
+
+private:
+    const MetricsSegment* segment_ = nullptr; ///< Read-only mapping.
+};
@@ -0,0 +1,98 @@
+#include "nbbo_consolidator.h"
+#include "simd_kernels.h"
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <stdexcept>
+
+size_t NbboConsolidator::addVenue(VenueQuoteRing& ring) {
+    if (rings_.size() >= kMaxVenues) throw std::runtime_error("NbboConsolidator: too many venues");
+    rings_.push_back(&ring);
+    return rings_.size() - 1;
+}
+
+namespace {
+
+/// Sums sizes over the set bits of venues.
+int64_t sizeAt(const int64_t* sizes, uint64_t venues) noexcept {
+    int64_t size = 0;
+    for (; venues != 0; venues &= venues - 1) size += sizes[std::countr_zero(venues)];
+    return size;
+}
+
+/**
+ * @brief Folds one venue's new price and size on one side into that side of the NBBO.
+ * @tparam kBid True for bids (higher is better), false for asks.
+ * @param size New size at the venue (0 if its side is empty); old_size is the size it replaces.
+ * @return False if the venue left the best price as its only holder, so the side must be
+ * recomputed from every venue.
+ */
+template <bool kBid>
+bool foldSide(FixedPrice price, int64_t size, int64_t old_size, uint32_t bit, FixedPrice& best, int64_t& best_size,
+              uint32_t& venues) noexcept {
+    const bool quoted = size > 0;
+    if (quoted && (venues == 0 || (kBid ? price > best : price < best))) { // New best, alone
+        best = price;
+        best_size = size;
+        venues = bit;
+    } else if (quoted && price == best) { // Joins or stays at the best
+        best_size += size - ((venues & bit) != 0 ? old_size : 0);
+        venues |= bit;
+    } else if ((venues & bit) != 0) { // Left the best
+        venues &= ~bit;
+        best_size -= old_size;
+        if (venues == 0) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+const Nbbo* NbboConsolidator::apply(size_t venue, const VenueQuote& quote) {
+    uint32_t symbol = directory_.intern(quote.ticker);
+    if (symbol == books_.size()) {
+        VenueBook& book = books_.emplace_back(); // Sizes value-initialised to 0
+        std::fill(std::begin(book.bids), std::end(book.bids), INT64_MIN);
+        std::fill(std::begin(book.asks), std::end(book.asks), INT64_MAX);
+        nbbos_.push_back(Nbbo{quote.ticker});
+    }
+    ++quotes_;
+    VenueBook& book = books_[symbol];
+    const int64_t bid_size = std::max<int64_t>(quote.bid_size, 0), ask_size = std::max<int64_t>(quote.ask_size, 0);
+    const int64_t old_bid_size = book.bid_sizes[venue], old_ask_size = book.ask_sizes[venue];
+    book.bids[venue] = bid_size > 0 ? quote.bid : INT64_MIN;
+    book.asks[venue] = ask_size > 0 ? quote.ask : INT64_MAX;
+    book.bid_sizes[venue] = bid_size;
+    book.ask_sizes[venue] = ask_size;
+
+    Nbbo next = nbbos_[symbol];
+    const uint32_t bit = uint32_t{1} << venue;
+    const bool bid_folded =
+        foldSide<true>(quote.bid, bid_size, old_bid_size, bit, next.bid, next.bid_size, next.bid_venues);
+    const bool ask_folded =
+        foldSide<false>(quote.ask, ask_size, old_ask_size, bit, next.ask, next.ask_size, next.ask_venues);
+    if (!bid_folded || !ask_folded) {
+        // The only venue at the best backed off: rescan every venue for the new best.
+        const QuoteExtremes best = simd().best_quote(book.bids, book.asks, rings_.size());
+        ++rescans_;
+        if (!bid_folded) {
+            next.bid = best.bid != INT64_MIN ? best.bid : 0;
+            next.bid_venues = best.bid != INT64_MIN ? static_cast<uint32_t>(best.bid_mask) : 0;
+            next.bid_size = sizeAt(book.bid_sizes, next.bid_venues);
+        }
+        if (!ask_folded) {
+            next.ask = best.ask != INT64_MAX ? best.ask : 0;
+            next.ask_venues = best.ask != INT64_MAX ? static_cast<uint32_t>(best.ask_mask) : 0;
+            next.ask_size = sizeAt(book.ask_sizes, next.ask_venues);
+        }
+    }
+    if (next.bid_venues == 0) next.bid = 0;
+    if (next.ask_venues == 0) next.ask = 0;
+
+    Nbbo& current = nbbos_[symbol];
+    if (next.sameQuote(current)) return nullptr;
+    next.timestamp = quote.timestamp;
+    current = next;
+    ++published_;
+    return &current;
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include "fixed_price.h"
+#include "padded_counter.h"
+#include "spsc_ring.h"
+#include "symbol_directory.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Top of book for one symbol on one venue, as that venue's feed handler publishes it.
+ * A side with a size of 0 or below is empty.
+ */
+struct VenueQuote {
+    uint64_t ticker;    ///< Packed ticker (see packTicker).
+    FixedPrice bid;     ///< Best bid.
+    FixedPrice ask;     ///< Best ask.
+    int64_t bid_size;   ///< Quantity at the bid.
+    int64_t ask_size;   ///< Quantity at the ask.
+    uint64_t timestamp; ///< Feed timestamp, carried into the Nbbo it produces.
+};
+
+/**
+ * @brief Consolidated best bid and offer for one symbol across venues.
+ */
+struct Nbbo {
+    uint64_t ticker = 0;     ///< Packed ticker.
+    FixedPrice bid = 0;      ///< Highest bid on any venue (0 if no venue bids).
+    FixedPrice ask = 0;      ///< Lowest ask on any venue (0 if no venue offers).
+    int64_t bid_size = 0;    ///< Quantity at the bid summed over the venues quoting it.
+    int64_t ask_size = 0;    ///< Quantity at the ask summed over the venues quoting it.
+    uint32_t bid_venues = 0; ///< Bit per venue at the bid.
+    uint32_t ask_venues = 0; ///< Bit per venue at the ask.
+    uint64_t timestamp = 0;  ///< Timestamp of the venue quote that produced this NBBO.
+
+    /**
+     * @brief True if the prices, sizes and venues match (timestamps are ignored).
+     */
+    bool sameQuote(const Nbbo& other) const noexcept {
+        return bid == other.bid && ask == other.ask && bid_size == other.bid_size && ask_size == other.ask_size &&
+               bid_venues == other.bid_venues && ask_venues == other.ask_venues;
+    }
+};
+
+/// Ring carrying one venue's quotes from its feed thread to the consolidator.
+using VenueQuoteRing = SpscRing<VenueQuote, 4096>;
+
+/**
+ * @brief Consolidates per-venue top of book into an NBBO per symbol.
+ *
+ * Each venue feed pushes VenueQuotes into its own VenueQuoteRing; one consolidator thread drains
+ * the rings round-robin with poll(). Per symbol, the venues' bids, asks and sizes sit in parallel
+ * cache-line-aligned arrays (empty sides hold INT64_MIN bids / INT64_MAX asks). A quote is folded
+ * into the current NBBO with a few compares: a better price replaces the best, an equal one joins
+ * it, and a worse one matters only if the venue was at the best. When the only venue at the best
+ * backs off, the venues are rescanned with one SimdKernels::best_quote call (a vector max over the
+ * bids and min over the asks, plus the mask of venues at each). The result is published only if it
+ * differs from the symbol's previous NBBO, so venue quotes behind the touch never reach downstream
+ * consumers.
+ *
+ * poll() and apply() run on a single thread; each ring's producer is its venue's feed thread.
+ */
+class NbboConsolidator {
+public:
+    static constexpr size_t kMaxVenues = 16;
+
+    /**
+     * @brief Constructs a consolidator for up to max_symbols symbols.
+     */
+    explicit NbboConsolidator(size_t max_symbols) : directory_(max_symbols) {
+        books_.reserve(max_symbols);
+        nbbos_.reserve(max_symbols);
+    }
+
+    /**
+     * @brief Attaches a venue's quote ring; the ring must outlive the consolidator.
+     * @return Venue index, the bit position used in Nbbo::bid_venues/ask_venues.
+     * @throws std::runtime_error if kMaxVenues venues are already attached.
+     */
+    size_t addVenue(VenueQuoteRing& ring);
+
+    /**
+     * @brief Applies one venue's quote and recomputes the symbol's NBBO.
+     * @param venue Venue index from addVenue() (must be below venues()).
+     * @return The new NBBO if it changed, nullptr otherwise.
+     * @throws std::runtime_error if a new symbol does not fit in max_symbols.
+     */
+    const Nbbo* apply(size_t venue, const VenueQuote& quote);
+
+    /**
+     * @brief Drains up to max_per_venue quotes from each venue's ring, in venue order, calling
+     * publish(const Nbbo&) for every NBBO change. The bound keeps a busy venue from delaying the
+     * others' quotes.
+     * @return Number of quotes applied.
+     */
+    template <typename Publish>
+    size_t poll(Publish&& publish, size_t max_per_venue = 64) {
+        size_t applied = 0;
+        VenueQuote quote;
+        for (size_t venue = 0; venue < rings_.size(); ++venue) {
+            for (size_t n = 0; n < max_per_venue && rings_[venue]->pop(quote); ++n) {
+                if (const Nbbo* nbbo = apply(venue, quote)) publish(*nbbo);
+                ++applied;
+            }
+        }
+        return applied;
+    }
+
+    /**
+     * @brief Current NBBO of a packed ticker, or nullptr if no venue has quoted it.
+     */
+    const Nbbo* find(uint64_t ticker) const noexcept {
+        uint32_t symbol = directory_.find(ticker);
+        return symbol == kInvalidSymbol ? nullptr : &nbbos_[symbol];
+    }
+
+    size_t venues() const noexcept { return rings_.size(); }
+    size_t symbols() const noexcept { return directory_.size(); }
+    uint64_t quotes() const noexcept { return quotes_; }       ///< Venue quotes applied.
+    uint64_t published() const noexcept { return published_; } ///< NBBO changes returned.
+    uint64_t rescans() const noexcept { return rescans_; }     ///< Quotes that needed a best_quote rescan.
+
+private:
+    /// One symbol's top of book per venue, one array per field so best_quote reads contiguous prices.
+    struct alignas(kCacheLineSize) VenueBook {
+        FixedPrice bids[kMaxVenues];
+        FixedPrice asks[kMaxVenues];
+        int64_t bid_sizes[kMaxVenues];
+        int64_t ask_sizes[kMaxVenues];
+    };
+
+    SymbolDirectory directory_;          ///< Packed ticker to symbol index.
+    std::vector<VenueBook> books_;       ///< Per-venue quotes by symbol index.
+    std::vector<Nbbo> nbbos_;            ///< Last published NBBO by symbol index.
+    std::vector<VenueQuoteRing*> rings_; ///< Input ring per venue.
+    uint64_t quotes_ = 0;
+    uint64_t published_ = 0;
+    uint64_t rescans_ = 0;
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include "price_ladder.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief One level change applied to an OrderBook, for incremental consumers such as BookSignals.
+ */
+struct LevelDelta {
+    Side side;
+    size_t level;   ///< Level index in the side's ladder (see PriceLadder::priceOf).
+    int64_t before; ///< Quantity before the change (0 if the level was empty).
+    int64_t after;  ///< Quantity after the change (0 if the level was removed).
+};
+
+/**
+ * @brief Price-level book for one instrument: a bid and an ask PriceLadder over the same band.
+ *
+ * Every mutation returns the LevelDelta it caused, so signal calculators can follow the book
+ * without rescanning it.
+ */
+class OrderBook {
+public:
+    /**
+     * @brief Constructs an empty book for prices low, low + tick, ..., low + (levels - 1) * tick.
+     * @throws std::runtime_error if tick is not positive or levels is out of range.
+     */
+    OrderBook(FixedPrice low, FixedPrice tick, size_t levels)
+        : bids_(Side::Bid, low, tick, levels), asks_(Side::Ask, low, tick, levels) {}
+
+    /**
+     * @brief Sets a level's aggregate quantity, as a market-by-price feed reports it (0 removes).
+     * @throws std::runtime_error if price is outside the band or off the tick grid.
+     */
+    LevelDelta set(Side side, FixedPrice price, int64_t quantity) {
+        PriceLadder& ladder = this->side(side);
+        const size_t level = ladder.levelOf(price);
+        const int64_t before = ladder.quantityAt(level);
+        return {side, level, before, ladder.setLevel(level, quantity)};
+    }
+
+    /**
+     * @brief Adds quantity to a level (negative for cancels and fills).
+     * @throws std::runtime_error if price is outside the band or off the tick grid.
+     */
+    LevelDelta add(Side side, FixedPrice price, int64_t quantity) {
+        PriceLadder& ladder = this->side(side);
+        const size_t level = ladder.levelOf(price);
+        const int64_t before = ladder.quantityAt(level);
+        return {side, level, before, ladder.setLevel(level, before + quantity)};
+    }
+
+    PriceLadder& side(Side side) noexcept { return side == Side::Bid ? bids_ : asks_; }
+    const PriceLadder& side(Side side) const noexcept { return side == Side::Bid ? bids_ : asks_; }
+    const PriceLadder& bids() const noexcept { return bids_; }
+    const PriceLadder& asks() const noexcept { return asks_; }
+    FixedPrice tick() const noexcept { return bids_.tick(); }
+
+    void clear() noexcept {
+        bids_.clear();
+        asks_.clear();
+    }
+
+private:
+    PriceLadder bids_;
+    PriceLadder asks_;
+};
@@ -0,0 +1,135 @@
+#include "order_manager.h"
+#include <array>
+#include <stdexcept>
+
+namespace {
+
+/// Events of the transition table: ExecType with fills split by whether they complete the order.
+enum class OrderEvent : uint8_t { Ack, Reject, PartialFill, Fill, CancelAck, CancelReject };
+constexpr size_t kOrderEvents = 6;
+
+constexpr uint8_t kInvalid = 0xFF; ///< Table entry for a report that is not valid in the state.
+
+/**
+ * @brief next[state][event]: the state an order moves to, or kInvalid.
+ *
+ * Fills may arrive before the ack (some venues only send the execution), so they are accepted
+ * in PendingNew, and the ack that then follows is a no-op in PartiallyFilled (an order it finds
+ * Filled has been retired; see OrderManager::unacked_). Cancel replies are checked against
+ * Order::cancel_pending separately.
+ */
+constexpr std::array<std::array<uint8_t, kOrderEvents>, kOrderStates> makeTransitions() {
+    std::array<std::array<uint8_t, kOrderEvents>, kOrderStates> next{};
+    for (auto& row : next) row.fill(kInvalid);
+    auto set = [&](OrderState from, OrderEvent event, OrderState to) {
+        next[static_cast<size_t>(from)][static_cast<size_t>(event)] = static_cast<uint8_t>(to);
+    };
+    for (OrderState live : {OrderState::PendingNew, OrderState::New, OrderState::PartiallyFilled}) {
+        set(live, OrderEvent::PartialFill, OrderState::PartiallyFilled);
+        set(live, OrderEvent::Fill, OrderState::Filled);
+        set(live, OrderEvent::CancelAck, OrderState::Cancelled);
+        set(live, OrderEvent::CancelReject, live);
+    }
+    set(OrderState::PendingNew, OrderEvent::Ack, OrderState::New);
+    set(OrderState::PendingNew, OrderEvent::Reject, OrderState::Rejected);
+    set(OrderState::PartiallyFilled, OrderEvent::Ack, OrderState::PartiallyFilled);
+    return next;
+}
+
+constexpr auto kTransitions = makeTransitions();
+
+size_t checkedCapacity(size_t capacity) {
+    if (capacity == 0 || capacity > UINT32_MAX) {
+        throw std::runtime_error("OrderManager: capacity must be between 1 and 2^32 - 1");
+    }
+    return capacity;
+}
+
+} // namespace
+
+OrderManager::OrderManager(size_t capacity)
+    : orders_(checkedCapacity(capacity)), unacked_(capacity), generations_(capacity, 1) {
+    free_.reserve(capacity);
+    for (size_t slot = capacity; slot-- > 0;) free_.push_back(static_cast<uint32_t>(slot)); // Slot 0 on top
+}
+
+ClientOrderId OrderManager::submit(uint32_t symbol, Side side, FixedPrice price, int64_t quantity) noexcept {
+    if (free_.empty() || quantity <= 0) return kInvalidOrderId;
+    const uint32_t slot = free_.back();
+    free_.pop_back();
+    Order& order = orders_[slot];
+    order = Order{};
+    order.id = static_cast<ClientOrderId>(generations_[slot]) << 32 | slot;
+    order.symbol = symbol;
+    order.side = side;
+    order.price = price;
+    order.quantity = quantity;
+    return order.id;
+}
+
+bool OrderManager::requestCancel(ClientOrderId id) noexcept {
+    if (!valid(id) || orders_[slotOf(id)].cancel_pending) return false;
+    orders_[slotOf(id)].cancel_pending = true;
+    return true;
+}
+
+OrderUpdate OrderManager::onExecution(const ExecutionReport& report) noexcept {
+    if (!valid(report.id)) {
+        const uint32_t slot = slotOf(report.id);
+        if (report.type == ExecType::Ack && report.id != kInvalidOrderId && slot < unacked_.size() &&
+            unacked_[slot].id == report.id) {
+            unacked_[slot].id = kInvalidOrderId; // Late ack for an order that filled first: a no-op
+            Order order = unacked_[slot];
+            order.id = report.id;
+            return {ExecResult::Applied, OrderState::Filled, order};
+        }
+        ++ignored_;
+        return {ExecResult::UnknownOrder, OrderState::PendingNew, Order{}};
+    }
+    Order& order = orders_[slotOf(report.id)];
+    const OrderState previous = order.state;
+    OrderEvent event;
+    switch (report.type) {
+    case ExecType::Ack: event = OrderEvent::Ack; break;
+    case ExecType::Reject: event = OrderEvent::Reject; break;
+    case ExecType::Fill: event = report.quantity < order.leaves() ? OrderEvent::PartialFill : OrderEvent::Fill; break;
+    case ExecType::CancelAck: event = OrderEvent::CancelAck; break;
+    case ExecType::CancelReject: event = OrderEvent::CancelReject; break;
+    default: event = OrderEvent::Reject; break;
+    }
+    const uint8_t next = kTransitions[static_cast<size_t>(previous)][static_cast<size_t>(event)];
+    const bool fill = report.type == ExecType::Fill;
+    const bool cancel_reply = report.type == ExecType::CancelAck || report.type == ExecType::CancelReject;
+    if (next == kInvalid || (fill && (report.quantity <= 0 || report.quantity > order.leaves())) ||
+        (cancel_reply && !order.cancel_pending)) {
+        ++ignored_;
+        return {ExecResult::InvalidTransition, previous, order};
+    }
+    order.state = static_cast<OrderState>(next);
+    if (report.type == ExecType::Ack) order.acked = true;
+    if (fill) order.filled += report.quantity;
+    if (cancel_reply) order.cancel_pending = false;
+    OrderUpdate update{ExecResult::Applied, previous, order};
+    if (order.terminal()) release(order);
+    return update;
+}
+
+void OrderManager::release(Order& order) noexcept {
+    const uint32_t slot = slotOf(order.id);
+    if (order.state == OrderState::Filled && !order.acked) unacked_[slot] = order;
+    order.id = kInvalidOrderId;
+    if (++generations_[slot] == 0) generations_[slot] = 1; // IDs are never 0
+    free_.push_back(slot);
+}
+
+std::string_view orderStateName(OrderState state) noexcept {
+    switch (state) {
+    case OrderState::PendingNew: return "PendingNew";
+    case OrderState::New: return "New";
+    case OrderState::PartiallyFilled: return "PartiallyFilled";
+    case OrderState::Filled: return "Filled";
+    case OrderState::Cancelled: return "Cancelled";
+    case OrderState::Rejected: return "Rejected";
+    }
+    return "Unknown";
+}
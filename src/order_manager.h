@@ -0,0 +1,182 @@
+#pragma once
+#include "fixed_price.h"
+#include "price_ladder.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Client order ID: the order's pool slot in the low 32 bits and the slot's generation in
+ * the high 32. Exchanges echo it on every response, so it maps back to the order with a shift and
+ * a compare instead of a hash lookup. 0 is never issued.
+ */
+using ClientOrderId = uint64_t;
+inline constexpr ClientOrderId kInvalidOrderId = 0;
+
+enum class OrderState : uint8_t {
+    PendingNew,      ///< Sent, not yet acknowledged.
+    New,             ///< Acknowledged, nothing filled.
+    PartiallyFilled, ///< Some quantity filled, the rest working.
+    Filled,          ///< Terminal: fully filled.
+    Cancelled,       ///< Terminal: cancelled with quantity unfilled.
+    Rejected,        ///< Terminal: refused by the exchange.
+};
+inline constexpr size_t kOrderStates = 6;
+
+/// Exchange response kinds.
+enum class ExecType : uint8_t { Ack, Reject, Fill, CancelAck, CancelReject };
+
+/**
+ * @brief One exchange response for an order.
+ */
+struct ExecutionReport {
+    ClientOrderId id;  ///< Echoed client order ID.
+    ExecType type;
+    int64_t quantity;  ///< Fill quantity (Fill only).
+    FixedPrice price;  ///< Fill price (Fill only).
+};
+
+/**
+ * @brief An order as the manager tracks it.
+ */
+struct Order {
+    ClientOrderId id = kInvalidOrderId;
+    uint32_t symbol = 0;        ///< Caller's symbol ID (e.g. MarketState's).
+    Side side = Side::Bid;      ///< Bid buys, Ask sells.
+    OrderState state = OrderState::PendingNew;
+    bool cancel_pending = false; ///< A cancel was sent and not yet answered.
+    bool acked = false;          ///< The exchange acknowledged the order.
+    FixedPrice price = 0;
+    int64_t quantity = 0;       ///< Original quantity.
+    int64_t filled = 0;         ///< Cumulative filled quantity.
+
+    int64_t leaves() const noexcept { return quantity - filled; }
+    bool terminal() const noexcept { return state >= OrderState::Filled; }
+};
+
+/// Outcome of applying an ExecutionReport.
+enum class ExecResult : uint8_t {
+    Applied,           ///< The order moved (or stayed) as the report says.
+    UnknownOrder,      ///< No live order has this ID (never issued, or already terminal and recycled).
+    InvalidTransition, ///< The report is not valid in the order's state (or overfills it); ignored.
+};
+
+/**
+ * @brief Result of OrderManager::onExecution: the order after the report and the state it left.
+ */
+struct OrderUpdate {
+    ExecResult result;
+    OrderState previous; ///< State before the report (meaningful if Applied or InvalidTransition).
+    Order order;         ///< Copy of the order after the report; the slot is recycled if it is terminal.
+};
+
+/**
+ * @brief Tracks outbound orders from submission to a terminal state.
+ *
+ * Orders live in a fixed array of slots with a free list of slot indices, so submitting and
+ * retiring an order never touches the heap. Each slot carries a generation, bumped when the slot
+ * is recycled; the client order ID is (generation, slot), so a response is resolved by indexing
+ * the slot and comparing generations, and a late response for a recycled slot is recognised as
+ * unknown instead of corrupting the slot's new order.
+ *
+ * Transitions come from a constexpr table indexed by [state][event], where a fill is classified
+ * as partial or complete against the order's leaves quantity first. A pending cancel is a flag
+ * rather than a state, so fills that race the cancel still apply and a cancel reject leaves the
+ * state as it was. Orders reaching Filled, Cancelled or Rejected are returned to the pool at once.
+ *
+ * Fills may arrive before the ack (some venues only send the execution). The ack that follows
+ * is applied as a no-op in PartiallyFilled, and for an order that filled completely before its
+ * ack, the slot remembers the order until that ack arrives, so it is not counted as unknown.
+ *
+ * Owned by a single thread; not thread-safe.
+ */
+class OrderManager {
+public:
+    /**
+     * @brief Constructs a manager for up to capacity live orders.
+     * @throws std::runtime_error if capacity is 0 or does not fit in 32 bits.
+     */
+    explicit OrderManager(size_t capacity);
+
+    /**
+     * @brief Allocates a PendingNew order.
+     * @return The client order ID to send, or kInvalidOrderId if every slot is live or quantity
+     * is not positive.
+     */
+    ClientOrderId submit(uint32_t symbol, Side side, FixedPrice price, int64_t quantity) noexcept;
+
+    /**
+     * @brief Marks a cancel as sent.
+     * @return False if the order is not live or already has a cancel pending.
+     */
+    bool requestCancel(ClientOrderId id) noexcept;
+
+    /**
+     * @brief Applies an exchange response; no allocation or hashing.
+     */
+    OrderUpdate onExecution(const ExecutionReport& report) noexcept;
+
+    /**
+     * @brief The live order with this ID, or nullptr.
+     */
+    const Order* find(ClientOrderId id) const noexcept {
+        return valid(id) ? &orders_[slotOf(id)] : nullptr;
+    }
+
+    size_t live() const noexcept { return orders_.size() - free_.size(); }
+    size_t capacity() const noexcept { return orders_.size(); }
+    uint64_t ignored() const noexcept { return ignored_; } ///< Reports not Applied.
+
+private:
+    static constexpr uint32_t slotOf(ClientOrderId id) noexcept { return static_cast<uint32_t>(id); }
+
+    /// True if id names a live order: its slot exists and holds this generation.
+    bool valid(ClientOrderId id) const noexcept {
+        return id != kInvalidOrderId && slotOf(id) < orders_.size() && orders_[slotOf(id)].id == id;
+    }
+
+    void release(Order& order) noexcept;
+
+    std::vector<Order> orders_;         ///< Slot per order; id == kInvalidOrderId when free.
+    std::vector<Order> unacked_;        ///< Last order per slot that filled before its ack; id cleared once acked.
+    std::vector<uint32_t> generations_; ///< Generation per slot, never 0.
+    std::vector<uint32_t> free_;        ///< Free slot indices (a stack, so hot slots are reused).
+    uint64_t ignored_ = 0;
+};
+
+/**
+ * @brief Writes id as 16 upper-case hex digits (e.g. for a FIX ClOrdID field).
+ */
+inline void formatClientOrderId(ClientOrderId id, char (&out)[16]) noexcept {
+    constexpr char kDigits[] = "0123456789ABCDEF";
+    for (int i = 15; i >= 0; --i, id >>= 4) out[i] = kDigits[id & 0xF];
+}
+
+/**
+ * @brief Parses the 16-digit hex form written by formatClientOrderId.
+ * @return The ID, or kInvalidOrderId if text is not 16 hex digits.
+ */
+inline ClientOrderId parseClientOrderId(std::string_view text) noexcept {
+    if (text.size() != 16) return kInvalidOrderId;
+    ClientOrderId id = 0;
+    for (char c : text) {
+        uint64_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<uint64_t>(c - '0');
+        } else if (c >= 'A' && c <= 'F') {
+            digit = static_cast<uint64_t>(c - 'A' + 10);
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<uint64_t>(c - 'a' + 10);
+        } else {
+            return kInvalidOrderId;
+        }
+        id = id << 4 | digit;
+    }
+    return id;
+}
+
+/**
+ * @brief Name of a state, for logs.
+ */
+std::string_view orderStateName(OrderState state) noexcept;
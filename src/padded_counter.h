@@ -0,0 +1,104 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * @brief Cache line size assumed for padding.
+ *
+ * Fixed at 64 bytes (x86-64 and most ARM server cores) rather than
+ * std::hardware_destructive_interference_size, whose value GCC warns may differ between
+ * translation units compiled with different tuning flags.
+ */
+inline constexpr size_t kCacheLineSize = 64;
+
+/**
+ * @brief Adds to a counter that has exactly one writer thread.
+ *
+ * A relaxed load + store compiles to a plain add on x86 (no lock prefix), while still letting
+ * readers in other threads or processes observe untorn values.
+ */
+inline void bumpCounter(std::atomic<uint64_t>& counter, uint64_t amount = 1) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Wraps a value so it occupies one or more whole cache lines by itself.
+ *
+ * Writes to a CachePadded value never invalidate a line holding any other variable, which
+ * removes false sharing between fields written by different threads.
+ */
+template <typename T>
+struct alignas(kCacheLineSize) CachePadded {
+    T value{};
+};
+
+/**
+ * @brief Single-writer 64-bit counter alone on its cache line.
+ *
+ * One thread increments; any thread may read. Increments use bumpCounter(), so the writer
+ * pays for a plain add and the line is only shared when a reader actually looks.
+ */
+class alignas(kCacheLineSize) PaddedCounter {
+public:
+    PaddedCounter(uint64_t initial = 0) noexcept : value_(initial) {}
+
+    /**
+     * @brief Adds amount; must only be called from the owning thread.
+     */
+    void add(uint64_t amount = 1) noexcept { bumpCounter(value_, amount); }
+
+    PaddedCounter& operator++() noexcept {
+        add();
+        return *this;
+    }
+
+    /**
+     * @brief Reads the current value from any thread.
+     */
+    uint64_t load() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Overwrites the value, e.g. to reset before threads start.
+     */
+    void store(uint64_t value) noexcept { value_.store(value, std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value_; ///< Counter value; the rest of the line is padding.
+};
+static_assert(sizeof(PaddedCounter) == kCacheLineSize, "PaddedCounter must fill exactly one line");
+
+/**
+ * @brief Fixed set of per-thread statistics blocks, each on its own cache lines.
+ * @tparam Block Statistics struct owned by one thread (typically atomics updated with bumpCounter).
+ * @tparam MaxThreads Number of blocks.
+ *
+ * Each thread writes only the block at its own index; readers aggregate across blocks. This
+ * replaces a shared counter (and its cache-line ping-pong) with N private ones.
+ */
+template <typename Block, size_t MaxThreads>
+class PerThreadStats {
+public:
+    /**
+     * @brief Returns the block owned by thread_index.
+     * @throws std::out_of_range if thread_index >= MaxThreads.
+     */
+    Block& local(size_t thread_index) {
+        if (thread_index >= MaxThreads) throw std::out_of_range("PerThreadStats thread index");
+        return blocks_[thread_index].value;
+    }
+
+    /**
+     * @brief Invokes visit(const Block&) for every block, e.g. to sum counters.
+     */
+    template <typename Visit>
+    void forEach(Visit&& visit) const {
+        for (const auto& block : blocks_) visit(block.value);
+    }
+
+    static constexpr size_t size() noexcept { return MaxThreads; }
+
+private:
+    CachePadded<Block> blocks_[MaxThreads]; ///< One padded block per thread.
+};
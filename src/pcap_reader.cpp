@@ -0,0 +1,87 @@
+#include "pcap_reader.h"
+#include <stdexcept>
+#include <arpa/inet.h>
+
+/**
+ * @brief Maps the capture (sequential read-ahead, no prefault) and reads its file header.
+ */
+PcapReader::PcapReader(const std::string& path) : file_(path, false) {
+    if (file_.size() < 12) throw std::runtime_error("Capture too short: " + path);
+    uint32_t magic = load32(file_.data(), false);
+    if (magic == kPcapNgSectionHeader) {
+        format_ = CaptureFormat::PcapNg;
+        return;
+    }
+    format_ = CaptureFormat::Pcap;
+    if (magic == kPcapMagicMicros || magic == kPcapMagicNanos) {
+        swapped_ = false;
+    } else if (magic == __builtin_bswap32(kPcapMagicMicros) || magic == __builtin_bswap32(kPcapMagicNanos)) {
+        swapped_ = true;
+    } else {
+        throw std::runtime_error("Not a pcap or pcapng file: " + path);
+    }
+    if (file_.size() < 24) throw std::runtime_error("Capture too short: " + path);
+    nanos_ = load32(file_.data(), swapped_) == kPcapMagicNanos;
+    link_type_ = static_cast<uint16_t>(load32(file_.data() + 20, swapped_));
+}
+
+bool PcapReader::isCapture(const std::string& path) noexcept {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    uint32_t magic = 0;
+    bool read_ok = ::read(fd, &magic, sizeof(magic)) == static_cast<ssize_t>(sizeof(magic));
+    ::close(fd);
+    return read_ok && (magic == kPcapNgSectionHeader || magic == kPcapMagicMicros || magic == kPcapMagicNanos ||
+                       magic == __builtin_bswap32(kPcapMagicMicros) || magic == __builtin_bswap32(kPcapMagicNanos));
+}
+
+/**
+ * @brief Walks the IDB options for if_tsresol (code 9); the default resolution is microseconds.
+ */
+PcapReader::Interface PcapReader::parseInterface(const uint8_t* body, size_t length, bool swapped) noexcept {
+    Interface info{load16(body, swapped), 1000, 1};
+    size_t offset = 8; // link type, reserved, snap length
+    while (offset + 4 <= length) {
+        uint16_t code = load16(body + offset, swapped);
+        uint16_t option_length = load16(body + offset + 2, swapped);
+        if (code == 0) break; // opt_endofopt
+        if (code == 9 && option_length >= 1 && offset + 5 <= length) {
+            uint8_t resolution = body[offset + 4];
+            unsigned exponent = resolution & 0x7f;
+            if (resolution & 0x80) { // 2^-exponent seconds
+                info.ns_multiplier = 1'000'000'000;
+                info.ns_divisor = uint64_t{1} << std::min(exponent, 63u);
+            } else {                 // 10^-exponent seconds
+                info.ns_multiplier = 1;
+                info.ns_divisor = 1;
+                for (unsigned i = exponent; i < 9; ++i) info.ns_multiplier *= 10;
+                for (unsigned i = 9; i < std::min(exponent, 19u); ++i) info.ns_divisor *= 10;
+            }
+        }
+        offset += 4 + ((option_length + 3u) & ~3u);
+    }
+    return info;
+}
+
+std::optional<CaptureFilter> CaptureFilter::parse(std::string_view text) {
+    CaptureFilter filter;
+    size_t colon = text.find(':');
+    std::string_view group = text.substr(0, colon);
+    if (!group.empty()) {
+        in_addr address{};
+        if (::inet_pton(AF_INET, std::string(group).c_str(), &address) != 1) return std::nullopt;
+        filter.group = ntohl(address.s_addr);
+    }
+    if (colon != std::string_view::npos) {
+        std::string_view port = text.substr(colon + 1);
+        unsigned value = 0;
+        if (port.empty() || port.size() > 5) return std::nullopt;
+        for (char c : port) {
+            if (c < '0' || c > '9') return std::nullopt;
+            value = value * 10 + static_cast<unsigned>(c - '0');
+        }
+        if (value > 65535) return std::nullopt;
+        filter.port = static_cast<uint16_t>(value);
+    }
+    return filter;
+}
@@ -0,0 +1,266 @@
+#pragma once
+#include "mapped_file.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Capture file constants (libpcap and pcapng formats).
+constexpr uint32_t kPcapMagicMicros = 0xa1b2c3d4;       ///< Classic pcap, microsecond timestamps.
+constexpr uint32_t kPcapMagicNanos = 0xa1b23c4d;        ///< Classic pcap, nanosecond timestamps.
+constexpr uint32_t kPcapNgSectionHeader = 0x0a0d0d0a;   ///< pcapng Section Header Block type.
+constexpr uint32_t kPcapNgByteOrderMagic = 0x1a2b3c4d;  ///< pcapng section byte-order magic.
+constexpr uint32_t kPcapNgInterfaceBlock = 1;           ///< Interface Description Block.
+constexpr uint32_t kPcapNgSimplePacketBlock = 3;        ///< Simple Packet Block.
+constexpr uint32_t kPcapNgEnhancedPacketBlock = 6;      ///< Enhanced Packet Block.
+constexpr uint16_t kLinkTypeEthernet = 1;               ///< DLT_EN10MB.
+constexpr uint16_t kLinkTypeRaw = 101;                  ///< Raw IP, no link header.
+constexpr uint16_t kLinkTypeLinuxSll = 113;             ///< Linux "cooked" capture (tcpdump -i any).
+constexpr uint16_t kLinkTypeIpv4 = 228;                 ///< Raw IPv4.
+
+enum class CaptureFormat { Pcap, PcapNg };
+
+/**
+ * @brief One UDP datagram found in a capture; payload points into the mapped file.
+ */
+struct UdpDatagram {
+    const uint8_t* payload; ///< UDP payload (may be clipped by the capture snap length).
+    size_t size;            ///< Payload bytes available.
+    uint64_t timestamp_ns;  ///< Capture timestamp, nanoseconds since the epoch (0 if the block has none).
+    uint32_t src_addr;      ///< Source IPv4 address, host byte order.
+    uint32_t dst_addr;      ///< Destination IPv4 address (the multicast group), host byte order.
+    uint16_t src_port;      ///< Source UDP port.
+    uint16_t dst_port;      ///< Destination UDP port.
+};
+
+/**
+ * @brief Selects datagrams by destination group and port; zero fields match anything.
+ */
+struct CaptureFilter {
+    uint32_t group = 0; ///< Destination IPv4 address, host byte order; 0 matches any.
+    uint16_t port = 0;  ///< Destination UDP port; 0 matches any.
+
+    bool matches(uint32_t dst_addr, uint16_t dst_port) const noexcept {
+        return (group == 0 || group == dst_addr) && (port == 0 || port == dst_port);
+    }
+
+    /**
+     * @brief Parses "group:port", "group" or ":port" (e.g. "239.1.1.1:30001").
+     */
+    static std::optional<CaptureFilter> parse(std::string_view text);
+};
+
+/**
+ * @brief Per-walk counters.
+ */
+struct CaptureStats {
+    uint64_t frames = 0;    ///< Packet records read.
+    uint64_t udp = 0;       ///< IPv4/UDP datagrams (unfragmented) found.
+    uint64_t matched = 0;   ///< Datagrams passed to the callback.
+    uint64_t skipped = 0;   ///< Frames that are not IPv4/UDP, are fragments or use an unsupported link type.
+    uint64_t truncated = 0; ///< Records cut short by the end of file or malformed lengths.
+};
+
+/**
+ * @brief Dependency-free, memory-mapped pcap/pcapng reader for UDP feed captures.
+ *
+ * Walks classic pcap (either byte order, micro- or nanosecond timestamps) and pcapng (multiple
+ * sections and interfaces, any if_tsresol), decodes Ethernet (including 802.1Q/QinQ tags),
+ * Linux cooked and raw IP link layers, then IPv4 and UDP, and hands each matching payload to a
+ * callback in place. Nothing is copied and no per-packet allocation happens, so a walk runs at
+ * the speed pages arrive; the file is mapped for sequential read-ahead rather than prefaulted,
+ * so multi-GB captures start streaming immediately.
+ */
+class PcapReader {
+public:
+    /**
+     * @brief Maps a capture file and validates its header.
+     * @throws std::runtime_error if the file cannot be mapped or is not pcap/pcapng.
+     */
+    explicit PcapReader(const std::string& path);
+
+    /**
+     * @brief True if the file starts with a pcap or pcapng magic number.
+     */
+    static bool isCapture(const std::string& path) noexcept;
+
+    CaptureFormat format() const noexcept { return format_; }
+    size_t size() const noexcept { return file_.size(); }
+
+    /**
+     * @brief Invokes fn(const UdpDatagram&) for every datagram matching filter, in file order.
+     * @return Counters for the walk.
+     */
+    template <typename Fn>
+    CaptureStats forEachUdp(const CaptureFilter& filter, Fn&& fn) const {
+        CaptureStats stats;
+        auto handle = [&](uint16_t link_type, const uint8_t* frame, size_t length, uint64_t timestamp_ns) {
+            ++stats.frames;
+            UdpDatagram datagram;
+            if (!parseFrame(link_type, frame, length, datagram)) {
+                ++stats.skipped;
+                return;
+            }
+            ++stats.udp;
+            if (!filter.matches(datagram.dst_addr, datagram.dst_port)) return;
+            ++stats.matched;
+            datagram.timestamp_ns = timestamp_ns;
+            fn(static_cast<const UdpDatagram&>(datagram));
+        };
+        if (format_ == CaptureFormat::Pcap) {
+            walkPcap(handle, stats);
+        } else {
+            walkPcapNg(handle, stats);
+        }
+        return stats;
+    }
+
+    /**
+     * @brief Extracts the UDP datagram from one link-layer frame.
+     * @return False if the frame is not an unfragmented IPv4/UDP packet on a supported link type.
+     */
+    static bool parseFrame(uint16_t link_type, const uint8_t* frame, size_t length, UdpDatagram& out) noexcept {
+        size_t offset = 0;
+        uint16_t ether_type = 0x0800;
+        switch (link_type) {
+        case kLinkTypeEthernet:
+            if (length < 14) return false;
+            ether_type = loadBe16(frame + 12);
+            offset = 14;
+            while ((ether_type == 0x8100 || ether_type == 0x88a8) && length >= offset + 4) { // VLAN tags
+                ether_type = loadBe16(frame + offset + 2);
+                offset += 4;
+            }
+            break;
+        case kLinkTypeLinuxSll:
+            if (length < 16) return false;
+            ether_type = loadBe16(frame + 14);
+            offset = 16;
+            break;
+        case kLinkTypeRaw:
+        case kLinkTypeIpv4:
+            break;
+        default:
+            return false;
+        }
+        if (ether_type != 0x0800 || length < offset + 20) return false;
+
+        const uint8_t* ip = frame + offset;
+        size_t header_length = static_cast<size_t>(ip[0] & 0x0f) * 4;
+        if ((ip[0] >> 4) != 4 || header_length < 20 || ip[9] != 17) return false;  // IPv4/UDP only
+        if ((loadBe16(ip + 6) & 0x3fff) != 0) return false;                          // Fragments
+        size_t ip_length = std::min<size_t>(loadBe16(ip + 2), length - offset);
+        if (ip_length < header_length + 8) return false;
+
+        const uint8_t* udp = ip + header_length;
+        size_t udp_length = loadBe16(udp + 4);
+        if (udp_length < 8) return false;
+        out.payload = udp + 8;
+        out.size = std::min(udp_length, ip_length - header_length) - 8;
+        out.timestamp_ns = 0;
+        out.src_addr = loadBe32(ip + 12);
+        out.dst_addr = loadBe32(ip + 16);
+        out.src_port = loadBe16(udp);
+        out.dst_port = loadBe16(udp + 2);
+        return true;
+    }
+
+private:
+    /// pcapng interface: link type and the ratio converting its timestamp units to nanoseconds.
+    struct Interface {
+        uint16_t link_type;
+        uint64_t ns_multiplier;
+        uint64_t ns_divisor;
+    };
+
+    static uint16_t loadBe16(const uint8_t* p) noexcept { return static_cast<uint16_t>(p[0] << 8 | p[1]); }
+    static uint32_t loadBe32(const uint8_t* p) noexcept {
+        return static_cast<uint32_t>(p[0]) << 24 | static_cast<uint32_t>(p[1]) << 16 |
+               static_cast<uint32_t>(p[2]) << 8 | p[3];
+    }
+    /// Loads a file-order field; `swapped` when the file's byte order differs from the host's.
+    static uint16_t load16(const uint8_t* p, bool swapped) noexcept {
+        uint16_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return swapped ? __builtin_bswap16(value) : value;
+    }
+    static uint32_t load32(const uint8_t* p, bool swapped) noexcept {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return swapped ? __builtin_bswap32(value) : value;
+    }
+
+    /**
+     * @brief Reads an Interface Description Block body (link type and if_tsresol).
+     */
+    static Interface parseInterface(const uint8_t* body, size_t length, bool swapped) noexcept;
+
+    template <typename Handle>
+    void walkPcap(Handle& handle, CaptureStats& stats) const {
+        const uint8_t* cursor = file_.data() + 24;
+        const uint8_t* const end = file_.data() + file_.size();
+        while (end - cursor >= 16) {
+            uint64_t seconds = load32(cursor, swapped_);
+            uint64_t fraction = load32(cursor + 4, swapped_);
+            size_t captured = load32(cursor + 8, swapped_);
+            cursor += 16;
+            if (captured > static_cast<size_t>(end - cursor)) {
+                ++stats.truncated;
+                break;
+            }
+            handle(link_type_, cursor, captured, seconds * 1'000'000'000 + (nanos_ ? fraction : fraction * 1000));
+            cursor += captured;
+        }
+    }
+
+    template <typename Handle>
+    void walkPcapNg(Handle& handle, CaptureStats& stats) const {
+        const uint8_t* cursor = file_.data();
+        const uint8_t* const end = file_.data() + file_.size();
+        bool swapped = false;
+        std::vector<Interface> interfaces; // Per section
+        while (end - cursor >= 12) {
+            uint32_t type = load32(cursor, swapped);
+            if (type == kPcapNgSectionHeader) { // Palindromic type: readable in either byte order
+                swapped = load32(cursor + 8, false) != kPcapNgByteOrderMagic;
+                interfaces.clear();
+            }
+            size_t length = load32(cursor + 4, swapped);
+            if (length < 12 || length % 4 != 0 || length > static_cast<size_t>(end - cursor)) {
+                ++stats.truncated;
+                break;
+            }
+            const uint8_t* body = cursor + 8;
+            size_t body_length = length - 12;
+            if (type == kPcapNgEnhancedPacketBlock && body_length >= 20) {
+                uint32_t interface = load32(body, swapped);
+                uint64_t units = static_cast<uint64_t>(load32(body + 4, swapped)) << 32 | load32(body + 8, swapped);
+                size_t captured = load32(body + 12, swapped);
+                if (interface < interfaces.size() && captured <= body_length - 20) {
+                    const Interface& info = interfaces[interface];
+                    auto nanos = static_cast<uint64_t>(static_cast<unsigned __int128>(units) * info.ns_multiplier /
+                                                       info.ns_divisor);
+                    handle(info.link_type, body + 20, captured, nanos);
+                } else {
+                    ++stats.truncated;
+                }
+            } else if (type == kPcapNgSimplePacketBlock && body_length >= 4 && !interfaces.empty()) {
+                size_t captured = std::min<size_t>(load32(body, swapped), body_length - 4);
+                handle(interfaces[0].link_type, body + 4, captured, 0);
+            } else if (type == kPcapNgInterfaceBlock && body_length >= 8) {
+                interfaces.push_back(parseInterface(body, body_length, swapped));
+            }
+            cursor += length;
+        }
+    }
+
+    MappedFile file_;          ///< Sequentially advised mapping of the capture.
+    CaptureFormat format_;
+    bool swapped_ = false;     ///< Classic pcap written in the other byte order.
+    bool nanos_ = false;       ///< Classic pcap with nanosecond timestamps.
+    uint16_t link_type_ = 0;   ///< Classic pcap link type.
+};
@@ -0,0 +1,151 @@
+#pragma once
+#include "symbol_directory.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+/**
+ * @brief Collision-free ticker lookup for a symbol universe fixed at build time.
+ *
+ * Built by hash-and-displace: keys are mixed once, split into small buckets, and each bucket gets
+ * a multiplier chosen so all of its keys land in slots no earlier bucket took. A lookup is one mix,
+ * one multiplier load, one multiply-shift and a single compare of the slot's packed ticker with
+ * the key; there is no probing and no string hashing. The table is at most 75% full.
+ *
+ * Construction is constexpr, so a universe known at compile time (see symbol_universe.h) costs
+ * nothing at startup; failing to find a table, or a duplicate ticker, is a compile error there and
+ * std::logic_error at run time. IDs are positions in the input list, dense from 0, so per-symbol
+ * state can live in flat arrays exactly as with SymbolDirectory.
+ */
+template <size_t N>
+class PerfectSymbolTable {
+    static_assert(N > 0, "PerfectSymbolTable needs at least one symbol");
+
+public:
+    /// Slot count: a power of two keeping the load factor at or below 75%.
+    static constexpr size_t kSlots = std::bit_ceil(N * 4 / 3 + 1);
+    /// Bucket count: a power of two averaging about two keys per bucket.
+    static constexpr size_t kBuckets = std::bit_ceil(N / 2 + 1);
+
+    /**
+     * @brief Builds the table from packed tickers (see packTicker), all non-zero and distinct.
+     * @throws std::logic_error on a zero or duplicate key, or if no multiplier fits a bucket.
+     */
+    constexpr explicit PerfectSymbolTable(const std::array<uint64_t, N>& keys) {
+        // Largest buckets first, while most slots are still free.
+        std::array<uint32_t, N> order{};
+        std::array<uint32_t, kBuckets> bucket_sizes{};
+        for (size_t i = 0; i < N; ++i) {
+            if (keys[i] == 0) throw std::logic_error("PerfectSymbolTable: empty ticker");
+            order[i] = static_cast<uint32_t>(i);
+            ++bucket_sizes[bucketOf(mix(keys[i]))];
+        }
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            size_t bucket_a = bucketOf(mix(keys[a]));
+            size_t bucket_b = bucketOf(mix(keys[b]));
+            if (bucket_sizes[bucket_a] != bucket_sizes[bucket_b]) return bucket_sizes[bucket_a] > bucket_sizes[bucket_b];
+            return bucket_a < bucket_b;
+        });
+
+        std::array<bool, kSlots> taken{};
+        slot_ids_.fill(kInvalidSymbol); // So key 0 (empty ticker), which matches empty slots, finds nothing
+        for (size_t begin = 0; begin < N;) {
+            size_t bucket = bucketOf(mix(keys[order[begin]]));
+            size_t end = begin + bucket_sizes[bucket];
+            if (end - begin > kMaxBucket) throw std::logic_error("PerfectSymbolTable: bucket too large");
+            for (size_t i = begin; i < end; ++i) {
+                for (size_t j = begin; j < i; ++j) {
+                    if (keys[order[i]] == keys[order[j]]) throw std::logic_error("PerfectSymbolTable: duplicate ticker");
+                }
+            }
+            uint64_t state = bucket;
+            for (size_t attempt = 0;; ++attempt) {
+                if (attempt == kMaxAttempts) throw std::logic_error("PerfectSymbolTable: no perfect hash found");
+                uint64_t multiplier = splitmix(state) | 1;
+                std::array<size_t, kMaxBucket> slots{};
+                bool fits = true;
+                for (size_t i = begin; i < end && fits; ++i) {
+                    slots[i - begin] = slotOf(mix(keys[order[i]]), multiplier);
+                    fits = !taken[slots[i - begin]];
+                    for (size_t j = 0; j < i - begin && fits; ++j) fits = slots[j] != slots[i - begin];
+                }
+                if (!fits) continue;
+                multipliers_[bucket] = multiplier;
+                for (size_t i = begin; i < end; ++i) {
+                    taken[slots[i - begin]] = true;
+                    slot_keys_[slots[i - begin]] = keys[order[i]];
+                    slot_ids_[slots[i - begin]] = order[i];
+                }
+                break;
+            }
+            begin = end;
+        }
+        for (size_t i = 0; i < N; ++i) tickers_[i] = keys[i];
+    }
+
+    /**
+     * @brief Looks up a packed ticker with a single slot compare.
+     * @return Symbol ID (position in the input list), or kInvalidSymbol if not in the universe
+     * (including key 0, the empty ticker).
+     */
+    constexpr uint32_t find(uint64_t key) const noexcept {
+        uint64_t hashed = mix(key);
+        size_t slot = slotOf(hashed, multipliers_[bucketOf(hashed)]);
+        return slot_keys_[slot] == key ? slot_ids_[slot] : kInvalidSymbol;
+    }
+
+    constexpr uint32_t find(std::string_view ticker) const noexcept { return find(packTicker(ticker)); }
+
+    /**
+     * @brief Returns the packed ticker for a symbol ID.
+     */
+    constexpr uint64_t ticker(uint32_t id) const noexcept { return tickers_[id]; }
+
+    static constexpr size_t size() noexcept { return N; }
+
+private:
+    static constexpr size_t kMaxAttempts = 1 << 16; ///< Multipliers tried per bucket before giving up.
+    static constexpr size_t kMaxBucket = 32;        ///< Far beyond any bucket at two keys on average.
+
+    /// Murmur3 finaliser: spreads every ticker byte over all 64 bits.
+    static constexpr uint64_t mix(uint64_t key) noexcept {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        return key ^ (key >> 33);
+    }
+
+    static constexpr uint64_t splitmix(uint64_t& state) noexcept {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    static constexpr size_t bucketOf(uint64_t hashed) noexcept { return hashed & (kBuckets - 1); }
+
+    /// Multiply-shift on the mixed key: high bits of the product select the slot.
+    static constexpr size_t slotOf(uint64_t hashed, uint64_t multiplier) noexcept {
+        return static_cast<size_t>((hashed * multiplier) >> (64 - std::countr_zero(kSlots)));
+    }
+
+    std::array<uint64_t, kBuckets> multipliers_{}; ///< Displacement multiplier per bucket.
+    std::array<uint64_t, kSlots> slot_keys_{};     ///< Packed ticker per slot, 0 when empty.
+    std::array<uint32_t, kSlots> slot_ids_{};      ///< Symbol ID per slot, kInvalidSymbol when empty.
+    std::array<uint64_t, N> tickers_{};            ///< Packed ticker per symbol ID.
+};
+
+/**
+ * @brief Builds a PerfectSymbolTable from ticker strings; usable in constant expressions.
+ */
+template <size_t N>
+constexpr PerfectSymbolTable<N> makePerfectSymbolTable(const std::array<std::string_view, N>& tickers) {
+    std::array<uint64_t, N> keys{};
+    for (size_t i = 0; i < N; ++i) keys[i] = packTicker(tickers[i]);
+    return PerfectSymbolTable<N>(keys);
+}
@@ -0,0 +1,51 @@
+#include "position_tracker.h"
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+void PositionTracker::onFill(uint32_t symbol, int64_t quantity, double price) {
+    if (symbol >= quantities_.size()) throw std::runtime_error("PositionTracker: symbol ID out of range");
+    if (quantity == 0) return;
+    int64_t& position = quantities_[symbol];
+    double& cost = average_costs_[symbol];
+    const int64_t held = std::abs(position), filled = std::abs(quantity);
+    if (position == 0 || (position > 0) == (quantity > 0)) { // Opening or adding
+        cost = (cost * static_cast<double>(held) + price * static_cast<double>(filled)) / static_cast<double>(held + filled);
+    } else { // Reducing, closing or flipping
+        const double pnl = static_cast<double>(std::min(held, filled)) * (price - cost) * (position > 0 ? 1.0 : -1.0);
+        realized_[symbol] += pnl;
+        realized_total_ += pnl;
+        if (filled > held) {
+            cost = price; // The remainder opens a new position at the fill price
+        } else if (filled == held) {
+            cost = 0;
+        }
+    }
+    position += quantity;
+    if (marks_[symbol] == 0) marks_[symbol] = price;
+
+    uint32_t& slot = active_slots_[symbol];
+    if (position != 0 && slot == npos) {
+        slot = static_cast<uint32_t>(active_.size());
+        active_.push_back(symbol);
+    } else if (position == 0 && slot != npos) {
+        const uint32_t moved = active_.back(); // Swap-remove keeps the list compact
+        active_[slot] = moved;
+        active_slots_[moved] = slot;
+        active_.pop_back();
+        slot = npos;
+    }
+    unrealized_[symbol] = static_cast<double>(position) * (marks_[symbol] - cost);
+    resum();
+    publish();
+}
+
+void PositionTracker::resum() noexcept {
+    double unrealized = 0, exposure = 0;
+    for (uint32_t symbol : active_) {
+        unrealized += unrealized_[symbol];
+        exposure += std::fabs(static_cast<double>(quantities_[symbol])) * marks_[symbol];
+    }
+    unrealized_total_ = unrealized;
+    exposure_total_ = exposure;
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include "seqlock.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Account-level PnL published by PositionTracker.
+ */
+struct AccountPnl {
+    double realized = 0;         ///< Realised PnL over all symbols.
+    double unrealized = 0;       ///< Open positions marked to their last price.
+    double gross_exposure = 0;   ///< Sum of |position| x mark.
+    uint64_t open_positions = 0; ///< Symbols with a non-zero position.
+    uint64_t updates = 0;        ///< Fills and marks applied.
+
+    double total() const noexcept { return realized + unrealized; }
+};
+
+/**
+ * @brief One symbol's position as PositionTracker holds it.
+ */
+struct Position {
+    int64_t quantity = 0;     ///< Signed: long above 0, short below.
+    double average_cost = 0;  ///< Average price of the open quantity (0 when flat).
+    double realized = 0;      ///< PnL locked in by closing fills.
+    double unrealized = 0;    ///< quantity x (mark - average_cost).
+    double mark = 0;          ///< Last tick price (the first fill's price until a tick arrives).
+};
+
+/**
+ * @brief Per-symbol positions and PnL, updated on fills and marked to market on ticks.
+ *
+ * Quantities, average costs, realised and unrealised PnL and marks live in flat arrays indexed by
+ * symbol ID (e.g. MarketState's). Symbols with an open position are kept in a compact active list
+ * (with a slot per symbol for O(1) removal), so a tick for a flat symbol is one store and a tick
+ * for an open one a multiply and a few additions to the account totals. Fills use the average
+ * cost method: adding to a position re-averages the cost, reducing it realises PnL against the
+ * average, and a fill through zero opens the remainder at the fill price. Each fill re-sums the
+ * account totals over the active list, so the incremental drift of tick updates stays bounded.
+ *
+ * Updated by a single thread. After every change the account totals are published through a
+ * SeqLock, so a risk thread can read account() at any time without locks and without touching
+ * the writer's cache lines.
+ */
+class PositionTracker {
+public:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    /**
+     * @brief Constructs a flat tracker for symbol IDs below max_symbols.
+     */
+    explicit PositionTracker(size_t max_symbols)
+        : quantities_(max_symbols), average_costs_(max_symbols), realized_(max_symbols), unrealized_(max_symbols),
+          marks_(max_symbols), active_slots_(max_symbols, npos) {
+        active_.reserve(max_symbols);
+    }
+
+    /**
+     * @brief Applies an execution.
+     * @param quantity Signed fill quantity: positive buys, negative sells.
+     * @throws std::runtime_error if symbol is not below max_symbols.
+     */
+    void onFill(uint32_t symbol, int64_t quantity, double price);
+
+    /**
+     * @brief Records a trade price and, if the symbol has a position, marks it to market.
+     * @param symbol Symbol ID below max_symbols.
+     */
+    void onTick(uint32_t symbol, double price) noexcept {
+        const double previous = marks_[symbol];
+        marks_[symbol] = price;
+        if (active_slots_[symbol] == npos) return;
+        const double quantity = static_cast<double>(quantities_[symbol]);
+        const double unrealized = quantity * (price - average_costs_[symbol]);
+        unrealized_total_ += unrealized - unrealized_[symbol];
+        unrealized_[symbol] = unrealized;
+        exposure_total_ += std::fabs(quantity) * (price - previous);
+        publish();
+    }
+
+    Position position(uint32_t symbol) const noexcept {
+        return {quantities_[symbol], average_costs_[symbol], realized_[symbol], unrealized_[symbol], marks_[symbol]};
+    }
+
+    /**
+     * @brief Symbol IDs with a non-zero position, in no particular order.
+     */
+    std::span<const uint32_t> active() const noexcept { return active_; }
+
+    size_t capacity() const noexcept { return quantities_.size(); }
+
+    /**
+     * @brief Latest account totals; safe to call from any thread.
+     */
+    AccountPnl account() const noexcept { return account_.load(); }
+
+private:
+    /// Re-sums unrealised PnL and gross exposure over the active list.
+    void resum() noexcept;
+
+    void publish() noexcept {
+        account_.store(AccountPnl{realized_total_, unrealized_total_, exposure_total_, active_.size(), ++updates_});
+    }
+
+    std::vector<int64_t> quantities_;     ///< Signed position per symbol ID.
+    std::vector<double> average_costs_;   ///< Average cost of the open quantity per symbol ID.
+    std::vector<double> realized_;        ///< Realised PnL per symbol ID.
+    std::vector<double> unrealized_;      ///< Unrealised PnL per symbol ID (0 when flat).
+    std::vector<double> marks_;           ///< Last price per symbol ID (0 if none yet).
+    std::vector<uint32_t> active_slots_;  ///< Index in active_ per symbol ID, npos when flat.
+    std::vector<uint32_t> active_;        ///< Symbol IDs with a non-zero position.
+    double realized_total_ = 0;
+    double unrealized_total_ = 0;
+    double exposure_total_ = 0;
+    uint64_t updates_ = 0;
+    SeqLock<AccountPnl> account_;         ///< Totals for readers on other threads.
+};
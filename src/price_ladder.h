@@ -0,0 +1,322 @@
+#pragma once
+#include "fixed_price.h"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+/// Side of a book.
+enum class Side : uint8_t { Bid, Ask };
+
+/**
+ * @brief Set of level indices in [0, size) with next/previous-set-bit search in a few
+ * instructions per tree level.
+ *
+ * Bits live in 64-bit leaf words; each summary level holds one bit per non-empty word of the
+ * level below, up to a single root word. A search masks off the bits before (or after) its
+ * start in the leaf word, climbs only while the remaining words are empty, and descends along
+ * first (or last) set bits with tzcnt (or lzcnt). Three levels cover 262144 price levels, so a
+ * search never touches more than six words however wide the gaps in the book.
+ */
+class LevelBitmap {
+public:
+    static constexpr size_t npos = SIZE_MAX;
+    static constexpr size_t kMaxDepth = 4; ///< Up to 64^4 (16.7M) levels.
+
+    /**
+     * @brief Constructs an empty bitmap of size levels.
+     * @throws std::runtime_error if size is 0 or above 64^kMaxDepth.
+     */
+    explicit LevelBitmap(size_t size) : size_(size) {
+        if (size == 0 || size > (size_t{1} << (6 * kMaxDepth))) {
+            throw std::runtime_error("LevelBitmap: size must be between 1 and 64^4");
+        }
+        size_t words = 0;
+        size_t bits = size;
+        do {
+            offsets_[depth_++] = words;
+            bits = (bits + 63) / 64;
+            words += bits;
+        } while (bits > 1);
+        words_.assign(words, 0);
+    }
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return root() == 0; }
+
+    bool test(size_t index) const noexcept { return (words_[index >> 6] >> (index & 63) & 1) != 0; }
+
+    /**
+     * @brief Sets a bit; summary bits are only touched if its word was empty.
+     */
+    void set(size_t index) noexcept {
+        for (size_t level = 0; level < depth_; ++level) {
+            uint64_t& word = words_[offsets_[level] + (index >> 6)];
+            const uint64_t before = word;
+            word |= uint64_t{1} << (index & 63);
+            if (before != 0) return;
+            index >>= 6;
+        }
+    }
+
+    /**
+     * @brief Clears a bit; summary bits are only touched if its word became empty.
+     */
+    void reset(size_t index) noexcept {
+        for (size_t level = 0; level < depth_; ++level) {
+            uint64_t& word = words_[offsets_[level] + (index >> 6)];
+            word &= ~(uint64_t{1} << (index & 63));
+            if (word != 0) return;
+            index >>= 6;
+        }
+    }
+
+    /**
+     * @brief Smallest set index >= from, or npos.
+     */
+    size_t findNext(size_t from) const noexcept {
+        if (from >= size_) return npos;
+        size_t index = from;
+        for (size_t level = 0; level < depth_; ++level) {
+            const size_t word_index = index >> 6;
+            const uint64_t bits = words_[offsets_[level] + word_index] & (~uint64_t{0} << (index & 63));
+            if (bits != 0) return descendFirst(level, (word_index << 6) + static_cast<size_t>(std::countr_zero(bits)));
+            index = word_index + 1; // Bit of the next word, one level up
+            if (level + 1 < depth_ && (index >> 6) >= wordsAt(level + 1)) return npos;
+        }
+        return npos;
+    }
+
+    /**
+     * @brief Largest set index <= from (from is clamped to size() - 1), or npos.
+     */
+    size_t findPrev(size_t from) const noexcept {
+        size_t index = from < size_ ? from : size_ - 1;
+        for (size_t level = 0; level < depth_; ++level) {
+            const size_t word_index = index >> 6;
+            const uint64_t bits = words_[offsets_[level] + word_index] & (~uint64_t{0} >> (63 - (index & 63)));
+            if (bits != 0) return descendLast(level, (word_index << 6) + 63 - static_cast<size_t>(std::countl_zero(bits)));
+            if (word_index == 0) return npos;
+            index = word_index - 1;
+        }
+        return npos;
+    }
+
+    size_t first() const noexcept { return findNext(0); }
+    size_t last() const noexcept { return findPrev(size_ - 1); }
+
+private:
+    uint64_t root() const noexcept { return words_[offsets_[depth_ - 1]]; }
+    size_t wordsAt(size_t level) const noexcept {
+        return (level + 1 < depth_ ? offsets_[level + 1] : words_.size()) - offsets_[level];
+    }
+
+    /// From set bit index at level, follows the lowest set bits down to a leaf index.
+    size_t descendFirst(size_t level, size_t index) const noexcept {
+        while (level-- > 0) index = (index << 6) + static_cast<size_t>(std::countr_zero(words_[offsets_[level] + index]));
+        return index;
+    }
+
+    /// From set bit index at level, follows the highest set bits down to a leaf index.
+    size_t descendLast(size_t level, size_t index) const noexcept {
+        while (level-- > 0) index = (index << 6) + 63 - static_cast<size_t>(std::countl_zero(words_[offsets_[level] + index]));
+        return index;
+    }
+
+    size_t size_;
+    size_t depth_ = 0;                          ///< Leaf level plus summary levels.
+    std::array<size_t, kMaxDepth> offsets_{};   ///< First word of each level in words_ (0 = leaves).
+    std::vector<uint64_t> words_;
+};
+
+/**
+ * @brief One side of a price-level book over a fixed band of prices on a tick grid.
+ *
+ * Aggregate quantity per level sits in a flat array indexed by (price - low) / tick, so adding to
+ * or reducing a level is an index computation and a store. A LevelBitmap tracks which levels are
+ * populated. The best level's index is cached; when that level empties, the next one is found
+ * with a bitmap search instead of a scan over the empty levels in between (thin books can have
+ * hundreds of ticks between levels), and without the node hops and allocations of a std::map.
+ *
+ * Levels can also be addressed by index (levelOf(price) once, then the setLevel/quantityAt
+ * calls), which saves the division by the tick size when one price is touched several times.
+ */
+class PriceLadder {
+public:
+    /**
+     * @brief Constructs an empty ladder for prices low, low + tick, ..., low + (levels - 1) * tick.
+     * @throws std::runtime_error if tick is not positive or levels is out of LevelBitmap's range.
+     */
+    PriceLadder(Side side, FixedPrice low, FixedPrice tick, size_t levels)
+        : side_(side), low_(low), tick_(tick), quantities_(levels), occupied_(levels) {
+        if (tick <= 0) throw std::runtime_error("PriceLadder: tick size must be positive");
+    }
+
+    static constexpr size_t npos = LevelBitmap::npos;
+
+    Side side() const noexcept { return side_; }
+    FixedPrice low() const noexcept { return low_; }
+    FixedPrice tick() const noexcept { return tick_; }
+    size_t levels() const noexcept { return quantities_.size(); }
+    bool empty() const noexcept { return occupied_.empty(); }
+
+    /**
+     * @brief True if price is inside the band and on the tick grid.
+     */
+    bool contains(FixedPrice price) const noexcept {
+        return price >= low_ && (price - low_) % tick_ == 0 && static_cast<size_t>((price - low_) / tick_) < levels();
+    }
+
+    /**
+     * @brief Adds quantity (negative to reduce) at price; a level that drops to zero or below is
+     * removed.
+     * @return The level's new quantity (0 if removed).
+     * @throws std::runtime_error if the ladder does not contain price.
+     */
+    int64_t add(FixedPrice price, int64_t quantity) {
+        const size_t index = levelOf(price);
+        return setLevel(index, quantities_[index] + quantity);
+    }
+
+    /**
+     * @brief Sets the quantity at price (e.g. from a price-level feed); 0 or below removes it.
+     * @throws std::runtime_error if the ladder does not contain price.
+     */
+    void set(FixedPrice price, int64_t quantity) { setLevel(levelOf(price), quantity); }
+
+    /**
+     * @brief Quantity at price (0 if empty or outside the band).
+     */
+    int64_t quantity(FixedPrice price) const noexcept { return contains(price) ? quantities_[indexOf(price)] : 0; }
+
+    /**
+     * @brief Level index of price.
+     * @throws std::runtime_error if the ladder does not contain price.
+     */
+    size_t levelOf(FixedPrice price) const {
+        if (!contains(price)) throw std::runtime_error("PriceLadder: price outside the band or off the tick grid");
+        return indexOf(price);
+    }
+
+    FixedPrice priceOf(size_t level) const noexcept { return low_ + static_cast<FixedPrice>(level) * tick_; }
+    int64_t quantityAt(size_t level) const noexcept { return quantities_[level]; }
+
+    /**
+     * @brief Quantity per level, 0 where empty; level ranges can be summed without searching.
+     */
+    std::span<const int64_t> quantities() const noexcept { return quantities_; }
+
+    /**
+     * @brief Sets the quantity of a level; 0 or below removes it.
+     * @return The level's new quantity (0 if removed).
+     */
+    int64_t setLevel(size_t level, int64_t quantity) noexcept {
+        if (quantity > 0) {
+            if (quantities_[level] <= 0) {
+                occupied_.set(level);
+                if (isBetter(level, best_)) best_ = level;
+            }
+            quantities_[level] = quantity;
+            return quantity;
+        }
+        if (quantities_[level] > 0) {
+            occupied_.reset(level);
+            if (level == best_) best_ = nextLevel(level);
+        }
+        quantities_[level] = 0;
+        return 0;
+    }
+
+    /**
+     * @brief Best populated level, or npos.
+     */
+    size_t bestLevel() const noexcept { return best_; }
+
+    /**
+     * @brief Nearest populated level strictly worse than level, or npos.
+     */
+    size_t nextLevel(size_t level) const noexcept {
+        if (side_ == Side::Bid) return level == 0 ? npos : occupied_.findPrev(level - 1);
+        return occupied_.findNext(level + 1);
+    }
+
+    /**
+     * @brief Nearest populated level strictly better than level, or npos.
+     */
+    size_t previousLevel(size_t level) const noexcept {
+        if (side_ == Side::Ask) return level == 0 ? npos : occupied_.findPrev(level - 1);
+        return occupied_.findNext(level + 1);
+    }
+
+    /**
+     * @brief True if level is a better price than than (or than is npos).
+     */
+    bool isBetter(size_t level, size_t than) const noexcept {
+        return than == npos || (side_ == Side::Bid ? level > than : level < than);
+    }
+
+    /**
+     * @brief Best populated price: highest for bids, lowest for asks.
+     */
+    std::optional<FixedPrice> best() const noexcept {
+        return priceAt(best_);
+    }
+
+    /**
+     * @brief Next populated price strictly worse than price (below for bids, above for asks).
+     * price itself need not be populated, or even inside the band.
+     */
+    std::optional<FixedPrice> next(FixedPrice price) const noexcept {
+        if (side_ == Side::Bid) {
+            if (price <= low_) return std::nullopt;
+            return priceAt(occupied_.findPrev(static_cast<size_t>((price - low_ - 1) / tick_)));
+        }
+        if (price < low_) return priceAt(occupied_.first());
+        const auto above = static_cast<uint64_t>((price - low_) / tick_) + 1; // First level above price
+        return above < levels() ? priceAt(occupied_.findNext(above)) : std::nullopt;
+    }
+
+    /**
+     * @brief Calls fn(price, quantity) for up to max_levels populated levels, best first.
+     * @return Number of levels visited.
+     */
+    template <typename Fn>
+    size_t walk(size_t max_levels, Fn&& fn) const {
+        size_t visited = 0;
+        for (size_t level = best_; visited < max_levels && level != npos; level = nextLevel(level)) {
+            fn(priceOf(level), quantities_[level]);
+            ++visited;
+        }
+        return visited;
+    }
+
+    /**
+     * @brief Removes every level.
+     */
+    void clear() noexcept {
+        for (size_t level = occupied_.first(); level != npos; level = occupied_.findNext(level + 1)) {
+            quantities_[level] = 0;
+            occupied_.reset(level);
+        }
+        best_ = npos;
+    }
+
+private:
+    size_t indexOf(FixedPrice price) const noexcept { return static_cast<size_t>((price - low_) / tick_); }
+
+    std::optional<FixedPrice> priceAt(size_t level) const noexcept {
+        if (level == npos) return std::nullopt;
+        return priceOf(level);
+    }
+
+    Side side_;
+    FixedPrice low_;                  ///< Price of level 0.
+    FixedPrice tick_;                 ///< Price step between levels.
+    std::vector<int64_t> quantities_; ///< Aggregate quantity per level (0 = empty).
+    LevelBitmap occupied_;            ///< Populated levels.
+    size_t best_ = npos;              ///< Best populated level, npos if empty.
+};
@@ -0,0 +1,224 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace radix_sort_detail {
+
+inline constexpr size_t kRadixBits = 8;
+inline constexpr size_t kBuckets = size_t{1} << kRadixBits;
+inline constexpr size_t kDigitsPerKey = (64 + kRadixBits - 1) / kRadixBits;
+inline constexpr size_t kStagingBytes = 1024; ///< Per-bucket scatter buffer (256 KiB in all: stays in L2).
+inline constexpr size_t kMinRecordsPerThread = 1 << 16; ///< Smaller chunks cost more in startup than they save.
+inline constexpr size_t kStreamingBytes = 16 << 20;     ///< Inputs this large bypass the cache when scattering.
+
+/**
+ * @brief Copies a staged run to its bucket; with stream set, uses non-temporal stores when the
+ * destination allows, so the output does not evict the staging buffers or pay a read-for-ownership.
+ */
+inline void flushStaged(void* dst, const void* src, size_t bytes, bool stream) noexcept {
+#if defined(__SSE2__)
+    if (stream && reinterpret_cast<uintptr_t>(dst) % 16 == 0 && bytes % 16 == 0) {
+        auto* out = static_cast<__m128i*>(dst);
+        const auto* in = static_cast<const __m128i*>(src);
+        for (size_t i = 0; i < bytes / 16; ++i) _mm_stream_si128(out + i, _mm_loadu_si128(in + i));
+        return;
+    }
+#endif
+    (void)stream;
+    std::memcpy(dst, src, bytes);
+}
+
+using Histogram = std::array<size_t, kBuckets>;
+
+/// Calls fn(std::get<I>(keys)) for the I equal to index, so per-pass loops are specialised per key.
+template <typename Fn, typename Keys, size_t... I>
+void withKey(const Keys& keys, size_t index, Fn&& fn, std::index_sequence<I...>) {
+    ((index == I ? fn(std::get<I>(keys)) : void()), ...);
+}
+
+/// Simple reusable barrier for a fixed set of threads (generation-counted spin + yield).
+class SpinBarrier {
+public:
+    explicit SpinBarrier(size_t threads) noexcept : threads_(threads) {}
+
+    void arriveAndWait() noexcept {
+        size_t generation = generation_.load(std::memory_order_acquire);
+        if (arrived_.fetch_add(1, std::memory_order_acq_rel) + 1 == threads_) {
+            arrived_.store(0, std::memory_order_relaxed);
+            generation_.store(generation + 1, std::memory_order_release);
+            return;
+        }
+        while (generation_.load(std::memory_order_acquire) == generation) std::this_thread::yield();
+    }
+
+private:
+    const size_t threads_;
+    std::atomic<size_t> arrived_{0};
+    std::atomic<size_t> generation_{0};
+};
+
+} // namespace radix_sort_detail
+
+/**
+ * @brief Stable, parallel LSD radix sort of fixed-size records by one or more 64-bit keys.
+ *
+ * Records are ordered by keys[0], then keys[1], and so on (e.g. timestamp, then sequence); records
+ * with equal keys keep their input order. Each key is sorted 8 bits at a time from the least
+ * significant digit of the last key up. Every pass splits the input into one contiguous chunk per
+ * thread: each thread counts its chunk's digits into a private histogram, the histograms are
+ * turned into per-thread output offsets (bucket-major, so chunks land in input order), and each
+ * thread scatters its chunk without any synchronisation. A first counting pass over all digits
+ * finds digits that are the same in every record (the upper bytes of a day's timestamps, or of
+ * small sequence numbers) and skips those passes entirely.
+ *
+ * @param records Records to sort in place; Record must be trivially copyable.
+ * @param scratch Buffer of at least records.size() records (contents are overwritten).
+ * @param threads Worker threads, 0 for std::thread::hardware_concurrency(); small inputs use fewer.
+ * @param keys Callables const Record& -> uint64_t, most significant first.
+ * @throws std::runtime_error if scratch is too small.
+ */
+template <typename Record, typename... Keys>
+void radixSort(std::span<Record> records, std::span<Record> scratch, size_t threads, Keys... keys) {
+    using namespace radix_sort_detail;
+    static_assert(std::is_trivially_copyable_v<Record>, "radixSort moves records with plain copies");
+    static_assert(sizeof...(Keys) > 0, "radixSort needs at least one key");
+    constexpr size_t kDigits = sizeof...(Keys) * kDigitsPerKey;
+    constexpr size_t kStaged = std::max<size_t>(1, kStagingBytes / sizeof(Record)); // Records per bucket buffer
+
+    const size_t n = records.size();
+    if (scratch.size() < n) throw std::runtime_error("radixSort: scratch smaller than input");
+    if (n < 2) return;
+    if (threads == 0) threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    threads = std::clamp<size_t>(n / kMinRecordsPerThread, 1, threads);
+
+    const std::tuple<Keys...> key_fns(keys...);
+    constexpr auto kKeyIndices = std::index_sequence_for<Keys...>{};
+    // Digit d (0 = least significant overall) is byte d % 8 of key (count - 1 - d / 8).
+    auto keyIndex = [](size_t digit) { return sizeof...(Keys) - 1 - digit / kDigitsPerKey; };
+    auto shiftOf = [](size_t digit) { return (digit % kDigitsPerKey) * kRadixBits; };
+
+    std::vector<std::array<Histogram, kDigits>> counts(threads); // [thread][digit]
+    std::vector<Histogram> offsets(threads);                      // [thread] for the current pass
+    std::vector<size_t> passes;                                   // Digits that actually vary
+    SpinBarrier barrier(threads);
+    const bool stream = n * sizeof(Record) >= kStreamingBytes;
+
+    auto chunk = [&](size_t t) {
+        return std::pair<size_t, size_t>{n * t / threads, n * (t + 1) / threads};
+    };
+
+    auto worker = [&](size_t t) {
+        const auto [begin, end] = chunk(t);
+        Record* source = records.data();
+        Record* target = scratch.data();
+        std::vector<Record> staging(kBuckets * kStaged);
+        std::array<Histogram, kDigits>& local = counts[t];
+        for (Histogram& histogram : local) histogram.fill(0);
+
+        // All digits in one read of the input: finds the passes to run, and the first pass's counts.
+        for (size_t key = 0; key < sizeof...(Keys); ++key) {
+            withKey(key_fns, key, [&](const auto& key_fn) {
+                const size_t base = (sizeof...(Keys) - 1 - key) * kDigitsPerKey;
+                for (size_t i = begin; i < end; ++i) {
+                    uint64_t value = key_fn(source[i]);
+                    for (size_t d = 0; d < kDigitsPerKey; ++d) ++local[base + d][(value >> (d * kRadixBits)) & (kBuckets - 1)];
+                }
+            }, kKeyIndices);
+        }
+        barrier.arriveAndWait();
+        if (t == 0) {
+            for (size_t digit = 0; digit < kDigits; ++digit) {
+                size_t largest = 0;
+                for (size_t b = 0; b < kBuckets; ++b) {
+                    size_t total = 0;
+                    for (size_t w = 0; w < threads; ++w) total += counts[w][digit][b];
+                    largest = std::max(largest, total);
+                }
+                if (largest != n) passes.push_back(digit);
+            }
+        }
+        barrier.arriveAndWait();
+
+        for (size_t p = 0; p < passes.size(); ++p) {
+            const size_t digit = passes[p];
+            const unsigned shift = static_cast<unsigned>(shiftOf(digit));
+            if (p > 0 && threads > 1) {
+                // The chunk now holds different records: recount this digit. (A single thread's
+                // chunk is the whole input, whose counts the first pass already has.)
+                Histogram& histogram = local[digit];
+                histogram.fill(0);
+                withKey(key_fns, keyIndex(digit), [&](const auto& key_fn) {
+                    for (size_t i = begin; i < end; ++i) ++histogram[(key_fn(source[i]) >> shift) & (kBuckets - 1)];
+                }, kKeyIndices);
+                barrier.arriveAndWait();
+            }
+            if (t == 0) {
+                size_t running = 0;
+                for (size_t b = 0; b < kBuckets; ++b) {
+                    for (size_t w = 0; w < threads; ++w) {
+                        offsets[w][b] = running;
+                        running += counts[w][digit][b];
+                    }
+                }
+            }
+            barrier.arriveAndWait();
+
+            // Scatter through per-bucket staging buffers: 256 live output streams would otherwise each
+            // take a cache miss and a TLB miss per record; flushing whole buffers writes full lines.
+            Histogram next = offsets[t];
+            std::array<uint32_t, kBuckets> staged{};
+            withKey(key_fns, keyIndex(digit), [&](const auto& key_fn) {
+                for (size_t i = begin; i < end; ++i) {
+                    size_t bucket = (key_fn(source[i]) >> shift) & (kBuckets - 1);
+                    Record* slot = staging.data() + bucket * kStaged;
+                    slot[staged[bucket]++] = source[i];
+                    if (staged[bucket] == kStaged) {
+                        flushStaged(target + next[bucket], slot, sizeof(Record) * kStaged, stream);
+                        next[bucket] += kStaged;
+                        staged[bucket] = 0;
+                    }
+                }
+            }, kKeyIndices);
+            for (size_t bucket = 0; bucket < kBuckets; ++bucket) {
+                flushStaged(target + next[bucket], staging.data() + bucket * kStaged, sizeof(Record) * staged[bucket], false);
+            }
+#if defined(__SSE2__)
+            if (stream) _mm_sfence(); // Order the streamed stores before the barrier publishes them
+#endif
+            barrier.arriveAndWait();
+            std::swap(source, target);
+        }
+
+        // An odd number of passes leaves the result in scratch.
+        if (source != records.data()) std::copy(source + begin, source + end, records.data() + begin);
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) workers.emplace_back(worker, t);
+    worker(0);
+    for (std::thread& w : workers) w.join();
+}
+
+/**
+ * @brief radixSort() with a scratch buffer allocated for the call.
+ */
+template <typename Record, typename... Keys>
+void radixSort(std::span<Record> records, size_t threads, Keys... keys) {
+    std::vector<Record> scratch(records.size());
+    radixSort(records, std::span<Record>(scratch), threads, keys...);
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "padded_counter.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief Single-writer value that any number of threads read without locks or writes.
+ * @tparam T Trivially copyable value type.
+ *
+ * The writer bumps a sequence number to odd, stores the value, and bumps it back to even; a
+ * reader copies the value between two reads of the sequence and retries if they differ or are
+ * odd. Readers never write shared memory, so they cannot slow the writer down by stealing its
+ * cache line, and a write is a handful of plain stores. The value is held as relaxed atomic words
+ * so concurrent copies are not data races.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock holds trivially copyable values");
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+public:
+    SeqLock() noexcept { store(T{}); }
+
+    /**
+     * @brief Publishes a value (single writer thread only).
+     */
+    void store(const T& value) noexcept {
+        uint64_t words[kWords] = {};
+        std::memcpy(words, &value, sizeof(T));
+        const uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release); // Odd sequence visible before any word
+        for (size_t i = 0; i < kWords; ++i) words_[i].store(words[i], std::memory_order_relaxed);
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copies the value if no write overlaps the copy (any thread).
+     * @return False if a write was in progress; value is then unspecified.
+     */
+    bool tryLoad(T& value) const noexcept {
+        const uint64_t before = sequence_.load(std::memory_order_acquire);
+        if (before & 1) return false;
+        uint64_t words[kWords];
+        for (size_t i = 0; i < kWords; ++i) words[i] = words_[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire); // Words read before the re-check
+        if (sequence_.load(std::memory_order_relaxed) != before) return false;
+        std::memcpy(&value, words, sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Copies the value, retrying while writes overlap (any thread).
+     */
+    T load() const noexcept {
+        T value;
+        while (!tryLoad(value)) {
+        }
+        return value;
+    }
+
+    /**
+     * @brief Number of stores so far (including the initial one).
+     */
+    uint64_t version() const noexcept { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    alignas(kCacheLineSize) std::atomic<uint64_t> sequence_{0}; ///< Odd while a store is in progress.
+    std::atomic<uint64_t> words_[kWords];                         ///< Value, copied word by word.
+};
@@ -0,0 +1,694 @@
+#include "simd_kernels.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define HFT_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace {
+
+// ---------------------------------------------------------------------------------------------
+// Scalar fallbacks: portable, and the reference every vector variant must match.
+// ---------------------------------------------------------------------------------------------
+
+const char* findDelimiterScalar(const char* begin, const char* end, char a, char b) {
+    for (; begin < end; ++begin) {
+        if (*begin == a || *begin == b) return begin;
+    }
+    return end;
+}
+
+uint64_t checksumTail(const uint8_t* bytes, size_t size) {
+    uint64_t sum = 0;
+    size_t words = size / 4;
+    for (size_t i = 0; i < words; ++i) {
+        uint32_t word;
+        std::memcpy(&word, bytes + i * 4, sizeof(word));
+        sum += word;
+    }
+    if (size % 4) {
+        uint32_t word = 0;
+        std::memcpy(&word, bytes + words * 4, size % 4);
+        sum += word;
+    }
+    return sum;
+}
+
+uint64_t checksumScalar(const void* data, size_t size) {
+    return checksumTail(static_cast<const uint8_t*>(data), size);
+}
+
+int64_t sumI64Scalar(const int64_t* values, size_t count) {
+    uint64_t sum = 0; // Unsigned so overflow wraps identically in every variant
+    for (size_t i = 0; i < count; ++i) sum += static_cast<uint64_t>(values[i]);
+    return static_cast<int64_t>(sum);
+}
+
+/// Reads `bytes` (1-8) little-endian bytes; a full 8-byte load plus a mask when the buffer allows.
+uint64_t loadLittleEndian(const uint8_t* data, const uint8_t* data_end, size_t bytes) {
+    uint64_t value = 0;
+    if (data_end - data >= 8) {
+        std::memcpy(&value, data, 8);
+        return bytes == 8 ? value : value & ((1ULL << (8 * bytes)) - 1);
+    }
+    std::memcpy(&value, data, bytes);
+    return value;
+}
+
+const uint8_t* decodeDeltaU64Scalar(const uint8_t* control, const uint8_t* data, const uint8_t* data_end,
+                                    size_t count, uint64_t start, uint64_t* out) {
+    uint64_t sum = start;
+    for (size_t i = 0; i < count; ++i) {
+        size_t bytes = size_t{1} << ((control[i / 4] >> (2 * (i % 4))) & 3);
+        if (static_cast<size_t>(data_end - data) < bytes) return nullptr;
+        uint64_t zigzag = loadLittleEndian(data, data_end, bytes);
+        data += bytes;
+        sum += (zigzag >> 1) ^ (0 - (zigzag & 1));
+        out[i] = sum;
+    }
+    return data;
+}
+
+const uint8_t* decodeVarintU32Scalar(const uint8_t* control, const uint8_t* data, const uint8_t* data_end,
+                                     size_t count, uint32_t* out) {
+    for (size_t i = 0; i < count; ++i) {
+        size_t bytes = ((control[i / 4] >> (2 * (i % 4))) & 3) + 1;
+        if (static_cast<size_t>(data_end - data) < bytes) return nullptr;
+        out[i] = static_cast<uint32_t>(loadLittleEndian(data, data_end, bytes));
+        data += bytes;
+    }
+    return data;
+}
+
+/**
+ * @brief Branch-free: every index is written, and the output position advances only on a match.
+ * A value is in [min, max] iff value - min <= max - min in unsigned arithmetic, one compare per column.
+ */
+size_t selectRangesScalar(const uint64_t* a, const int64_t* b, const int32_t* c, size_t count,
+                          const ColumnRanges& ranges, uint32_t* selection) {
+    const uint64_t span_a = ranges.max_u64 - ranges.min_u64;
+    const uint64_t span_b = static_cast<uint64_t>(ranges.max_i64) - static_cast<uint64_t>(ranges.min_i64);
+    const uint32_t span_c = static_cast<uint32_t>(ranges.max_i32) - static_cast<uint32_t>(ranges.min_i32);
+    size_t selected = 0;
+    for (size_t i = 0; i < count; ++i) {
+        bool match = (a[i] - ranges.min_u64 <= span_a) &
+                     (static_cast<uint64_t>(b[i]) - static_cast<uint64_t>(ranges.min_i64) <= span_b) &
+                     (static_cast<uint32_t>(c[i]) - static_cast<uint32_t>(ranges.min_i32) <= span_c);
+        selection[selected] = static_cast<uint32_t>(i);
+        selected += match;
+    }
+    return selected;
+}
+
+/// Folds bids/asks [begin, count) into out.bid/out.ask.
+void quoteExtremesTail(const int64_t* bids, const int64_t* asks, size_t begin, size_t count, QuoteExtremes& out) {
+    for (size_t i = begin; i < count; ++i) {
+        out.bid = std::max(out.bid, bids[i]);
+        out.ask = std::min(out.ask, asks[i]);
+    }
+}
+
+/// Sets the mask bits of the indices in [begin, count) holding out.bid/out.ask.
+void quoteMasksTail(const int64_t* bids, const int64_t* asks, size_t begin, size_t count, QuoteExtremes& out) {
+    for (size_t i = begin; i < count; ++i) {
+        out.bid_mask |= uint64_t{bids[i] == out.bid} << i;
+        out.ask_mask |= uint64_t{asks[i] == out.ask} << i;
+    }
+}
+
+QuoteExtremes bestQuoteScalar(const int64_t* bids, const int64_t* asks, size_t count) {
+    QuoteExtremes out{INT64_MIN, INT64_MAX, 0, 0};
+    quoteExtremesTail(bids, asks, 0, count, out);
+    quoteMasksTail(bids, asks, 0, count, out);
+    return out;
+}
+
+#if defined(__x86_64__)
+
+// ---------------------------------------------------------------------------------------------
+// Shuffle tables for the varint decoders: one pshufb mask (0x80 = zero byte) and input length per
+// control pattern.
+// ---------------------------------------------------------------------------------------------
+
+template <size_t Patterns>
+struct ShuffleTable {
+    alignas(16) uint8_t shuffle[Patterns][16];
+    uint8_t length[Patterns];
+};
+
+/// Two 64-bit deltas per 4-bit pattern, each 1/2/4/8 bytes wide.
+constexpr ShuffleTable<16> makeDelta64Table() {
+    ShuffleTable<16> table{};
+    for (unsigned pattern = 0; pattern < 16; ++pattern) {
+        unsigned position = 0;
+        for (unsigned value = 0; value < 2; ++value) {
+            unsigned bytes = 1u << ((pattern >> (2 * value)) & 3);
+            for (unsigned b = 0; b < 8; ++b) {
+                table.shuffle[pattern][value * 8 + b] = static_cast<uint8_t>(b < bytes ? position + b : 0x80);
+            }
+            position += bytes;
+        }
+        table.length[pattern] = static_cast<uint8_t>(position);
+    }
+    return table;
+}
+
+/// Four 32-bit values per control byte, each 1-4 bytes wide.
+constexpr ShuffleTable<256> makeVarint32Table() {
+    ShuffleTable<256> table{};
+    for (unsigned pattern = 0; pattern < 256; ++pattern) {
+        unsigned position = 0;
+        for (unsigned value = 0; value < 4; ++value) {
+            unsigned bytes = ((pattern >> (2 * value)) & 3) + 1;
+            for (unsigned b = 0; b < 4; ++b) {
+                table.shuffle[pattern][value * 4 + b] = static_cast<uint8_t>(b < bytes ? position + b : 0x80);
+            }
+            position += bytes;
+        }
+        table.length[pattern] = static_cast<uint8_t>(position);
+    }
+    return table;
+}
+
+/// Left-packing masks for selection vectors: the set bits of a 4-bit match mask as 32-bit lanes.
+constexpr ShuffleTable<16> makeCompress32Table() {
+    ShuffleTable<16> table{};
+    for (unsigned mask = 0; mask < 16; ++mask) {
+        unsigned out = 0;
+        for (unsigned lane = 0; lane < 4; ++lane) {
+            if (!(mask & (1u << lane))) continue;
+            for (unsigned b = 0; b < 4; ++b) table.shuffle[mask][out * 4 + b] = static_cast<uint8_t>(lane * 4 + b);
+            ++out;
+        }
+        for (; out < 4; ++out) {
+            for (unsigned b = 0; b < 4; ++b) table.shuffle[mask][out * 4 + b] = 0x80;
+        }
+        table.length[mask] = static_cast<uint8_t>(std::popcount(mask));
+    }
+    return table;
+}
+
+/// Lane permutations for _mm256_permutevar8x32_epi32: the set lanes of an 8-bit mask, packed left.
+constexpr std::array<std::array<uint32_t, 8>, 256> makeCompress8Table() {
+    std::array<std::array<uint32_t, 8>, 256> table{};
+    for (unsigned mask = 0; mask < 256; ++mask) {
+        unsigned out = 0;
+        for (unsigned lane = 0; lane < 8; ++lane) {
+            if (mask & (1u << lane)) table[mask][out++] = lane;
+        }
+    }
+    return table;
+}
+
+constexpr ShuffleTable<16> kDelta64Table = makeDelta64Table();
+constexpr ShuffleTable<256> kVarint32Table = makeVarint32Table();
+constexpr ShuffleTable<16> kCompress32Table = makeCompress32Table();
+alignas(32) constexpr std::array<std::array<uint32_t, 8>, 256> kCompress8Table = makeCompress8Table();
+
+// ---------------------------------------------------------------------------------------------
+// SSE4.2 (128-bit)
+// ---------------------------------------------------------------------------------------------
+
+HFT_TARGET("sse4.2")
+const char* findDelimiterSse42(const char* begin, const char* end, char a, char b) {
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    for (; end - begin >= 16; begin += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb)));
+        if (mask) return begin + __builtin_ctz(static_cast<unsigned>(mask));
+    }
+    return findDelimiterScalar(begin, end, a, b);
+}
+
+HFT_TARGET("sse4.2")
+uint64_t checksumSse42(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+        acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(words, zero));
+        acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(words, zero));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return lanes[0] + lanes[1] + checksumTail(bytes + i, size - i);
+}
+
+HFT_TARGET("sse4.2")
+int64_t sumI64Sse42(const int64_t* values, size_t count) {
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        acc0 = _mm_add_epi64(acc0, _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)));
+        acc1 = _mm_add_epi64(acc1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i + 2)));
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), _mm_add_epi64(acc0, acc1));
+    return static_cast<int64_t>(lanes[0] + lanes[1] + static_cast<uint64_t>(sumI64Scalar(values + i, count - i)));
+}
+
+/**
+ * @brief Unpacks two deltas per pshufb, zig-zag decodes them and adds the running sum in-register.
+ */
+HFT_TARGET("sse4.2")
+const uint8_t* decodeDeltaU64Sse42(const uint8_t* control, const uint8_t* data, const uint8_t* data_end,
+                                   size_t count, uint64_t start, uint64_t* out) {
+    const __m128i one = _mm_set1_epi64x(1);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i previous = _mm_set1_epi64x(static_cast<long long>(start));
+    size_t i = 0;
+    // A control byte covers four deltas, at most 32 bytes; both 16-byte loads stay inside data_end.
+    for (; i + 4 <= count && data_end - data >= 32; i += 4) {
+        unsigned codes = control[i / 4];
+        for (unsigned half = 0; half < 2; ++half) {
+            unsigned pattern = (codes >> (4 * half)) & 0xF;
+            __m128i zigzag = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)),
+                                              _mm_load_si128(reinterpret_cast<const __m128i*>(kDelta64Table.shuffle[pattern])));
+            data += kDelta64Table.length[pattern];
+            __m128i delta = _mm_xor_si128(_mm_srli_epi64(zigzag, 1), _mm_sub_epi64(zero, _mm_and_si128(zigzag, one)));
+            __m128i sums = _mm_add_epi64(_mm_add_epi64(delta, _mm_slli_si128(delta, 8)), previous);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 2 * half), sums);
+            previous = _mm_unpackhi_epi64(sums, sums);
+        }
+    }
+    return decodeDeltaU64Scalar(control + i / 4, data, data_end, count - i, i == 0 ? start : out[i - 1], out + i);
+}
+
+/**
+ * @brief Stream VByte: four values per control byte, one pshufb each.
+ */
+HFT_TARGET("sse4.2")
+const uint8_t* decodeVarintU32Sse42(const uint8_t* control, const uint8_t* data, const uint8_t* data_end,
+                                    size_t count, uint32_t* out) {
+    size_t i = 0;
+    for (; i + 4 <= count && data_end - data >= 16; i += 4) {
+        unsigned pattern = control[i / 4];
+        __m128i values = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)),
+                                          _mm_load_si128(reinterpret_cast<const __m128i*>(kVarint32Table.shuffle[pattern])));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), values);
+        data += kVarint32Table.length[pattern];
+    }
+    return decodeVarintU32Scalar(control + i / 4, data, data_end, count - i, out + i);
+}
+
+/// Bit per 64-bit lane whose value - min exceeds the span, unsigned (span pre-xored with the sign bit).
+HFT_TARGET("sse4.2")
+inline int outside64Sse42(const void* p, __m128i min, __m128i span) {
+    __m128i v = _mm_loadu_si128(static_cast<const __m128i*>(p));
+    __m128i shifted = _mm_xor_si128(_mm_sub_epi64(v, min), _mm_set1_epi64x(INT64_MIN));
+    return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(shifted, span)));
+}
+
+/**
+ * @brief Four rows per step: range tests as one subtract and one signed compare against the
+ * sign-flipped span per column, then a pshufb left-packs the matching indices.
+ */
+HFT_TARGET("sse4.2")
+size_t selectRangesSse42(const uint64_t* a, const int64_t* b, const int32_t* c, size_t count,
+                         const ColumnRanges& ranges, uint32_t* selection) {
+    const __m128i sign64 = _mm_set1_epi64x(INT64_MIN);
+    const __m128i sign32 = _mm_set1_epi32(INT32_MIN);
+    const __m128i min_a = _mm_set1_epi64x(static_cast<long long>(ranges.min_u64));
+    const __m128i min_b = _mm_set1_epi64x(ranges.min_i64);
+    const __m128i min_c = _mm_set1_epi32(ranges.min_i32);
+    // (value - min) ^ sign > span ^ sign  <=>  value - min > span (unsigned)  <=>  out of range
+    const __m128i span_a = _mm_xor_si128(_mm_set1_epi64x(static_cast<long long>(ranges.max_u64 - ranges.min_u64)), sign64);
+    const __m128i span_b = _mm_xor_si128(
+        _mm_set1_epi64x(static_cast<long long>(static_cast<uint64_t>(ranges.max_i64) - static_cast<uint64_t>(ranges.min_i64))), sign64);
+    const __m128i span_c = _mm_xor_si128(
+        _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(ranges.max_i32) - static_cast<uint32_t>(ranges.min_i32))), sign32);
+    __m128i indices = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i step = _mm_set1_epi32(4);
+    size_t selected = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        int outside = outside64Sse42(a + i, min_a, span_a) | (outside64Sse42(a + i + 2, min_a, span_a) << 2) |
+                      outside64Sse42(b + i, min_b, span_b) | (outside64Sse42(b + i + 2, min_b, span_b) << 2);
+        __m128i vc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + i));
+        outside |= _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(_mm_xor_si128(_mm_sub_epi32(vc, min_c), sign32), span_c)));
+        unsigned match = ~static_cast<unsigned>(outside) & 0xF;
+        __m128i packed = _mm_shuffle_epi8(indices, _mm_load_si128(reinterpret_cast<const __m128i*>(kCompress32Table.shuffle[match])));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(selection + selected), packed); // Within [0, i + 4)
+        selected += kCompress32Table.length[match];
+        indices = _mm_add_epi32(indices, step);
+    }
+    size_t tail = selectRangesScalar(a + i, b + i, c + i, count - i, ranges, selection + selected);
+    for (size_t k = 0; k < tail; ++k) selection[selected + k] += static_cast<uint32_t>(i);
+    return selected + tail;
+}
+
+/**
+ * @brief Two passes of two lanes: a compare-and-blend max/min (there is no 64-bit max before
+ * AVX-512), then an equality mask against the broadcast extremes.
+ */
+HFT_TARGET("sse4.2")
+QuoteExtremes bestQuoteSse42(const int64_t* bids, const int64_t* asks, size_t count) {
+    __m128i max = _mm_set1_epi64x(INT64_MIN);
+    __m128i min = _mm_set1_epi64x(INT64_MAX);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bids + i));
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(asks + i));
+        max = _mm_blendv_epi8(max, b, _mm_cmpgt_epi64(b, max));
+        min = _mm_blendv_epi8(min, a, _mm_cmpgt_epi64(min, a));
+    }
+    int64_t max_lanes[2], min_lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(max_lanes), max);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(min_lanes), min);
+    QuoteExtremes out{std::max(max_lanes[0], max_lanes[1]), std::min(min_lanes[0], min_lanes[1]), 0, 0};
+    quoteExtremesTail(bids, asks, i, count, out);
+    const __m128i best_bid = _mm_set1_epi64x(out.bid);
+    const __m128i best_ask = _mm_set1_epi64x(out.ask);
+    for (i = 0; i + 2 <= count; i += 2) {
+        __m128i b = _mm_cmpeq_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bids + i)), best_bid);
+        __m128i a = _mm_cmpeq_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(asks + i)), best_ask);
+        out.bid_mask |= static_cast<uint64_t>(_mm_movemask_pd(_mm_castsi128_pd(b))) << i;
+        out.ask_mask |= static_cast<uint64_t>(_mm_movemask_pd(_mm_castsi128_pd(a))) << i;
+    }
+    quoteMasksTail(bids, asks, i, count, out);
+    return out;
+}
+
+// ---------------------------------------------------------------------------------------------
+// AVX2 (256-bit)
+// ---------------------------------------------------------------------------------------------
+
+HFT_TARGET("avx2")
+const char* findDelimiterAvx2(const char* begin, const char* end, char a, char b) {
+    const __m256i va = _mm256_set1_epi8(a);
+    const __m256i vb = _mm256_set1_epi8(b);
+    for (; end - begin >= 32; begin += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, va), _mm256_cmpeq_epi8(chunk, vb))));
+        if (mask) return begin + __builtin_ctz(mask);
+    }
+    return findDelimiterSse42(begin, end, a, b);
+}
+
+HFT_TARGET("avx2")
+uint64_t checksumAvx2(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + i));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(words)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(words, 1)));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + checksumTail(bytes + i, size - i);
+}
+
+HFT_TARGET("avx2")
+int64_t sumI64Avx2(const int64_t* values, size_t count) {
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm256_add_epi64(acc0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + 4)));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(acc0, acc1));
+    return static_cast<int64_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+                                static_cast<uint64_t>(sumI64Scalar(values + i, count - i)));
+}
+
+HFT_TARGET("avx2")
+inline int outside64Avx2(const void* p, __m256i min, __m256i span) {
+    __m256i v = _mm256_loadu_si256(static_cast<const __m256i*>(p));
+    __m256i shifted = _mm256_xor_si256(_mm256_sub_epi64(v, min), _mm256_set1_epi64x(INT64_MIN));
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(shifted, span)));
+}
+
+/**
+ * @brief Eight rows per step; the matching lanes are packed with one permutevar8x32.
+ */
+HFT_TARGET("avx2")
+size_t selectRangesAvx2(const uint64_t* a, const int64_t* b, const int32_t* c, size_t count,
+                        const ColumnRanges& ranges, uint32_t* selection) {
+    const __m256i sign64 = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i sign32 = _mm256_set1_epi32(INT32_MIN);
+    const __m256i min_a = _mm256_set1_epi64x(static_cast<long long>(ranges.min_u64));
+    const __m256i min_b = _mm256_set1_epi64x(ranges.min_i64);
+    const __m256i min_c = _mm256_set1_epi32(ranges.min_i32);
+    const __m256i span_a = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(ranges.max_u64 - ranges.min_u64)), sign64);
+    const __m256i span_b = _mm256_xor_si256(
+        _mm256_set1_epi64x(static_cast<long long>(static_cast<uint64_t>(ranges.max_i64) - static_cast<uint64_t>(ranges.min_i64))), sign64);
+    const __m256i span_c = _mm256_xor_si256(
+        _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(ranges.max_i32) - static_cast<uint32_t>(ranges.min_i32))), sign32);
+    __m256i indices = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i step = _mm256_set1_epi32(8);
+    size_t selected = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int outside = outside64Avx2(a + i, min_a, span_a) | (outside64Avx2(a + i + 4, min_a, span_a) << 4) |
+                      outside64Avx2(b + i, min_b, span_b) | (outside64Avx2(b + i + 4, min_b, span_b) << 4);
+        __m256i vc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(c + i));
+        outside |= _mm256_movemask_ps(
+            _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_xor_si256(_mm256_sub_epi32(vc, min_c), sign32), span_c)));
+        unsigned match = ~static_cast<unsigned>(outside) & 0xFF;
+        __m256i order = _mm256_load_si256(reinterpret_cast<const __m256i*>(kCompress8Table[match].data()));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(selection + selected), _mm256_permutevar8x32_epi32(indices, order));
+        selected += static_cast<size_t>(std::popcount(match));
+        indices = _mm256_add_epi32(indices, step);
+    }
+    size_t tail = selectRangesSse42(a + i, b + i, c + i, count - i, ranges, selection + selected);
+    for (size_t k = 0; k < tail; ++k) selection[selected + k] += static_cast<uint32_t>(i);
+    return selected + tail;
+}
+
+HFT_TARGET("avx2")
+QuoteExtremes bestQuoteAvx2(const int64_t* bids, const int64_t* asks, size_t count) {
+    __m256i max = _mm256_set1_epi64x(INT64_MIN);
+    __m256i min = _mm256_set1_epi64x(INT64_MAX);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bids + i));
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(asks + i));
+        max = _mm256_blendv_epi8(max, b, _mm256_cmpgt_epi64(b, max));
+        min = _mm256_blendv_epi8(min, a, _mm256_cmpgt_epi64(min, a));
+    }
+    int64_t max_lanes[4], min_lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(max_lanes), max);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(min_lanes), min);
+    QuoteExtremes out{std::max({max_lanes[0], max_lanes[1], max_lanes[2], max_lanes[3]}),
+                      std::min({min_lanes[0], min_lanes[1], min_lanes[2], min_lanes[3]}), 0, 0};
+    quoteExtremesTail(bids, asks, i, count, out);
+    const __m256i best_bid = _mm256_set1_epi64x(out.bid);
+    const __m256i best_ask = _mm256_set1_epi64x(out.ask);
+    for (i = 0; i + 4 <= count; i += 4) {
+        __m256i b = _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bids + i)), best_bid);
+        __m256i a = _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(asks + i)), best_ask);
+        out.bid_mask |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(b))) << i;
+        out.ask_mask |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(a))) << i;
+    }
+    quoteMasksTail(bids, asks, i, count, out);
+    return out;
+}
+
+// ---------------------------------------------------------------------------------------------
+// AVX-512 (512-bit, F/BW/VL)
+// ---------------------------------------------------------------------------------------------
+
+HFT_TARGET("avx512f,avx512bw,avx512vl,bmi2")
+const char* findDelimiterAvx512(const char* begin, const char* end, char a, char b) {
+    const __m512i va = _mm512_set1_epi8(a);
+    const __m512i vb = _mm512_set1_epi8(b);
+    for (; end - begin >= 64; begin += 64) {
+        __m512i chunk = _mm512_loadu_si512(begin);
+        __mmask64 mask = _mm512_cmpeq_epi8_mask(chunk, va) | _mm512_cmpeq_epi8_mask(chunk, vb);
+        if (mask) return begin + __builtin_ctzll(mask);
+    }
+    if (begin < end) {
+        // Masked load: lanes past `end` are neither read nor able to fault.
+        __mmask64 valid = _bzhi_u64(~0ULL, static_cast<unsigned>(end - begin));
+        __m512i chunk = _mm512_maskz_loadu_epi8(valid, begin);
+        __mmask64 mask = (_mm512_cmpeq_epi8_mask(chunk, va) | _mm512_cmpeq_epi8_mask(chunk, vb)) & valid;
+        if (mask) return begin + __builtin_ctzll(mask);
+    }
+    return end;
+}
+
+// Lane reductions below go through an aligned store rather than the _mm512_reduce_* helpers and
+// 256-bit extracts: GCC 12 implements those (and unmasked shifts) with an _mm512_undefined_*
+// pass-through that warns as uninitialised under -Wall.
+
+/// Each 64-bit lane adds its low and high 32-bit word; the sum does not depend on word order.
+HFT_TARGET("avx512f,avx512bw,avx512vl")
+uint64_t checksumAvx512(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    const __m512i low_words = _mm512_set1_epi64(0xFFFFFFFF);
+    __m512i acc = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        __m512i words = _mm512_loadu_si512(bytes + i);
+        acc = _mm512_add_epi64(acc, _mm512_and_si512(words, low_words));
+        acc = _mm512_add_epi64(acc, _mm512_maskz_srli_epi64(0xFF, words, 32)); // maskz: same warning otherwise
+    }
+    alignas(64) uint64_t lanes[8];
+    _mm512_store_si512(lanes, acc);
+    uint64_t sum = 0;
+    for (uint64_t lane : lanes) sum += lane;
+    return sum + checksumTail(bytes + i, size - i);
+}
+
+HFT_TARGET("avx512f,avx512bw,avx512vl")
+int64_t sumI64Avx512(const int64_t* values, size_t count) {
+    __m512i acc0 = _mm512_setzero_si512();
+    __m512i acc1 = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        acc0 = _mm512_add_epi64(acc0, _mm512_loadu_si512(values + i));
+        acc1 = _mm512_add_epi64(acc1, _mm512_loadu_si512(values + i + 8));
+    }
+    alignas(64) uint64_t lanes[8];
+    _mm512_store_si512(lanes, _mm512_add_epi64(acc0, acc1));
+    uint64_t sum = static_cast<uint64_t>(sumI64Scalar(values + i, count - i));
+    for (uint64_t lane : lanes) sum += lane;
+    return static_cast<int64_t>(sum);
+}
+
+/// Bit per row i < 16 (of valid) whose three values are all within range.
+HFT_TARGET("avx512f,avx512bw,avx512vl")
+inline __mmask16 inRangesAvx512(const uint64_t* a, const int64_t* b, const int32_t* c, __mmask16 valid,
+                                __m512i min_a, __m512i span_a, __m512i min_b, __m512i span_b, __m512i min_c,
+                                __m512i span_c) {
+    __mmask8 low = static_cast<__mmask8>(valid), high = static_cast<__mmask8>(valid >> 8);
+    __mmask8 a_low = _mm512_cmple_epu64_mask(_mm512_sub_epi64(_mm512_maskz_loadu_epi64(low, a), min_a), span_a);
+    __mmask8 a_high = _mm512_cmple_epu64_mask(_mm512_sub_epi64(_mm512_maskz_loadu_epi64(high, a + 8), min_a), span_a);
+    __mmask8 b_low = _mm512_cmple_epu64_mask(_mm512_sub_epi64(_mm512_maskz_loadu_epi64(low, b), min_b), span_b);
+    __mmask8 b_high = _mm512_cmple_epu64_mask(_mm512_sub_epi64(_mm512_maskz_loadu_epi64(high, b + 8), min_b), span_b);
+    __mmask16 in_c = _mm512_cmple_epu32_mask(_mm512_sub_epi32(_mm512_maskz_loadu_epi32(valid, c), min_c), span_c);
+    return static_cast<__mmask16>(((a_low & b_low) | ((a_high & b_high) << 8)) & in_c & valid);
+}
+
+/**
+ * @brief Sixteen rows per step: native unsigned compares into mask registers, then the matching
+ * indices are compressed in-register and stored whole (a compress straight to memory is
+ * microcoded on several cores). The tail uses masked loads and a masked compress-store.
+ */
+HFT_TARGET("avx512f,avx512bw,avx512vl,bmi2")
+size_t selectRangesAvx512(const uint64_t* a, const int64_t* b, const int32_t* c, size_t count,
+                          const ColumnRanges& ranges, uint32_t* selection) {
+    const __m512i min_a = _mm512_set1_epi64(static_cast<long long>(ranges.min_u64));
+    const __m512i min_b = _mm512_set1_epi64(ranges.min_i64);
+    const __m512i min_c = _mm512_set1_epi32(ranges.min_i32);
+    const __m512i span_a = _mm512_set1_epi64(static_cast<long long>(ranges.max_u64 - ranges.min_u64));
+    const __m512i span_b =
+        _mm512_set1_epi64(static_cast<long long>(static_cast<uint64_t>(ranges.max_i64) - static_cast<uint64_t>(ranges.min_i64)));
+    const __m512i span_c =
+        _mm512_set1_epi32(static_cast<int>(static_cast<uint32_t>(ranges.max_i32) - static_cast<uint32_t>(ranges.min_i32)));
+    __m512i indices = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i step = _mm512_set1_epi32(16);
+    size_t selected = 0;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __mmask16 match = inRangesAvx512(a + i, b + i, c + i, 0xFFFF, min_a, span_a, min_b, span_b, min_c, span_c);
+        _mm512_storeu_si512(selection + selected, _mm512_maskz_compress_epi32(match, indices)); // Within [0, i + 16)
+        selected += static_cast<size_t>(std::popcount(static_cast<unsigned>(match)));
+        indices = _mm512_add_epi32(indices, step);
+    }
+    if (i < count) {
+        __mmask16 valid = static_cast<__mmask16>(_bzhi_u32(0xFFFF, static_cast<unsigned>(count - i)));
+        __mmask16 match = inRangesAvx512(a + i, b + i, c + i, valid, min_a, span_a, min_b, span_b, min_c, span_c);
+        _mm512_mask_compressstoreu_epi32(selection + selected, match, indices);
+        selected += static_cast<size_t>(std::popcount(static_cast<unsigned>(match)));
+    }
+    return selected;
+}
+
+/// Eight lanes with native 64-bit max/min; a masked load covers the tail, so there is no scalar loop.
+HFT_TARGET("avx512f,avx512bw,avx512vl,bmi2")
+QuoteExtremes bestQuoteAvx512(const int64_t* bids, const int64_t* asks, size_t count) {
+    __m512i max = _mm512_set1_epi64(INT64_MIN);
+    __m512i min = _mm512_set1_epi64(INT64_MAX);
+    for (size_t i = 0; i < count; i += 8) {
+        __mmask8 valid = static_cast<__mmask8>(_bzhi_u32(0xFF, static_cast<unsigned>(std::min<size_t>(count - i, 8))));
+        max = _mm512_mask_max_epi64(max, valid, max, _mm512_maskz_loadu_epi64(valid, bids + i));
+        min = _mm512_mask_min_epi64(min, valid, min, _mm512_maskz_loadu_epi64(valid, asks + i));
+    }
+    alignas(64) int64_t max_lanes[8], min_lanes[8];
+    _mm512_store_si512(max_lanes, max);
+    _mm512_store_si512(min_lanes, min);
+    QuoteExtremes out{*std::max_element(max_lanes, max_lanes + 8), *std::min_element(min_lanes, min_lanes + 8), 0, 0};
+    const __m512i best_bid = _mm512_set1_epi64(out.bid);
+    const __m512i best_ask = _mm512_set1_epi64(out.ask);
+    for (size_t i = 0; i < count; i += 8) {
+        __mmask8 valid = static_cast<__mmask8>(_bzhi_u32(0xFF, static_cast<unsigned>(std::min<size_t>(count - i, 8))));
+        __mmask8 b = _mm512_mask_cmpeq_epi64_mask(valid, _mm512_maskz_loadu_epi64(valid, bids + i), best_bid);
+        __mmask8 a = _mm512_mask_cmpeq_epi64_mask(valid, _mm512_maskz_loadu_epi64(valid, asks + i), best_ask);
+        out.bid_mask |= static_cast<uint64_t>(b) << i;
+        out.ask_mask |= static_cast<uint64_t>(a) << i;
+    }
+    return out;
+}
+
+#endif // __x86_64__
+
+constexpr SimdKernels kScalarKernels{IsaLevel::Scalar, findDelimiterScalar, checksumScalar, sumI64Scalar,
+                                     decodeDeltaU64Scalar, decodeVarintU32Scalar, selectRangesScalar,
+                                     bestQuoteScalar};
+#if defined(__x86_64__)
+// The varint decoders are bound by the data-dependent input advance, not vector width, so wider
+// levels reuse the 128-bit shuffle variants.
+constexpr SimdKernels kSse42Kernels{IsaLevel::SSE42, findDelimiterSse42, checksumSse42, sumI64Sse42,
+                                    decodeDeltaU64Sse42, decodeVarintU32Sse42, selectRangesSse42, bestQuoteSse42};
+constexpr SimdKernels kAvx2Kernels{IsaLevel::AVX2, findDelimiterAvx2, checksumAvx2, sumI64Avx2,
+                                   decodeDeltaU64Sse42, decodeVarintU32Sse42, selectRangesAvx2, bestQuoteAvx2};
+constexpr SimdKernels kAvx512Kernels{IsaLevel::AVX512, findDelimiterAvx512, checksumAvx512, sumI64Avx512,
+                                     decodeDeltaU64Sse42, decodeVarintU32Sse42, selectRangesAvx512,
+                                     bestQuoteAvx512};
+#endif
+
+/**
+ * @brief Binds the kernels once at startup: detected level, or HFT_ISA if set.
+ */
+struct StartupBinding {
+    StartupBinding() noexcept {
+        IsaLevel level = detectedIsa();
+        if (const char* forced = std::getenv("HFT_ISA")) {
+            if (auto parsed = parseIsa(forced)) level = *parsed;
+        }
+        setSimdLevel(level);
+    }
+};
+
+} // namespace
+
+namespace simd_detail {
+constinit std::atomic<const SimdKernels*> active_kernels{&kScalarKernels};
+} // namespace simd_detail
+
+namespace {
+const StartupBinding startup_binding;
+} // namespace
+
+const SimdKernels& simdKernelsFor(IsaLevel level) noexcept {
+    level = std::min(level, detectedIsa());
+#if defined(__x86_64__)
+    switch (level) {
+    case IsaLevel::AVX512: return kAvx512Kernels;
+    case IsaLevel::AVX2: return kAvx2Kernels;
+    case IsaLevel::SSE42: return kSse42Kernels;
+    case IsaLevel::Scalar: break;
+    }
+#endif
+    return kScalarKernels;
+}
+
+IsaLevel setSimdLevel(IsaLevel level) noexcept {
+    const SimdKernels& kernels = simdKernelsFor(level);
+    simd_detail::active_kernels.store(&kernels, std::memory_order_relaxed);
+    return kernels.level;
+}
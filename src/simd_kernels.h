@@ -0,0 +1,116 @@
+#pragma once
+#include "cpu_features.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Inclusive bounds on three parallel columns (u64, i64, i32) for SimdKernels::select_ranges.
+ * Every min must be <= its max.
+ */
+struct ColumnRanges {
+    uint64_t min_u64, max_u64;
+    int64_t min_i64, max_i64;
+    int32_t min_i32, max_i32;
+};
+
+/**
+ * @brief Result of SimdKernels::best_quote.
+ */
+struct QuoteExtremes {
+    int64_t bid;       ///< Highest bid (INT64_MIN if count is 0).
+    int64_t ask;       ///< Lowest ask (INT64_MAX if count is 0).
+    uint64_t bid_mask; ///< Bit i set if bids[i] == bid.
+    uint64_t ask_mask; ///< Bit i set if asks[i] == ask.
+};
+
+/**
+ * @brief Table of vectorised kernels bound to one ISA level.
+ *
+ * Every kernel has a scalar implementation plus SSE4.2, AVX2 and AVX-512 variants where they pay
+ * off; all variants of a kernel return bit-identical results. New kernels are added as a field
+ * here and an entry in each level's table in simd_kernels.cpp.
+ */
+struct SimdKernels {
+    IsaLevel level; ///< ISA level of this table.
+
+    /**
+     * @brief Finds the first byte equal to a or b in [begin, end) (CSV field/line scanning).
+     * @return Pointer to the match, or end if there is none.
+     */
+    const char* (*find_delimiter)(const char* begin, const char* end, char a, char b);
+
+    /**
+     * @brief Sums the buffer as little-endian 32-bit words (trailing bytes zero-padded) modulo 2^64.
+     */
+    uint64_t (*checksum)(const void* data, size_t size);
+
+    /**
+     * @brief Sums a column of 64-bit integers (SoA aggregation), wrapping on overflow.
+     */
+    int64_t (*sum_i64)(const int64_t* values, size_t count);
+
+    /**
+     * @brief Decodes count zig-zag deltas and writes their running sum: out[i] = start + d[0] + ... + d[i]
+     * (modulo 2^64).
+     *
+     * Deltas are 1, 2, 4 or 8 little-endian bytes in data; control holds a 2-bit length code per
+     * value (log2 of the byte count), four per byte, lowest bits first (see tick_codec.h).
+     * @return End of the consumed data, or nullptr if the values would run past data_end.
+     */
+    const uint8_t* (*decode_delta_u64)(const uint8_t* control, const uint8_t* data, const uint8_t* data_end,
+                                       size_t count, uint64_t start, uint64_t* out);
+
+    /**
+     * @brief Decodes count values of 1-4 little-endian bytes each (stream VByte): control holds a
+     * 2-bit code (byte count - 1) per value, four per byte, lowest bits first.
+     * @return End of the consumed data, or nullptr if the values would run past data_end.
+     */
+    const uint8_t* (*decode_varint_u32)(const uint8_t* control, const uint8_t* data, const uint8_t* data_end,
+                                        size_t count, uint32_t* out);
+
+    /**
+     * @brief Writes the indices i < count at which a[i], b[i] and c[i] all lie within ranges to
+     * selection, in ascending order (a selection vector), and returns how many there are.
+     * selection must have room for count indices.
+     */
+    size_t (*select_ranges)(const uint64_t* a, const int64_t* b, const int32_t* c, size_t count,
+                            const ColumnRanges& ranges, uint32_t* selection);
+
+    /**
+     * @brief Finds the highest of count bids and the lowest of count asks (count <= 64), with a
+     * bit per index holding each (per-venue quote consolidation). Callers mark a missing bid with
+     * INT64_MIN and a missing ask with INT64_MAX, so they never beat a real price.
+     */
+    QuoteExtremes (*best_quote)(const int64_t* bids, const int64_t* asks, size_t count);
+};
+
+namespace simd_detail {
+/// Active table. Starts at the scalar table and is rebound once at startup (see setSimdLevel()).
+extern std::atomic<const SimdKernels*> active_kernels;
+} // namespace simd_detail
+
+/**
+ * @brief Returns the kernel table bound for this process.
+ *
+ * A relaxed pointer load plus an indirect call per kernel invocation. Kernels are meant to
+ * process whole buffers, so the dispatch cost is amortised.
+ */
+inline const SimdKernels& simd() noexcept {
+    return *simd_detail::active_kernels.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the table for a specific ISA level, clamped to what the CPU supports.
+ */
+const SimdKernels& simdKernelsFor(IsaLevel level) noexcept;
+
+/**
+ * @brief Rebinds simd() to the given level (clamped to the detected level).
+ * @return The level actually bound.
+ *
+ * Called automatically at startup with the detected level, or the level named by the HFT_ISA
+ * environment variable (e.g. HFT_ISA=avx2) to emulate an older host. Benchmarks call it to
+ * compare levels; it is not meant to be called while other threads use kernels.
+ */
+IsaLevel setSimdLevel(IsaLevel level) noexcept;
@@ -0,0 +1,180 @@
+#include "simulated_exchange.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+size_t checkedCapacity(size_t capacity) {
+    if (capacity == 0 || capacity >= UINT32_MAX) {
+        throw std::runtime_error("SimulatedExchange: capacity must be between 1 and 2^32 - 2");
+    }
+    return capacity;
+}
+
+size_t checkedOrders(size_t max_orders) {
+    if (max_orders == 0 || max_orders >= UINT32_MAX) {
+        throw std::runtime_error("SimulatedExchange: max_orders must be between 1 and 2^32 - 2");
+    }
+    return max_orders;
+}
+
+} // namespace
+
+SimulatedExchange::SimulatedExchange(TimerWheel& timers, size_t max_symbols, size_t max_orders, LatencyModel outbound,
+                                     LatencyModel inbound, ReportSink sink, void* context, size_t capacity)
+    : timers_(timers), outbound_(std::move(outbound)), inbound_(std::move(inbound)), sink_(sink), context_(context),
+      messages_(checkedCapacity(capacity)), free_(0), last_prices_(max_symbols, 0), orders_(checkedOrders(max_orders)),
+      queues_(max_symbols) {
+    for (size_t slot = 0; slot < messages_.size(); ++slot) messages_[slot].next_free = static_cast<uint32_t>(slot + 1);
+}
+
+bool SimulatedExchange::send(ClientOrderId id, uint32_t symbol, Side side, FixedPrice price, int64_t quantity) noexcept {
+    Message message;
+    message.kind = MessageKind::NewOrder;
+    message.side = side;
+    message.symbol = symbol;
+    message.price = price;
+    message.quantity = quantity;
+    message.report.id = id;
+    return post(message, outbound_, outbound_last_);
+}
+
+bool SimulatedExchange::sendCancel(ClientOrderId id) noexcept {
+    Message message;
+    message.kind = MessageKind::Cancel;
+    message.report.id = id;
+    return post(message, outbound_, outbound_last_);
+}
+
+bool SimulatedExchange::respond(ClientOrderId id, ExecType type, int64_t quantity, FixedPrice price) noexcept {
+    Message message;
+    message.report = ExecutionReport{id, type, quantity, price};
+    return post(message, inbound_, inbound_last_);
+}
+
+/**
+ * @brief Schedules a message after the link's latency. Arrivals on a link strictly increase (and
+ * are at least 1 ns away, the wheel's next unit), because a wheel slot fires newest first: two
+ * messages due in the same nanosecond would be delivered out of order.
+ */
+bool SimulatedExchange::post(Message message, LatencyModel& latency, uint64_t& last) noexcept {
+    const uint32_t slot = free_;
+    const uint64_t now = timers_.now();
+    const uint64_t arrival = std::max({now + latency.sample(now), now + 1, last + 1});
+    if (slot == messages_.size() || timers_.schedule(arrival, deliver, this, slot) == kInvalidTimer) {
+        ++stats_.dropped;
+        return false;
+    }
+    last = arrival;
+    free_ = messages_[slot].next_free;
+    messages_[slot] = message;
+    ++in_flight_;
+    return true;
+}
+
+void SimulatedExchange::deliver(void* context, uint64_t slot) {
+    SimulatedExchange& exchange = *static_cast<SimulatedExchange*>(context);
+    const Message message = exchange.messages_[slot];
+    exchange.messages_[slot].next_free = exchange.free_;
+    exchange.free_ = static_cast<uint32_t>(slot);
+    --exchange.in_flight_;
+    switch (message.kind) {
+    case MessageKind::NewOrder: exchange.arrive(message); break;
+    case MessageKind::Cancel: exchange.cancel(message.report.id); break;
+    case MessageKind::Report: exchange.sink_(exchange.context_, message.report); break;
+    }
+}
+
+/**
+ * @brief A new order reaches the exchange. An ID whose slot is out of range, still resting, or
+ * already used by this ID (even if that order filled on arrival) is rejected as a duplicate.
+ */
+void SimulatedExchange::arrive(const Message& message) {
+    const ClientOrderId id = message.report.id;
+    const auto slot = static_cast<uint32_t>(id);
+    ++stats_.orders;
+    const bool fresh = slot < orders_.size() && orders_[slot].id != id && !orders_[slot].resting;
+    if (fresh) orders_[slot].id = id;
+    if (!fresh || message.symbol >= queues_.size() || message.price <= 0 || message.quantity <= 0) {
+        ++stats_.rejects;
+        respond(id, ExecType::Reject, 0, 0);
+        return;
+    }
+    respond(id, ExecType::Ack, 0, 0);
+    const FixedPrice last = last_prices_[message.symbol];
+    const bool marketable = last != 0 && (message.side == Side::Bid ? message.price >= last : message.price <= last);
+    if (marketable) {
+        ++stats_.fills;
+        stats_.filled_quantity += message.quantity;
+        respond(id, ExecType::Fill, message.quantity, last);
+        return;
+    }
+    RestingOrder& order = orders_[slot];
+    OrderQueue& queue = queues_[message.symbol];
+    order.price = message.price;
+    order.leaves = message.quantity;
+    order.symbol = message.symbol;
+    order.side = message.side;
+    order.resting = true;
+    order.prev = queue.tail;
+    order.next = kNoOrder;
+    if (queue.tail == kNoOrder) {
+        queue.head = slot;
+    } else {
+        orders_[queue.tail].next = slot;
+    }
+    queue.tail = slot;
+    ++resting_;
+}
+
+void SimulatedExchange::cancel(ClientOrderId id) {
+    const auto slot = static_cast<uint32_t>(id);
+    if (slot >= orders_.size() || orders_[slot].id != id || !orders_[slot].resting) {
+        ++stats_.cancel_rejects;
+        respond(id, ExecType::CancelReject, 0, 0);
+        return;
+    }
+    unlink(slot);
+    ++stats_.cancels;
+    respond(id, ExecType::CancelAck, 0, 0);
+}
+
+void SimulatedExchange::match(uint32_t symbol, FixedPrice price, int64_t volume) noexcept {
+    int64_t remaining = volume;
+    for (uint32_t slot = queues_[symbol].head; slot != kNoOrder && remaining > 0;) {
+        RestingOrder& order = orders_[slot];
+        const uint32_t next = order.next;
+        const bool through = order.side == Side::Bid ? price < order.price : price > order.price;
+        if (through) {
+            const int64_t quantity = std::min(order.leaves, remaining);
+            remaining -= quantity;
+            order.leaves -= quantity;
+            ++stats_.fills;
+            stats_.filled_quantity += quantity;
+            respond(order.id, ExecType::Fill, quantity, order.price);
+            if (order.leaves == 0) unlink(slot);
+        }
+        slot = next;
+    }
+}
+
+/**
+ * @brief Removes a resting order from its symbol's queue. The slot keeps its ID for duplicate checks.
+ */
+void SimulatedExchange::unlink(uint32_t slot) noexcept {
+    RestingOrder& order = orders_[slot];
+    OrderQueue& queue = queues_[order.symbol];
+    if (order.prev == kNoOrder) {
+        queue.head = order.next;
+    } else {
+        orders_[order.prev].next = order.next;
+    }
+    if (order.next == kNoOrder) {
+        queue.tail = order.prev;
+    } else {
+        orders_[order.next].prev = order.prev;
+    }
+    order.resting = false;
+    --resting_;
+}
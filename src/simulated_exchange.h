@@ -0,0 +1,145 @@
+#pragma once
+#include "fixed_price.h"
+#include "latency_model.h"
+#include "order_manager.h"
+#include "timer_wheel.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Receives the exchange's responses once they reach us (after the inbound latency).
+using ReportSink = void (*)(void* context, const ExecutionReport& report);
+
+struct ExchangeStats {
+    uint64_t orders = 0;          ///< New orders that reached the exchange.
+    uint64_t rejects = 0;         ///< Orders refused (unknown symbol, bad price or quantity).
+    uint64_t fills = 0;           ///< Fill reports sent.
+    int64_t filled_quantity = 0;  ///< Quantity filled over all orders.
+    uint64_t cancels = 0;         ///< Cancels that removed a resting order.
+    uint64_t cancel_rejects = 0;  ///< Cancels that found nothing to cancel (filled, or arrived first).
+    uint64_t dropped = 0;         ///< Messages lost because the pool or the timer wheel was full.
+};
+
+/**
+ * @brief A local matching engine for backtests, reached through modelled network latency.
+ *
+ * Orders and cancels sent at virtual time t arrive at the exchange at t + outbound latency, and
+ * every response (ack, reject, fill, cancel ack or reject) reaches the report sink after the
+ * inbound latency, both scheduled as timers on the simulation's TimerWheel (its now() is the
+ * virtual clock). Each link is FIFO: a message never arrives before one sent earlier on it, so a
+ * latency spike delays everything behind it, as on a TCP session. Each message takes at least
+ * 1 ns, so the timer wheel must have a 1 ns resolution (as simulate()'s does).
+ *
+ * Matching follows the trade tape fed through onTrade(): an arriving limit order that is
+ * marketable against the last trade price fills in full at that price; otherwise it rests, and
+ * later trades strictly through its limit fill it at the limit, in time priority, up to each
+ * trade's volume. So an order only fills at prices the market traded at after it arrived, not at
+ * the price the strategy saw when it sent the order.
+ *
+ * In-flight messages come from a fixed pool, and orders are kept by the slot of their client order
+ * ID in a preallocated array, linked into an intrusive FIFO queue per symbol: arriving, cancelling
+ * and filling never allocate or hash. A trade for a symbol with no resting orders costs a store
+ * and a load (plus the load model's count), so feeding every update adds little to a run.
+ *
+ * Owned by the simulation thread; not thread-safe.
+ */
+class SimulatedExchange {
+public:
+    /**
+     * @param timers Wheel driven in virtual nanoseconds (MarketDataParser::timers() in simulate()).
+     * @param max_symbols Symbol IDs accepted, as in MarketState.
+     * @param max_orders Client order ID slots accepted (the OrderManager's capacity).
+     * @param outbound Latency from us to the exchange.
+     * @param inbound Latency from the exchange to us.
+     * @param capacity Messages in flight at once, both ways.
+     * @throws std::runtime_error if capacity or max_orders is 0 or does not fit in 32 bits.
+     */
+    SimulatedExchange(TimerWheel& timers, size_t max_symbols, size_t max_orders, LatencyModel outbound,
+                      LatencyModel inbound, ReportSink sink, void* context, size_t capacity = 65536);
+
+    /**
+     * @brief Sends a new limit order now; it reaches the exchange after the outbound latency.
+     * @return False if the message could not be sent (capacity in flight).
+     */
+    bool send(ClientOrderId id, uint32_t symbol, Side side, FixedPrice price, int64_t quantity) noexcept;
+
+    /**
+     * @brief Sends a cancel now, answered with CancelAck or CancelReject.
+     * @return False if the message could not be sent.
+     */
+    bool sendCancel(ClientOrderId id) noexcept;
+
+    /**
+     * @brief A trade print from the feed at the wheel's current time: the price marketable orders
+     * fill at, and liquidity for resting orders it trades through.
+     */
+    void onTrade(uint32_t symbol, FixedPrice price, int64_t volume) noexcept {
+        if (symbol >= last_prices_.size()) return;
+        last_prices_[symbol] = price;
+        const uint64_t now = timers_.now();
+        outbound_.observe(now);
+        inbound_.observe(now);
+        if (queues_[symbol].head != kNoOrder) match(symbol, price, volume);
+    }
+
+    size_t resting() const noexcept { return resting_; }    ///< Orders resting on the exchange.
+    size_t inFlight() const noexcept { return in_flight_; } ///< Messages on the wire.
+    const ExchangeStats& stats() const noexcept { return stats_; }
+
+private:
+    static constexpr uint32_t kNoOrder = UINT32_MAX;
+
+    enum class MessageKind : uint8_t { NewOrder, Cancel, Report };
+
+    struct Message {
+        MessageKind kind = MessageKind::Report;
+        Side side = Side::Bid;
+        uint32_t symbol = 0;
+        uint32_t next_free = 0;
+        FixedPrice price = 0;
+        int64_t quantity = 0;
+        ExecutionReport report{};  ///< Report, or the order ID for NewOrder and Cancel.
+    };
+
+    /// Order slot, indexed by the client order ID's slot.
+    struct RestingOrder {
+        ClientOrderId id = kInvalidOrderId; ///< Latest order that arrived in this slot.
+        FixedPrice price = 0;
+        int64_t leaves = 0;
+        uint32_t symbol = 0;
+        uint32_t prev = kNoOrder;           ///< Neighbours in the symbol's queue.
+        uint32_t next = kNoOrder;
+        Side side = Side::Bid;
+        bool resting = false;               ///< Linked into its symbol's queue.
+    };
+
+    /// Resting orders of one symbol, oldest first.
+    struct OrderQueue {
+        uint32_t head = kNoOrder;
+        uint32_t tail = kNoOrder;
+    };
+
+    static void deliver(void* context, uint64_t slot);
+    bool post(Message message, LatencyModel& latency, uint64_t& last) noexcept;
+    bool respond(ClientOrderId id, ExecType type, int64_t quantity, FixedPrice price) noexcept;
+    void arrive(const Message& message);
+    void cancel(ClientOrderId id);
+    void match(uint32_t symbol, FixedPrice price, int64_t volume) noexcept;
+    void unlink(uint32_t slot) noexcept;
+
+    TimerWheel& timers_;
+    LatencyModel outbound_;
+    LatencyModel inbound_;
+    ReportSink sink_;
+    void* context_;
+    std::vector<Message> messages_;                   ///< In-flight message pool.
+    uint32_t free_;                                   ///< Free-list head (messages_.size() when empty).
+    size_t in_flight_ = 0;
+    uint64_t outbound_last_ = 0;                      ///< Latest arrival scheduled on each link (FIFO).
+    uint64_t inbound_last_ = 0;
+    std::vector<FixedPrice> last_prices_;             ///< Last trade per symbol ID (0 before the first).
+    std::vector<RestingOrder> orders_;                ///< Order per client order ID slot.
+    std::vector<OrderQueue> queues_;                  ///< Resting order queue per symbol ID.
+    size_t resting_ = 0;
+    ExchangeStats stats_;
+};
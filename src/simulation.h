@@ -0,0 +1,62 @@
+#pragma once
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+
+class MarketDataParser;
+
+/**
+ * @brief Virtual-time settings for MarketDataParser::simulate().
+ */
+struct SimulationConfig {
+    uint64_t start_ns = 0;                   ///< Virtual time of the first CSV line or demo batch.
+    uint64_t spacing_ns = 1000;              ///< Virtual time between CSV lines, which carry no timestamps.
+    uint64_t batch_spacing_ns = 100'000'000; ///< Virtual time between demo batches (generateData()'s sleep).
+    uint64_t linger_ns = 0;                  ///< Virtual time to keep firing timers after the last event.
+};
+
+/**
+ * @brief Outcome of a simulation run. Everything but wall_seconds is identical run to run for the
+ * same input, configuration and handler.
+ */
+struct SimulationResult {
+    size_t events = 0;        ///< Updates applied.
+    size_t filtered = 0;      ///< Updates rejected by the subscription filter.
+    size_t dropped = 0;       ///< Updates for new symbols dropped with the symbol directory full.
+    size_t timers_fired = 0;  ///< Timer callbacks run.
+    uint64_t first_ns = 0;    ///< Virtual time of the first event.
+    uint64_t last_ns = 0;     ///< Virtual time when the run ended (after linger_ns).
+    double wall_seconds = 0;  ///< Wall-clock duration of the run.
+    uint64_t digest = 0;      ///< FNV-1a of the final market state, positions and baskets, bit for bit.
+};
+
+/**
+ * @brief Strategy hooks for MarketDataParser::simulate(). Every call runs on the simulating thread
+ * in virtual time (parser.now()), in a fixed order: timers due at or before an event's time fire
+ * first, then the update is applied, then onUpdate() runs.
+ */
+class SimulationHandler {
+public:
+    virtual ~SimulationHandler() = default;
+
+    /**
+     * @brief Called once the virtual clock is set to the first event's time, before any event;
+     * the place to schedule initial timers (e.g. heartbeats) on parser.timers().
+     */
+    virtual void onStart(MarketDataParser& parser) { (void)parser; }
+
+    /**
+     * @brief Called after each update is applied to the market state, positions and baskets.
+     * @param symbol MarketState symbol ID of the update.
+     */
+    virtual void onUpdate(MarketDataParser& parser, uint32_t symbol, const MarketData& data) {
+        (void)parser;
+        (void)symbol;
+        (void)data;
+    }
+
+    /**
+     * @brief Called after the last event and linger_ns of timers, before the digest is taken.
+     */
+    virtual void onFinish(MarketDataParser& parser) { (void)parser; }
+};
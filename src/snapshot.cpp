@@ -0,0 +1,113 @@
+#include "snapshot.h"
+#include "file_io.h"
+#include "journal.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kSnapshotMagic[8] = {'H', 'F', 'T', 'S', 'N', 'A', 'P', '\0'};
+constexpr uint64_t kSectionAlignment = 64;
+
+uint64_t alignUp(uint64_t offset) {
+    return (offset + kSectionAlignment - 1) & ~(kSectionAlignment - 1);
+}
+
+/**
+ * @brief Appends a section at the next aligned offset, zero-filling the gap.
+ */
+void writeSection(int fd, uint64_t& offset, uint64_t section_offset, const void* data, size_t size) {
+    static const uint8_t zeros[kSectionAlignment] = {};
+    if (section_offset > offset) writeAll(fd, zeros, section_offset - offset);
+    if (size > 0) writeAll(fd, data, size);
+    offset = section_offset + size;
+}
+
+} // namespace
+
+/**
+ * @brief Lays out sections back to back at aligned offsets and commits the file atomically.
+ */
+void writeSnapshot(const std::string& path, const MarketState& state,
+                   std::span<const std::byte> strategy_state) {
+    const SymbolDirectory& directory = state.directory();
+    const uint64_t symbols = directory.size();
+    const uint64_t slots = directory.slotKeys().size();
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+    header.version = kSnapshotVersion;
+    header.sequence = state.sequence();
+    header.symbol_count = symbols;
+    header.slot_count = slots;
+    header.tickers_offset = alignUp(sizeof(SnapshotHeader));
+    header.slot_keys_offset = alignUp(header.tickers_offset + symbols * sizeof(uint64_t));
+    header.slot_ids_offset = alignUp(header.slot_keys_offset + slots * sizeof(uint64_t));
+    header.states_offset = alignUp(header.slot_ids_offset + slots * sizeof(uint32_t));
+    header.strategy_offset = alignUp(header.states_offset + symbols * sizeof(SymbolState));
+    header.strategy_size = strategy_state.size();
+    header.file_size = header.strategy_offset + header.strategy_size;
+
+    std::string tmp_path = path + ".tmp";
+    int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) throw std::runtime_error("Failed to open " + tmp_path);
+    try {
+        uint64_t offset = 0;
+        writeSection(fd, offset, 0, &header, sizeof(header));
+        writeSection(fd, offset, header.tickers_offset, directory.tickers().data(), symbols * sizeof(uint64_t));
+        writeSection(fd, offset, header.slot_keys_offset, directory.slotKeys().data(), slots * sizeof(uint64_t));
+        writeSection(fd, offset, header.slot_ids_offset, directory.slotIds().data(), slots * sizeof(uint32_t));
+        writeSection(fd, offset, header.states_offset, state.states().data(), symbols * sizeof(SymbolState));
+        writeSection(fd, offset, header.strategy_offset, strategy_state.data(), strategy_state.size());
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    commitFile(fd, tmp_path, path);
+}
+
+/**
+ * @brief Validates magic, version and that every section lies inside the mapping.
+ */
+SnapshotView::SnapshotView(const std::string& path) : file_(path) {
+    if (file_.size() < sizeof(SnapshotHeader)) throw std::runtime_error("Snapshot too small: " + path);
+    header_ = reinterpret_cast<const SnapshotHeader*>(file_.data());
+    if (std::memcmp(header_->magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+        header_->version != kSnapshotVersion) {
+        throw std::runtime_error("Not a snapshot file: " + path);
+    }
+    if (header_->file_size != file_.size() ||
+        header_->tickers_offset + header_->symbol_count * sizeof(uint64_t) > file_.size() ||
+        header_->slot_keys_offset + header_->slot_count * sizeof(uint64_t) > file_.size() ||
+        header_->slot_ids_offset + header_->slot_count * sizeof(uint32_t) > file_.size() ||
+        header_->states_offset + header_->symbol_count * sizeof(SymbolState) > file_.size() ||
+        header_->strategy_offset + header_->strategy_size > file_.size()) {
+        throw std::runtime_error("Truncated snapshot: " + path);
+    }
+}
+
+/**
+ * @brief Restores by bulk copy; the directory's hash index is persisted, so nothing is rehashed.
+ */
+void SnapshotView::restoreInto(MarketState& state) const {
+    state.directory().restore(tickers(), slotKeys(), slotIds(), header_->symbol_count, header_->slot_count);
+    state.restoreStates(states(), header_->symbol_count, header_->sequence);
+}
+
+/**
+ * @brief Snapshot first, then only the journal records it does not already cover.
+ */
+RecoveryResult recoverMarketState(const std::string& snapshot_path, const std::string& journal_path,
+                                  MarketState& state) {
+    RecoveryResult result;
+    if (::access(snapshot_path.c_str(), F_OK) == 0) {
+        SnapshotView snapshot(snapshot_path);
+        snapshot.restoreInto(state);
+        result.snapshot_loaded = true;
+        result.snapshot_sequence = snapshot.header().sequence;
+    }
+    result.replayed = Journal::replay(journal_path, result.snapshot_sequence, [&](const JournalRecord& record) {
+        state.apply(record.ticker, record.price, record.volume, record.sequence);
+    });
+    return result;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include "mapped_file.h"
+#include "market_state.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+/**
+ * @brief Fixed header at offset 0 of a snapshot file.
+ *
+ * Every section is stored at a 64-byte aligned offset in exactly its in-memory layout, so a mapped
+ * snapshot is usable through typed pointers without parsing.
+ */
+struct SnapshotHeader {
+    char magic[8];            ///< "HFTSNAP" plus NUL.
+    uint32_t version;         ///< Layout version (kSnapshotVersion).
+    uint32_t reserved;        ///< Zero.
+    uint64_t sequence;        ///< Journal sequence the snapshot covers.
+    uint64_t symbol_count;    ///< Number of symbols in the directory and state table.
+    uint64_t slot_count;      ///< Symbol directory slot count.
+    uint64_t tickers_offset;  ///< uint64_t[symbol_count] packed tickers in ID order.
+    uint64_t slot_keys_offset;///< uint64_t[slot_count] directory slot keys.
+    uint64_t slot_ids_offset; ///< uint32_t[slot_count] directory slot IDs.
+    uint64_t states_offset;   ///< SymbolState[symbol_count].
+    uint64_t strategy_offset; ///< Opaque strategy state bytes.
+    uint64_t strategy_size;   ///< Length of the strategy state.
+    uint64_t file_size;       ///< Total file length, used to detect truncated files.
+};
+
+inline constexpr uint32_t kSnapshotVersion = 1;
+
+/**
+ * @brief Writes a snapshot of market state and opaque strategy state.
+ * @param path Destination file; replaced atomically once the snapshot is durable.
+ * @param state Market state to persist.
+ * @param strategy_state Opaque strategy bytes stored alongside the books.
+ * @throws std::runtime_error on I/O failure.
+ */
+void writeSnapshot(const std::string& path, const MarketState& state,
+                   std::span<const std::byte> strategy_state = {});
+
+/**
+ * @brief Read-only, mmap-backed view of a snapshot file.
+ *
+ * The constructor validates the header and section bounds once; accessors then return pointers
+ * straight into the mapping.
+ */
+class SnapshotView {
+public:
+    /**
+     * @brief Maps and validates the snapshot at path.
+     * @throws std::runtime_error if the file is missing, truncated or not a snapshot.
+     */
+    explicit SnapshotView(const std::string& path);
+
+    const SnapshotHeader& header() const noexcept { return *header_; }
+    const uint64_t* tickers() const noexcept { return at<uint64_t>(header_->tickers_offset); }
+    const uint64_t* slotKeys() const noexcept { return at<uint64_t>(header_->slot_keys_offset); }
+    const uint32_t* slotIds() const noexcept { return at<uint32_t>(header_->slot_ids_offset); }
+    const SymbolState* states() const noexcept { return at<SymbolState>(header_->states_offset); }
+
+    std::span<const std::byte> strategyState() const noexcept {
+        return {at<std::byte>(header_->strategy_offset), header_->strategy_size};
+    }
+
+    /**
+     * @brief Copies the snapshot's directory and states into state.
+     * @throws std::runtime_error if the directory capacity does not match.
+     */
+    void restoreInto(MarketState& state) const;
+
+private:
+    template <typename T>
+    const T* at(uint64_t offset) const noexcept {
+        return reinterpret_cast<const T*>(file_.data() + offset);
+    }
+
+    MappedFile file_;                         ///< Mapping of the snapshot file.
+    const SnapshotHeader* header_ = nullptr;  ///< Header at the start of the mapping.
+};
+
+/**
+ * @brief Outcome of recoverMarketState().
+ */
+struct RecoveryResult {
+    bool snapshot_loaded = false; ///< True if a snapshot was restored.
+    uint64_t snapshot_sequence = 0; ///< Sequence covered by the snapshot.
+    size_t replayed = 0;          ///< Journal records replayed on top of it.
+};
+
+/**
+ * @brief Rebuilds market state after a restart: load the snapshot if present, then replay the
+ * journal tail newer than it.
+ * @param snapshot_path Snapshot file; may be absent.
+ * @param journal_path Journal path (see Journal); may have no segments.
+ * @param state State to restore into; expected to be empty.
+ */
+RecoveryResult recoverMarketState(const std::string& snapshot_path, const std::string& journal_path,
+                                  MarketState& state);
@@ -0,0 +1,69 @@
+#pragma once
+#include "padded_counter.h"
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * @brief Bounded single-producer, single-consumer ring of trivially copyable values.
+ * @tparam T Element type.
+ * @tparam Capacity Number of slots; must be a power of two.
+ *
+ * A generic companion to LockFreeQueue for small handoff records (block descriptors, quotes,
+ * timer events) that do not need a MemoryPool. Indices increase monotonically and are masked on
+ * access; each side caches the other's index so the shared line is only read when the cached
+ * value says the ring looks full or empty.
+ */
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "SpscRing holds trivially copyable values");
+
+public:
+    /**
+     * @brief Pushes a value (producer only).
+     * @return False if the ring is full.
+     */
+    bool push(const T& value) noexcept {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == Capacity) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == Capacity) return false;
+        }
+        slots_[tail & (Capacity - 1)] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pops the oldest value (consumer only).
+     * @return False if the ring is empty.
+     */
+    bool pop(T& value) noexcept {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) return false;
+        }
+        value = slots_[head & (Capacity - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Approximate number of queued values; exact when called by either side while the other is idle.
+     */
+    size_t size() const noexcept {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+    static constexpr size_t capacity() noexcept { return Capacity; }
+
+private:
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0}; ///< Next slot to pop, written by the consumer.
+    size_t cached_tail_ = 0;                              ///< Consumer's last observed tail.
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0}; ///< Next slot to push, written by the producer.
+    size_t cached_head_ = 0;                              ///< Producer's last observed head.
+    alignas(kCacheLineSize) T slots_[Capacity];           ///< Ring storage.
+};
@@ -0,0 +1,187 @@
+#pragma once
+#include "symbol_directory.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Set of subscribed tickers checked by producers before an update takes a queue slot.
+ *
+ * Tickers are interned into dense subscription IDs by an insert-only open-addressing table, and
+ * a bitset indexed by ID says which are currently subscribed. An optional Bloom filter over the
+ * packed ticker bytes rejects most unsubscribed tickers with two bit tests in a table that stays
+ * in L1, before the hash table is probed at all.
+ *
+ * Readers never lock: accepts() only performs atomic loads, so any number of producer threads can
+ * check it while a control thread subscribes and unsubscribes. Writers are serialised by a mutex.
+ * A change becomes visible to producers within a few updates, not at a synchronised instant.
+ * Interned tickers are never removed (unsubscribing clears the bit), and Bloom bits are only ever
+ * set, so a ticker that was unsubscribed merely costs a table probe again.
+ */
+class SubscriptionFilter {
+public:
+    static constexpr size_t kDefaultBloomBits = 1 << 16; ///< 8 KiB; ~1e-4 false positives at 300 symbols.
+
+    /**
+     * @brief Constructs a filter that accepts everything until setAcceptAll(false).
+     * @param max_symbols Maximum number of distinct tickers ever subscribed.
+     * @param bloom_bits Bloom filter size, rounded up to a power of two; 0 disables the pre-check.
+     */
+    explicit SubscriptionFilter(size_t max_symbols, size_t bloom_bits = kDefaultBloomBits)
+        : max_symbols_(max_symbols), bits_((max_symbols + 63) / 64) {
+        size_t slots = 16;
+        while (slots < max_symbols * 2) slots <<= 1;
+        slot_keys_ = std::vector<std::atomic<uint64_t>>(slots);
+        slot_ids_ = std::vector<std::atomic<uint32_t>>(slots);
+        shift_ = 64 - static_cast<unsigned>(__builtin_ctzll(slots));
+        if (bloom_bits > 0) {
+            size_t words = 1;
+            while (words * 64 < bloom_bits) words <<= 1;
+            bloom_ = std::vector<std::atomic<uint64_t>>(words);
+            bloom_mask_ = words * 64 - 1;
+        }
+    }
+
+    /**
+     * @brief Hot path: true if updates for the packed ticker should be enqueued.
+     */
+    bool accepts(uint64_t key) const noexcept {
+        if (accept_all_.load(std::memory_order_relaxed)) return true;
+        if (bloom_mask_ != 0 && !bloomMayContain(key)) return false;
+        uint32_t id = find(key);
+        return id != kInvalidSymbol && (bits_[id >> 6].load(std::memory_order_relaxed) >> (id & 63) & 1) != 0;
+    }
+
+    bool accepts(std::string_view ticker) const noexcept { return accepts(packTicker(ticker)); }
+
+    /**
+     * @brief Subscribes to a packed ticker (see packTicker); must be non-zero.
+     * @return True if it was not already subscribed.
+     * @throws std::runtime_error if key is 0 (the empty ticker) or max_symbols distinct tickers
+     * have already been interned.
+     */
+    bool subscribe(uint64_t key) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        uint32_t id = intern(key);
+        if (bloom_mask_ != 0) {
+            uint64_t h = mix(key);
+            setBit(bloom_, h & bloom_mask_);
+            setBit(bloom_, (h >> 32) & bloom_mask_);
+        }
+        bool added = !setBit(bits_, id);
+        if (added) ++subscribed_;
+        return added;
+    }
+
+    bool subscribe(std::string_view ticker) { return subscribe(packTicker(ticker)); }
+
+    /**
+     * @brief Unsubscribes from a packed ticker.
+     * @return True if it was subscribed.
+     */
+    bool unsubscribe(uint64_t key) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        uint32_t id = find(key);
+        if (id == kInvalidSymbol) return false;
+        uint64_t bit = uint64_t{1} << (id & 63);
+        bool removed = (bits_[id >> 6].fetch_and(~bit, std::memory_order_relaxed) & bit) != 0;
+        if (removed) --subscribed_;
+        return removed;
+    }
+
+    bool unsubscribe(std::string_view ticker) { return unsubscribe(packTicker(ticker)); }
+
+    /**
+     * @brief Switches between passing every update (the default) and filtering by subscription.
+     */
+    void setAcceptAll(bool accept_all) noexcept { accept_all_.store(accept_all, std::memory_order_relaxed); }
+    bool acceptAll() const noexcept { return accept_all_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Number of tickers currently subscribed.
+     */
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        return subscribed_;
+    }
+
+    size_t capacity() const noexcept { return max_symbols_; }
+
+private:
+    /// Murmur3 finaliser: every key byte affects both halves, unlike a bare multiply.
+    static uint64_t mix(uint64_t key) noexcept {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        return key ^ (key >> 33);
+    }
+
+    bool bloomMayContain(uint64_t key) const noexcept {
+        uint64_t h = mix(key);
+        size_t a = h & bloom_mask_;
+        size_t b = (h >> 32) & bloom_mask_;
+        return (bloom_[a >> 6].load(std::memory_order_relaxed) >> (a & 63) & 1) != 0 &&
+               (bloom_[b >> 6].load(std::memory_order_relaxed) >> (b & 63) & 1) != 0;
+    }
+
+    /// Sets bit i; returns its previous value.
+    static bool setBit(std::vector<std::atomic<uint64_t>>& words, size_t i) noexcept {
+        uint64_t bit = uint64_t{1} << (i & 63);
+        return (words[i >> 6].fetch_or(bit, std::memory_order_relaxed) & bit) != 0;
+    }
+
+    size_t hash(uint64_t key) const noexcept {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+
+    /**
+     * @brief Looks up a ticker's ID; safe against a concurrent intern().
+     *
+     * A slot's ID is stored before its key is published with release ordering, so a reader that
+     * acquires a matching key always sees the ID. Slots are never reused. Key 0 (the empty
+     * ticker) is never found, since it marks empty slots.
+     */
+    uint32_t find(uint64_t key) const noexcept {
+        if (key == 0) return kInvalidSymbol;
+        size_t mask = slot_keys_.size() - 1;
+        for (size_t slot = hash(key);; slot = (slot + 1) & mask) {
+            uint64_t slot_key = slot_keys_[slot].load(std::memory_order_acquire);
+            if (slot_key == key) return slot_ids_[slot].load(std::memory_order_relaxed);
+            if (slot_key == 0) return kInvalidSymbol;
+        }
+    }
+
+    /// Writer side of find(); caller holds write_mutex_.
+    uint32_t intern(uint64_t key) {
+        if (key == 0) throw std::runtime_error("Empty ticker");
+        size_t mask = slot_keys_.size() - 1;
+        for (size_t slot = hash(key);; slot = (slot + 1) & mask) {
+            uint64_t slot_key = slot_keys_[slot].load(std::memory_order_relaxed);
+            if (slot_key == key) return slot_ids_[slot].load(std::memory_order_relaxed);
+            if (slot_key == 0) {
+                if (interned_ >= max_symbols_) throw std::runtime_error("Subscription filter full");
+                auto id = static_cast<uint32_t>(interned_++);
+                slot_ids_[slot].store(id, std::memory_order_relaxed);
+                slot_keys_[slot].store(key, std::memory_order_release);
+                return id;
+            }
+        }
+    }
+
+    std::atomic<bool> accept_all_{true};           ///< Bypass filtering entirely.
+    const size_t max_symbols_;                     ///< Maximum number of interned tickers.
+    std::vector<std::atomic<uint64_t>> bits_;      ///< Subscribed bit per subscription ID.
+    std::vector<std::atomic<uint64_t>> bloom_;     ///< Bloom filter words over packed tickers.
+    size_t bloom_mask_ = 0;                        ///< Bloom bit count - 1; 0 when disabled.
+    std::vector<std::atomic<uint64_t>> slot_keys_; ///< Packed ticker per slot, 0 when empty.
+    std::vector<std::atomic<uint32_t>> slot_ids_;  ///< Subscription ID per slot.
+    unsigned shift_ = 0;                           ///< Right shift turning the 64-bit hash into a slot index.
+    mutable std::mutex write_mutex_;               ///< Serialises subscribe/unsubscribe.
+    size_t interned_ = 0;                          ///< IDs assigned so far.
+    size_t subscribed_ = 0;                        ///< Bits currently set.
+};
@@ -0,0 +1,170 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/// Sentinel returned by SymbolDirectory lookups for unknown tickers.
+inline constexpr uint32_t kInvalidSymbol = UINT32_MAX;
+
+/**
+ * @brief Packs a ticker of up to 8 characters into a 64-bit key.
+ * @param ticker Ticker text; characters beyond the eighth are ignored.
+ * @return Little-endian packed key, zero-filled on the right.
+ *
+ * Packed keys let the hot path compare tickers with a single integer compare. Usable in constant
+ * expressions (see PerfectSymbolTable), where the bytes are assembled without memcpy.
+ */
+constexpr uint64_t packTicker(std::string_view ticker) noexcept {
+    size_t length = std::min<size_t>(ticker.size(), sizeof(uint64_t));
+    if (std::is_constant_evaluated()) {
+        uint64_t key = 0;
+        for (size_t i = 0; i < length; ++i) key |= static_cast<uint64_t>(static_cast<uint8_t>(ticker[i])) << (8 * i);
+        return key;
+    }
+    uint64_t key = 0;
+    std::memcpy(&key, ticker.data(), length);
+    return key;
+}
+
+/**
+ * @brief Whether key is what packTicker() gives for a non-empty ticker: non-zero bytes first, zero
+ * padding after. Keys off the wire can be anything; 0 (the empty ticker) marks empty table slots.
+ */
+constexpr bool validTicker(uint64_t key) noexcept {
+    const int bytes = (std::bit_width(key) + 7) / 8;
+    for (int i = 0; i < bytes; ++i) {
+        if (((key >> (8 * i)) & 0xFF) == 0) return false;
+    }
+    return key != 0;
+}
+
+/**
+ * @brief Converts a packed ticker key back to a string.
+ */
+inline std::string unpackTicker(uint64_t key) {
+    char text[sizeof(key)];
+    std::memcpy(text, &key, sizeof(key));
+    return std::string(text, strnlen(text, sizeof(key)));
+}
+
+/**
+ * @brief Fixed-capacity ticker interning table mapping packed tickers to dense symbol IDs.
+ *
+ * Symbol IDs are assigned in first-seen order starting at 0, so per-symbol state can live in flat
+ * arrays indexed by ID. The index is an open-addressing table over flat arrays with no pointers,
+ * which lets a snapshot persist it byte-for-byte and restore it with a memcpy instead of rehashing.
+ */
+class SymbolDirectory {
+public:
+    /**
+     * @brief Constructs a directory able to hold max_symbols tickers.
+     * @param max_symbols Maximum number of distinct symbols.
+     *
+     * The slot table is sized to the next power of two at or above twice the capacity,
+     * keeping the load factor at or below 50% for short probe sequences.
+     */
+    explicit SymbolDirectory(size_t max_symbols) : max_symbols_(max_symbols) {
+        size_t slots = 16;
+        while (slots < max_symbols * 2) slots <<= 1;
+        slot_keys_.assign(slots, 0);
+        slot_ids_.assign(slots, kInvalidSymbol);
+        tickers_.reserve(max_symbols);
+        shift_ = 64 - static_cast<unsigned>(__builtin_ctzll(slots));
+    }
+
+    /**
+     * @brief Returns the ID for a packed ticker, assigning a new one if unseen.
+     * @param key Packed ticker (see packTicker); must be non-zero.
+     * @return Dense symbol ID.
+     * @throws std::runtime_error if key is 0 (the empty ticker) or the directory is full.
+     */
+    uint32_t intern(uint64_t key) {
+        if (key == 0) throw std::runtime_error("Empty ticker");
+        size_t mask = slot_keys_.size() - 1;
+        for (size_t slot = hash(key);; slot = (slot + 1) & mask) {
+            if (slot_keys_[slot] == key) return slot_ids_[slot];
+            if (slot_keys_[slot] == 0) {
+                if (tickers_.size() >= max_symbols_) throw std::runtime_error("Symbol directory full");
+                uint32_t id = static_cast<uint32_t>(tickers_.size());
+                slot_keys_[slot] = key;
+                slot_ids_[slot] = id;
+                tickers_.push_back(key);
+                return id;
+            }
+        }
+    }
+
+    uint32_t intern(std::string_view ticker) { return intern(packTicker(ticker)); }
+
+    /**
+     * @brief Looks up a packed ticker without inserting.
+     * @return Symbol ID, or kInvalidSymbol if the ticker is unknown or empty.
+     */
+    uint32_t find(uint64_t key) const noexcept {
+        if (key == 0) return kInvalidSymbol; // 0 marks empty slots
+        size_t mask = slot_keys_.size() - 1;
+        for (size_t slot = hash(key);; slot = (slot + 1) & mask) {
+            if (slot_keys_[slot] == key) return slot_ids_[slot];
+            if (slot_keys_[slot] == 0) return kInvalidSymbol;
+        }
+    }
+
+    uint32_t find(std::string_view ticker) const noexcept { return find(packTicker(ticker)); }
+
+    /**
+     * @brief Returns the packed ticker for a symbol ID.
+     */
+    uint64_t ticker(uint32_t id) const noexcept { return tickers_[id]; }
+
+    size_t size() const noexcept { return tickers_.size(); }
+    size_t capacity() const noexcept { return max_symbols_; }
+
+    const std::vector<uint64_t>& tickers() const noexcept { return tickers_; }
+    const std::vector<uint64_t>& slotKeys() const noexcept { return slot_keys_; }
+    const std::vector<uint32_t>& slotIds() const noexcept { return slot_ids_; }
+
+    /**
+     * @brief Forgets every symbol; IDs are assigned from 0 again.
+     */
+    void clear() noexcept {
+        std::fill(slot_keys_.begin(), slot_keys_.end(), 0);
+        std::fill(slot_ids_.begin(), slot_ids_.end(), kInvalidSymbol);
+        tickers_.clear();
+    }
+
+    /**
+     * @brief Replaces the directory contents with previously persisted flat arrays.
+     * @param tickers Ticker keys in ID order.
+     * @param slot_keys Slot key array; must match this directory's slot count.
+     * @param slot_ids Slot ID array; must match this directory's slot count.
+     * @param count Number of symbols.
+     * @param slot_count Number of slots in the persisted arrays.
+     * @throws std::runtime_error if the persisted layout does not match this directory.
+     */
+    void restore(const uint64_t* tickers, const uint64_t* slot_keys, const uint32_t* slot_ids,
+                 size_t count, size_t slot_count) {
+        if (slot_count != slot_keys_.size() || count > max_symbols_) {
+            throw std::runtime_error("Symbol directory layout mismatch");
+        }
+        tickers_.assign(tickers, tickers + count);
+        std::memcpy(slot_keys_.data(), slot_keys, slot_count * sizeof(uint64_t));
+        std::memcpy(slot_ids_.data(), slot_ids, slot_count * sizeof(uint32_t));
+    }
+
+private:
+    size_t hash(uint64_t key) const noexcept {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+
+    std::vector<uint64_t> slot_keys_; ///< Packed ticker per slot, 0 when empty.
+    std::vector<uint32_t> slot_ids_;  ///< Symbol ID per slot.
+    std::vector<uint64_t> tickers_;   ///< Packed ticker per symbol ID.
+    const size_t max_symbols_;        ///< Maximum number of symbols.
+    unsigned shift_ = 0;              ///< Right shift turning the 64-bit hash into a slot index.
+};
@@ -0,0 +1,74 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    workers_.reserve(threads - 1);
+    for (size_t worker = 1; worker < threads; ++worker) workers_.emplace_back(&ThreadPool::workerLoop, this, worker);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) worker.join();
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, size_t)>& fn, size_t grain) {
+    if (count == 0) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = &fn;
+        count_ = count;
+        grain_ = std::max<size_t>(1, grain);
+        next_.store(0, std::memory_order_relaxed);
+        running_ = workers_.size();
+        error_ = nullptr;
+        ++generation_;
+    }
+    wake_.notify_all();
+    runJob(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [&] { return running_ == 0; });
+    job_ = nullptr;
+    if (error_) std::rethrow_exception(error_);
+}
+
+void ThreadPool::workerLoop(size_t worker) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        runJob(worker);
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--running_ == 0) done_.notify_one();
+    }
+}
+
+/**
+ * @brief Claims batches of indices until the job is exhausted; an exception stops further claims.
+ */
+void ThreadPool::runJob(size_t worker) {
+    const size_t count = count_;
+    const size_t grain = grain_;
+    for (;;) {
+        size_t begin = next_.fetch_add(grain, std::memory_order_relaxed);
+        if (begin >= count) return;
+        size_t end = std::min(begin + grain, count);
+        try {
+            for (size_t index = begin; index < end; ++index) (*job_)(index, worker);
+        } catch (...) {
+            next_.store(count, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+            return;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads for data-parallel loops over independent items (e.g. tick
+ * store blocks).
+ *
+ * Workers are started once and sleep between jobs. parallelFor() hands out indices from a shared
+ * atomic counter in batches, so uneven items balance themselves, and the calling thread works as
+ * worker 0 rather than idling. One job runs at a time; parallelFor() is not reentrant.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Starts threads - 1 workers (the caller is the last one); 0 means hardware_concurrency().
+     */
+    explicit ThreadPool(size_t threads = 0);
+
+    /**
+     * @brief Stops and joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Threads taking part in a job, including the caller.
+     */
+    size_t size() const noexcept { return workers_.size() + 1; }
+
+    /**
+     * @brief Calls fn(index, worker) for every index in [0, count) and returns when all calls
+     * have finished. worker is in [0, size()) and identifies the calling thread, for per-thread
+     * scratch and partial results.
+     * @param grain Indices claimed per atomic increment.
+     * @throws The first exception thrown by fn, after every worker has stopped.
+     */
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)>& fn, size_t grain = 1);
+
+private:
+    void workerLoop(size_t worker);
+    void runJob(size_t worker);
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;   ///< Signals a new job (or shutdown) to workers.
+    std::condition_variable done_;   ///< Signals the caller when the last worker finishes.
+    const std::function<void(size_t, size_t)>* job_ = nullptr;
+    size_t count_ = 0;
+    size_t grain_ = 1;
+    std::atomic<size_t> next_{0};    ///< Next unclaimed index.
+    size_t running_ = 0;             ///< Workers still inside the current job.
+    uint64_t generation_ = 0;        ///< Incremented per job so workers run each job once.
+    bool stop_ = false;
+    std::exception_ptr error_;       ///< First exception of the current job.
+};
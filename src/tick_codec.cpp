@@ -0,0 +1,144 @@
+#include "tick_codec.h"
+#include "simd_kernels.h"
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+size_t controlBytes(size_t count) noexcept { return (count + 3) / 4; }
+
+/**
+ * @brief Largest step dividing every delta, so e.g. cent-tick prices encode one tick as 1.
+ * Deltas are taken modulo 2^64; a step that does not fit int64 is not used.
+ */
+uint64_t commonStep(const uint64_t* values, size_t count) noexcept {
+    uint64_t step = 0;
+    for (size_t i = 1; i < count && step != 1; ++i) {
+        auto delta = static_cast<int64_t>(values[i] - values[i - 1]);
+        uint64_t magnitude = delta < 0 ? 0 - static_cast<uint64_t>(delta) : static_cast<uint64_t>(delta);
+        step = std::gcd(step, magnitude);
+    }
+    return step == 0 || step > static_cast<uint64_t>(INT64_MAX) ? 1 : step;
+}
+
+/**
+ * @brief Writes the control bytes and 1/2/4/8-byte zig-zag deltas of values[i] - values[i - 1]
+ * (values[0] - base for the first), divided by scale. out must hold the stream's bound.
+ * @return Data bytes written after the control bytes.
+ */
+size_t encodeDeltaStream(const uint64_t* values, size_t count, uint64_t base, uint64_t scale, uint8_t* out) {
+    uint8_t* control = out;
+    uint8_t* data = out + controlBytes(count);
+    std::memset(control, 0, controlBytes(count));
+    uint64_t previous = base;
+    const auto divisor = static_cast<int64_t>(scale);
+    for (size_t i = 0; i < count; ++i) {
+        auto delta = static_cast<int64_t>(values[i] - previous) / divisor;
+        previous = values[i];
+        uint64_t zigzag = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+        unsigned code = zigzag < (1ULL << 8) ? 0 : zigzag < (1ULL << 16) ? 1 : zigzag < (1ULL << 32) ? 2 : 3;
+        control[i / 4] |= static_cast<uint8_t>(code << (2 * (i % 4)));
+        std::memcpy(data, &zigzag, size_t{1} << code);
+        data += size_t{1} << code;
+    }
+    return static_cast<size_t>(data - (out + controlBytes(count)));
+}
+
+/**
+ * @brief Writes the control bytes and 1-4 byte values (stream VByte).
+ * @return Data bytes written after the control bytes.
+ */
+size_t encodeVarintStream(const int32_t* values, size_t count, uint8_t* out) {
+    uint8_t* control = out;
+    uint8_t* data = out + controlBytes(count);
+    std::memset(control, 0, controlBytes(count));
+    for (size_t i = 0; i < count; ++i) {
+        auto value = static_cast<uint32_t>(values[i]);
+        unsigned code = value < (1u << 8) ? 0 : value < (1u << 16) ? 1 : value < (1u << 24) ? 2 : 3;
+        control[i / 4] |= static_cast<uint8_t>(code << (2 * (i % 4)));
+        std::memcpy(data, &value, code + 1);
+        data += code + 1;
+    }
+    return static_cast<size_t>(data - (out + controlBytes(count)));
+}
+
+uint32_t checkedSize(size_t size) {
+    if (size > UINT32_MAX) throw std::length_error("Encoded tick block too large");
+    return static_cast<uint32_t>(size);
+}
+
+/**
+ * @brief Decodes one delta stream into values and restores the scale.
+ * @return End of the stream, or nullptr if it does not end exactly at data_end.
+ */
+const uint8_t* decodeDeltaStream(const uint8_t* control, const uint8_t* data, const uint8_t* data_end, size_t count,
+                                 uint64_t base, uint64_t scale, uint64_t* values) {
+    // Unit scale (typical for timestamps) sums straight from the base; otherwise sum steps, then scale.
+    if (simd().decode_delta_u64(control, data, data_end, count, scale == 1 ? base : 0, values) != data_end) {
+        return nullptr;
+    }
+    if (scale != 1) {
+        for (size_t i = 0; i < count; ++i) values[i] = base + values[i] * scale;
+    }
+    return data_end;
+}
+
+} // namespace
+
+size_t encodeTicks(const TickColumns& ticks, std::vector<uint8_t>& out) {
+    const size_t count = ticks.count;
+    const size_t start = out.size();
+    out.resize(start + encodedTicksBound(count));
+
+    const auto* prices = reinterpret_cast<const uint64_t*>(ticks.prices);
+    EncodedTicksHeader header{};
+    header.count = checkedSize(count);
+    header.timestamp_base = count > 0 ? ticks.timestamps[0] : 0;
+    header.timestamp_scale = commonStep(ticks.timestamps, count);
+    header.price_base = count > 0 ? prices[0] : 0;
+    header.price_scale = commonStep(prices, count);
+
+    uint8_t* p = out.data() + start + sizeof(header);
+    header.timestamp_bytes =
+        checkedSize(encodeDeltaStream(ticks.timestamps, count, header.timestamp_base, header.timestamp_scale, p));
+    p += controlBytes(count) + header.timestamp_bytes;
+    header.price_bytes = checkedSize(encodeDeltaStream(prices, count, header.price_base, header.price_scale, p));
+    p += controlBytes(count) + header.price_bytes;
+    header.volume_bytes = checkedSize(encodeVarintStream(ticks.volumes, count, p));
+    p += controlBytes(count) + header.volume_bytes;
+
+    std::memcpy(out.data() + start, &header, sizeof(header));
+    const auto size = static_cast<size_t>(p - (out.data() + start));
+    out.resize(start + size);
+    return size;
+}
+
+bool decodeTicks(const uint8_t* data, size_t size, TickBatch& batch) {
+    EncodedTicksHeader header;
+    if (size < sizeof(header)) return false;
+    std::memcpy(&header, data, sizeof(header));
+    const size_t count = header.count;
+    const size_t control = controlBytes(count);
+    const uint64_t expected = sizeof(header) + 3 * uint64_t{control} + uint64_t{header.timestamp_bytes} +
+                              header.price_bytes + header.volume_bytes;
+    if (expected != size || header.timestamp_scale == 0 || header.price_scale == 0) return false;
+
+    batch.resize(count);
+    const uint8_t* p = data + sizeof(header);
+    const uint8_t* end = p + control + header.timestamp_bytes;
+    if (!decodeDeltaStream(p, p + control, end, count, header.timestamp_base, header.timestamp_scale,
+                           batch.timestamps.data())) {
+        return false;
+    }
+    p = end;
+    end = p + control + header.price_bytes;
+    if (!decodeDeltaStream(p, p + control, end, count, header.price_base, header.price_scale,
+                           reinterpret_cast<uint64_t*>(batch.prices.data()))) {
+        return false;
+    }
+    p = end;
+    end = p + control + header.volume_bytes;
+    return simd().decode_varint_u32(p, p + control, end, count, reinterpret_cast<uint32_t*>(batch.volumes.data())) ==
+           end;
+}
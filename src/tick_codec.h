@@ -0,0 +1,81 @@
+#pragma once
+#include "fixed_price.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Column pointers for a run of ticks of one symbol, in time order.
+ */
+struct TickColumns {
+    const uint64_t* timestamps; ///< Tick timestamps (ns), non-decreasing.
+    const FixedPrice* prices;   ///< Prices in 10^-kPriceDecimals units.
+    const int32_t* volumes;     ///< Traded volumes.
+    size_t count;               ///< Ticks in the run.
+
+    /**
+     * @brief Sub-run [begin, end).
+     */
+    TickColumns slice(size_t begin, size_t end) const noexcept {
+        return {timestamps + begin, prices + begin, volumes + begin, end - begin};
+    }
+};
+
+/**
+ * @brief Owning SoA buffer that encoded blocks are decoded into; reuse one across blocks so the
+ * columns are allocated once.
+ */
+struct TickBatch {
+    std::vector<uint64_t> timestamps;
+    std::vector<FixedPrice> prices;
+    std::vector<int32_t> volumes;
+
+    void resize(size_t count) {
+        timestamps.resize(count);
+        prices.resize(count);
+        volumes.resize(count);
+    }
+
+    size_t size() const noexcept { return timestamps.size(); }
+    TickColumns columns() const noexcept { return {timestamps.data(), prices.data(), volumes.data(), size()}; }
+};
+
+/**
+ * @brief Header of an encoded tick block.
+ *
+ * The header is followed by three streams, each a control array of (count + 3) / 4 bytes and its
+ * data bytes: timestamps, prices, volumes. Timestamps and prices are stored as deltas from the
+ * previous tick, divided by the block's common step (scale), zig-zag mapped and packed in 1, 2, 4
+ * or 8 bytes; volumes are packed in 1-4 bytes (stream VByte). Both decoders are SIMD kernels
+ * (SimdKernels::decode_delta_u64, decode_varint_u32).
+ */
+struct EncodedTicksHeader {
+    uint32_t count;           ///< Ticks in the block.
+    uint32_t timestamp_bytes; ///< Data bytes of the timestamp stream.
+    uint32_t price_bytes;     ///< Data bytes of the price stream.
+    uint32_t volume_bytes;    ///< Data bytes of the volume stream.
+    uint64_t timestamp_base;  ///< First timestamp; the first delta is always 0.
+    uint64_t timestamp_scale; ///< Common divisor of the timestamp deltas (1 if none).
+    uint64_t price_base;      ///< First price.
+    uint64_t price_scale;     ///< Common divisor of the price deltas, e.g. the tick size.
+};
+
+/**
+ * @brief Upper bound on encodeTicks() output for count ticks.
+ */
+inline constexpr size_t encodedTicksBound(size_t count) noexcept {
+    return sizeof(EncodedTicksHeader) + 3 * ((count + 3) / 4) + count * (2 * sizeof(uint64_t) + sizeof(int32_t));
+}
+
+/**
+ * @brief Appends the ticks to out as one encoded block.
+ * @return Bytes appended.
+ * @throws std::length_error if ticks.count or a stream exceeds 2^32 - 1 (4096-tick blocks never get close).
+ */
+size_t encodeTicks(const TickColumns& ticks, std::vector<uint8_t>& out);
+
+/**
+ * @brief Decodes one block written by encodeTicks() into batch (resized to the block's count).
+ * @return false if the block is truncated or its streams are inconsistent.
+ */
+bool decodeTicks(const uint8_t* data, size_t size, TickBatch& batch);
@@ -0,0 +1,82 @@
+#include "tick_scan.h"
+#include <algorithm>
+
+namespace {
+
+/// One unit of parallel work: a block, aggregated into a group.
+struct ScanTask {
+    uint32_t block;
+    uint32_t group;
+};
+
+/**
+ * @brief Folds the selected rows into an aggregate. Notional is summed in price units per block
+ * and scaled once, which keeps the inner loop to a convert and a multiply-add.
+ */
+void aggregate(const TickColumns& columns, const uint32_t* selection, size_t selected, TickAggregate& out) {
+    int64_t volume = 0;
+    double notional = 0;
+    FixedPrice low = out.min_price, high = out.max_price;
+    for (size_t k = 0; k < selected; ++k) {
+        const uint32_t row = selection[k];
+        const FixedPrice price = columns.prices[row];
+        const int32_t size = columns.volumes[row];
+        volume += size;
+        notional += static_cast<double>(price) * size;
+        low = std::min(low, price);
+        high = std::max(high, price);
+    }
+    out.count += selected;
+    out.volume += volume;
+    out.notional += notional / static_cast<double>(kPriceScale);
+    out.min_price = low;
+    out.max_price = high;
+}
+
+} // namespace
+
+std::vector<TickAggregate> TickScanner::scan(const std::vector<std::vector<uint64_t>>& groups, const TickFilter& filter) {
+    std::vector<TickAggregate> result(groups.size());
+    scanned_ticks_ = 0;
+    if (filter.empty()) return result;
+
+    // Prune with the time index: only blocks overlapping [from, to] are read.
+    std::vector<ScanTask> tasks;
+    const TickBlockEntry* first_block = store_.blocks().data();
+    for (uint32_t group = 0; group < groups.size(); ++group) {
+        for (uint64_t ticker : groups[group]) {
+            const TickSymbolEntry* symbol = store_.findSymbol(ticker);
+            if (!symbol) continue;
+            std::span<const TickBlockEntry> blocks = store_.blocks(*symbol);
+            auto it = std::partition_point(blocks.begin(), blocks.end(),
+                                           [&](const TickBlockEntry& block) { return block.last_timestamp < filter.from; });
+            for (; it != blocks.end() && it->first_timestamp <= filter.to; ++it) {
+                tasks.push_back({static_cast<uint32_t>(&*it - first_block), group});
+                scanned_ticks_ += it->count;
+            }
+        }
+    }
+
+    workers_.resize(pool_.size());
+    for (WorkerState& worker : workers_) {
+        worker.selection.resize(store_.trailer().block_ticks);
+        worker.groups.assign(groups.size(), TickAggregate{});
+    }
+    const ColumnRanges ranges = filter.ranges();
+    const SimdKernels& kernels = simd();
+    pool_.parallelFor(tasks.size(), [&](size_t index, size_t worker_index) {
+        WorkerState& worker = workers_[worker_index];
+        const ScanTask task = tasks[index];
+        const TickBlockEntry& block = first_block[task.block];
+        TickColumns columns = store_.columns(block, worker.batch);
+        if (worker.selection.size() < columns.count) worker.selection.resize(columns.count);
+        size_t selected = kernels.select_ranges(columns.timestamps, columns.prices, columns.volumes, columns.count,
+                                                ranges, worker.selection.data());
+        aggregate(columns, worker.selection.data(), selected, worker.groups[task.group]);
+    }, 4);
+
+    for (const WorkerState& worker : workers_) {
+        for (size_t group = 0; group < groups.size(); ++group) result[group].merge(worker.groups[group]);
+    }
+    return result;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "simd_kernels.h"
+#include "thread_pool.h"
+#include "tick_store.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Tick predicate: inclusive ranges on time, price and volume (defaults accept everything).
+ */
+struct TickFilter {
+    uint64_t from = 0;                  ///< Earliest timestamp (ns).
+    uint64_t to = UINT64_MAX;           ///< Latest timestamp (ns).
+    FixedPrice min_price = INT64_MIN;
+    FixedPrice max_price = INT64_MAX;
+    int32_t min_volume = INT32_MIN;
+    int32_t max_volume = INT32_MAX;
+
+    /// True if no tick can match.
+    bool empty() const noexcept { return from > to || min_price > max_price || min_volume > max_volume; }
+    ColumnRanges ranges() const noexcept { return {from, to, min_price, max_price, min_volume, max_volume}; }
+};
+
+/**
+ * @brief Aggregates over the ticks a scan selected for one group.
+ */
+struct TickAggregate {
+    uint64_t count = 0;               ///< Matching ticks.
+    int64_t volume = 0;               ///< Sum of volumes.
+    double notional = 0;              ///< Sum of price x volume, in currency units.
+    FixedPrice min_price = INT64_MAX; ///< Lowest matching price (INT64_MAX if none).
+    FixedPrice max_price = INT64_MIN; ///< Highest matching price (INT64_MIN if none).
+
+    double vwap() const noexcept { return volume != 0 ? notional / static_cast<double>(volume) : 0.0; }
+
+    void merge(const TickAggregate& other) noexcept {
+        count += other.count;
+        volume += other.volume;
+        notional += other.notional;
+        min_price = std::min(min_price, other.min_price);
+        max_price = std::max(max_price, other.max_price);
+    }
+};
+
+/**
+ * @brief Filter-and-aggregate scans over a tick store, parallel across blocks.
+ *
+ * A scan prunes each symbol's blocks with the store's time index, then hands the remaining
+ * blocks to a thread pool. Per block, the predicate is evaluated over whole columns by the
+ * select_ranges SIMD kernel, which compresses matching row indices into a selection vector; the
+ * aggregates then read only the selected rows. Workers accumulate per-group partials that are
+ * merged once at the end, so no state is shared while scanning.
+ */
+class TickScanner {
+public:
+    /**
+     * @brief Scans store using pool; both must outlive the scanner.
+     */
+    TickScanner(const TickStoreReader& store, ThreadPool& pool) : store_(store), pool_(pool) {}
+
+    /**
+     * @brief Aggregates the ticks matching filter, per group of symbols.
+     * @param groups Packed tickers per group; tickers missing from the store contribute nothing,
+     * and a ticker may belong to several groups.
+     * @return One aggregate per group.
+     * @throws std::runtime_error if an encoded block is corrupt.
+     */
+    std::vector<TickAggregate> scan(const std::vector<std::vector<uint64_t>>& groups, const TickFilter& filter);
+
+    /**
+     * @brief Ticks in the blocks the last scan read (after time-index pruning).
+     */
+    uint64_t scannedTicks() const noexcept { return scanned_ticks_; }
+
+private:
+    /// Per-thread scratch, reused across scans.
+    struct WorkerState {
+        TickBatch batch;                   ///< Decoded columns of delta-encoded blocks.
+        std::vector<uint32_t> selection;   ///< Row indices passing the filter.
+        std::vector<TickAggregate> groups; ///< Partial aggregates.
+    };
+
+    const TickStoreReader& store_;
+    ThreadPool& pool_;
+    std::vector<WorkerState> workers_;
+    uint64_t scanned_ticks_ = 0;
+};
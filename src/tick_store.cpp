@@ -0,0 +1,175 @@
+#include "tick_store.h"
+#include "file_io.h"
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kTickStoreMagic[8] = {'H', 'F', 'T', 'T', 'I', 'C', 'K', '\0'};
+
+} // namespace
+
+TickStoreWriter::TickStoreWriter(const std::string& path, TickEncoding encoding, size_t block_ticks,
+                                 size_t max_symbols)
+    : path_(path), tmp_path_(path + ".tmp"), encoding_(encoding), block_ticks_(block_ticks), directory_(max_symbols) {
+    if (block_ticks_ == 0 || block_ticks_ > UINT32_MAX) throw std::runtime_error("Invalid tick store block size");
+    file_.open(tmp_path_);
+}
+
+TickStoreWriter::~TickStoreWriter() {
+    if (closed_) return;
+    try {
+        file_.close();
+    } catch (...) {
+        // Discarding the file anyway
+    }
+    std::remove(tmp_path_.c_str());
+}
+
+void TickStoreWriter::append(uint64_t ticker, uint64_t timestamp, FixedPrice price, int32_t volume) {
+    if (!validTicker(ticker)) throw std::runtime_error("Invalid tick store ticker " + std::to_string(ticker));
+    uint32_t id = directory_.intern(ticker);
+    if (id == pending_.size()) pending_.emplace_back();
+    PendingColumns& columns = pending_[id];
+    if (timestamp < columns.last_timestamp) {
+        throw std::runtime_error("Tick store timestamps go backwards for " + unpackTicker(ticker));
+    }
+    columns.last_timestamp = timestamp;
+    columns.timestamps.push_back(timestamp);
+    columns.prices.push_back(price);
+    columns.volumes.push_back(volume);
+    ++tick_count_;
+    if (columns.timestamps.size() == block_ticks_) writeBlock(id);
+}
+
+/**
+ * @brief Appends the symbol's pending ticks as one block and records it in the index.
+ */
+void TickStoreWriter::writeBlock(uint32_t id) {
+    PendingColumns& columns = pending_[id];
+    size_t count = columns.timestamps.size();
+    if (count == 0) return;
+    TickBlockEntry block{offset_, columns.timestamps.front(), columns.timestamps.back(), id,
+                         static_cast<uint32_t>(count), TickBlockLayout::size(count)};
+    if (encoding_ == TickEncoding::Delta) {
+        encoded_.clear();
+        block.size = encodeTicks({columns.timestamps.data(), columns.prices.data(), columns.volumes.data(), count},
+                                 encoded_);
+        writePadded(encoded_.data(), encoded_.size());
+    } else {
+        writePadded(columns.timestamps.data(), count * sizeof(uint64_t));
+        writePadded(columns.prices.data(), count * sizeof(FixedPrice));
+        writePadded(columns.volumes.data(), count * sizeof(int32_t));
+    }
+    blocks_.push_back(block);
+    columns.timestamps.clear();
+    columns.prices.clear();
+    columns.volumes.clear();
+}
+
+/**
+ * @brief Appends data followed by zeros up to the next 64-byte boundary.
+ */
+void TickStoreWriter::writePadded(const void* data, size_t size) {
+    static const uint8_t zeros[TickBlockLayout::kAlignment] = {};
+    file_.append(data, size);
+    size_t padded = TickBlockLayout::alignUp(size);
+    file_.append(zeros, padded - size);
+    offset_ += padded;
+}
+
+/**
+ * @brief Renumbers symbols in ticker order, groups the block index by symbol and writes the footer.
+ */
+void TickStoreWriter::close() {
+    if (closed_) return;
+    for (uint32_t id = 0; id < pending_.size(); ++id) writeBlock(id);
+
+    // Directory order: by packed ticker, so readers can binary search it in place.
+    const size_t symbols = directory_.size();
+    std::vector<uint32_t> order(symbols);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(),
+              [&](uint32_t a, uint32_t b) { return directory_.ticker(a) < directory_.ticker(b); });
+    std::vector<uint32_t> rank(symbols);
+    for (uint32_t i = 0; i < symbols; ++i) rank[order[i]] = i;
+    // Each symbol's blocks were written in time order, so a stable sort keeps them that way.
+    for (TickBlockEntry& block : blocks_) block.symbol = rank[block.symbol];
+    std::stable_sort(blocks_.begin(), blocks_.end(),
+                     [](const TickBlockEntry& a, const TickBlockEntry& b) { return a.symbol < b.symbol; });
+
+    std::vector<TickSymbolEntry> entries(symbols);
+    for (uint32_t i = 0; i < symbols; ++i) entries[i].ticker = directory_.ticker(order[i]);
+    for (uint32_t b = 0; b < blocks_.size(); ++b) {
+        TickSymbolEntry& entry = entries[blocks_[b].symbol];
+        if (entry.block_count++ == 0) {
+            entry.first_block = b;
+            entry.first_timestamp = blocks_[b].first_timestamp;
+        }
+        entry.last_timestamp = blocks_[b].last_timestamp;
+        entry.tick_count += blocks_[b].count;
+    }
+
+    TickStoreTrailer trailer{};
+    std::memcpy(trailer.magic, kTickStoreMagic, sizeof(trailer.magic));
+    trailer.version = kTickStoreVersion;
+    trailer.block_ticks = static_cast<uint32_t>(block_ticks_);
+    trailer.encoding = encoding_;
+    trailer.symbol_count = symbols;
+    trailer.block_count = blocks_.size();
+    trailer.tick_count = tick_count_;
+    trailer.symbols_offset = offset_;
+    writePadded(entries.data(), entries.size() * sizeof(TickSymbolEntry));
+    trailer.blocks_offset = offset_;
+    writePadded(blocks_.data(), blocks_.size() * sizeof(TickBlockEntry));
+    trailer.file_size = offset_ + sizeof(trailer);
+    file_.append(&trailer, sizeof(trailer));
+    file_.close();
+
+    int fd = ::open(tmp_path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throw std::runtime_error("Failed to reopen " + tmp_path_);
+    commitFile(fd, tmp_path_, path_);
+    closed_ = true;
+}
+
+/**
+ * @brief Validates the trailer, the footer bounds and every block's extent once.
+ *
+ * The mapping is not prefaulted: a range query should only ever read the blocks it needs.
+ */
+TickStoreReader::TickStoreReader(const std::string& path) : file_(path, false) {
+    if (file_.size() > 0) ::madvise(const_cast<uint8_t*>(file_.data()), file_.size(), MADV_NORMAL);
+    if (file_.size() < sizeof(TickStoreTrailer)) throw std::runtime_error("Tick store too small: " + path);
+    trailer_ = reinterpret_cast<const TickStoreTrailer*>(file_.data() + file_.size() - sizeof(TickStoreTrailer));
+    if (std::memcmp(trailer_->magic, kTickStoreMagic, sizeof(kTickStoreMagic)) != 0 ||
+        trailer_->version != kTickStoreVersion ||
+        (trailer_->encoding != TickEncoding::Raw && trailer_->encoding != TickEncoding::Delta)) {
+        throw std::runtime_error("Not a tick store: " + path);
+    }
+    // Counts are checked against the room after each offset; a product could wrap on a corrupt trailer.
+    const uint64_t footer_end = file_.size() - sizeof(TickStoreTrailer);
+    if (trailer_->file_size != file_.size() || trailer_->symbols_offset % TickBlockLayout::kAlignment != 0 ||
+        trailer_->blocks_offset % TickBlockLayout::kAlignment != 0 ||
+        trailer_->symbols_offset > footer_end || trailer_->blocks_offset > footer_end ||
+        trailer_->symbol_count > (footer_end - trailer_->symbols_offset) / sizeof(TickSymbolEntry) ||
+        trailer_->block_count > (footer_end - trailer_->blocks_offset) / sizeof(TickBlockEntry)) {
+        throw std::runtime_error("Truncated tick store: " + path);
+    }
+    symbols_ = reinterpret_cast<const TickSymbolEntry*>(file_.data() + trailer_->symbols_offset);
+    blocks_ = reinterpret_cast<const TickBlockEntry*>(file_.data() + trailer_->blocks_offset);
+    for (const TickBlockEntry& block : blocks()) {
+        bool raw_size_ok = trailer_->encoding != TickEncoding::Raw || block.size == TickBlockLayout::size(block.count);
+        if (block.symbol >= trailer_->symbol_count || block.offset % TickBlockLayout::kAlignment != 0 ||
+            !raw_size_ok || block.offset > trailer_->symbols_offset ||
+            block.size > trailer_->symbols_offset - block.offset) {
+            throw std::runtime_error("Corrupt tick store block index: " + path);
+        }
+    }
+    for (const TickSymbolEntry& symbol : symbols()) {
+        if (uint64_t{symbol.first_block} + symbol.block_count > trailer_->block_count) {
+            throw std::runtime_error("Corrupt tick store symbol directory: " + path);
+        }
+    }
+}
@@ -0,0 +1,247 @@
+#pragma once
+#include "async_file_writer.h"
+#include "fixed_price.h"
+#include "mapped_file.h"
+#include "symbol_directory.h"
+#include "tick_codec.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief How a tick store lays out each block's columns.
+ */
+enum class TickEncoding : uint32_t {
+    Raw = 0,   ///< Fixed-width columns (TickBlockLayout), read in place through the mapping.
+    Delta = 1, ///< Delta + zig-zag varint streams (tick_codec.h), decoded per block.
+};
+
+/**
+ * @brief Fixed trailer in the last bytes of a tick store file.
+ *
+ * A tick store is a sequence of per-symbol column blocks followed by a footer: the symbol
+ * directory (sorted by packed ticker) and the block index (sorted by symbol, then time). The
+ * trailer locates the footer, so the file can be written in one pass and read through a mapping.
+ */
+struct TickStoreTrailer {
+    char magic[8];            ///< "HFTTICK" plus NUL.
+    uint32_t version;         ///< Layout version (kTickStoreVersion).
+    uint32_t block_ticks;     ///< Maximum ticks per block.
+    TickEncoding encoding;    ///< Column encoding of every block.
+    uint32_t reserved;        ///< Zero.
+    uint64_t symbol_count;    ///< Entries in the symbol directory.
+    uint64_t block_count;     ///< Entries in the block index.
+    uint64_t tick_count;      ///< Ticks in the store.
+    uint64_t symbols_offset;  ///< TickSymbolEntry[symbol_count].
+    uint64_t blocks_offset;   ///< TickBlockEntry[block_count].
+    uint64_t file_size;       ///< Total file length, used to detect truncated files.
+};
+
+inline constexpr uint32_t kTickStoreVersion = 2;
+
+/**
+ * @brief Symbol directory entry: where a symbol's blocks are in the block index.
+ */
+struct TickSymbolEntry {
+    uint64_t ticker;          ///< Packed ticker (see packTicker).
+    uint64_t tick_count;      ///< Ticks for this symbol.
+    uint64_t first_timestamp; ///< Earliest tick.
+    uint64_t last_timestamp;  ///< Latest tick.
+    uint32_t first_block;     ///< Index of the symbol's first block in the block index.
+    uint32_t block_count;     ///< Consecutive blocks belonging to the symbol.
+};
+
+/**
+ * @brief Sparse time index entry: one per block, giving its time range and location.
+ */
+struct TickBlockEntry {
+    uint64_t offset;          ///< File offset of the block (64-byte aligned).
+    uint64_t first_timestamp; ///< Timestamp of the block's first tick.
+    uint64_t last_timestamp;  ///< Timestamp of the block's last tick.
+    uint32_t symbol;          ///< Index into the symbol directory.
+    uint32_t count;           ///< Ticks in the block.
+    uint64_t size;            ///< Stored bytes (before padding to 64).
+};
+
+/**
+ * @brief Byte layout of one raw block of count ticks: the three columns, each 64-byte aligned.
+ */
+struct TickBlockLayout {
+    static constexpr size_t kAlignment = 64;
+
+    static constexpr size_t alignUp(size_t size) noexcept { return (size + kAlignment - 1) & ~(kAlignment - 1); }
+    static constexpr size_t pricesOffset(size_t count) noexcept { return alignUp(count * sizeof(uint64_t)); }
+    static constexpr size_t volumesOffset(size_t count) noexcept {
+        return pricesOffset(count) + alignUp(count * sizeof(FixedPrice));
+    }
+    static constexpr size_t size(size_t count) noexcept { return volumesOffset(count) + alignUp(count * sizeof(int32_t)); }
+};
+
+/**
+ * @brief Writes ticks into a columnar, mmap-readable tick store.
+ *
+ * Ticks are buffered per symbol and written as a block of three columns (timestamp, price,
+ * volume) whenever a symbol has block_ticks of them, so every block holds a single symbol's ticks
+ * in time order, either as raw columns or delta-encoded (typically 2-3x smaller). close() writes
+ * the remaining partial blocks and the footer, then atomically moves the file into place; a store
+ * is never visible half written. Buffered memory is bounded by symbols x block_ticks x 20 bytes.
+ * Single thread.
+ */
+class TickStoreWriter {
+public:
+    static constexpr size_t kDefaultBlockTicks = 4096;
+    static constexpr size_t kDefaultMaxSymbols = 65536;
+
+    /**
+     * @brief Starts a store at path (written to path + ".tmp" until close()).
+     * @throws std::runtime_error if the file cannot be created.
+     */
+    explicit TickStoreWriter(const std::string& path, TickEncoding encoding = TickEncoding::Raw,
+                             size_t block_ticks = kDefaultBlockTicks, size_t max_symbols = kDefaultMaxSymbols);
+
+    /**
+     * @brief Discards the temporary file unless close() completed.
+     */
+    ~TickStoreWriter();
+
+    TickStoreWriter(const TickStoreWriter&) = delete;
+    TickStoreWriter& operator=(const TickStoreWriter&) = delete;
+
+    /**
+     * @brief Adds one tick.
+     * @param ticker Packed ticker (see packTicker); must be non-zero.
+     * @throws std::runtime_error if the ticker is not a packed non-empty ticker (see validTicker),
+     * timestamps of a symbol go backwards, the symbol directory is full or a write failed.
+     */
+    void append(uint64_t ticker, uint64_t timestamp, FixedPrice price, int32_t volume);
+
+    /**
+     * @brief Writes partial blocks and the footer, syncs, and renames the file into place.
+     * @throws std::runtime_error on I/O failure.
+     */
+    void close();
+
+    uint64_t tickCount() const noexcept { return tick_count_; }
+
+private:
+    /// Ticks of one symbol not yet written.
+    struct PendingColumns {
+        std::vector<uint64_t> timestamps;
+        std::vector<FixedPrice> prices;
+        std::vector<int32_t> volumes;
+        uint64_t last_timestamp = 0; ///< Latest tick appended, written or not.
+    };
+
+    void writeBlock(uint32_t id);
+    void writePadded(const void* data, size_t size);
+
+    std::string path_;
+    std::string tmp_path_;
+    const TickEncoding encoding_;
+    const size_t block_ticks_;
+    SymbolDirectory directory_;               ///< Ticker to writer-side ID (first-seen order).
+    std::vector<PendingColumns> pending_;     ///< Per writer-side ID.
+    std::vector<TickBlockEntry> blocks_;      ///< Written blocks; symbol holds the writer-side ID.
+    std::vector<uint8_t> encoded_;            ///< Scratch for delta-encoded blocks.
+    AsyncFileWriter file_;
+    uint64_t offset_ = 0;                     ///< Bytes written so far, always 64-byte aligned.
+    uint64_t tick_count_ = 0;
+    bool closed_ = false;
+};
+
+/**
+ * @brief Read-only, mmap-backed tick store with symbol lookup and time-range queries.
+ *
+ * The constructor validates the trailer and every index entry once; queries then binary search
+ * the symbol directory, binary search the symbol's blocks by time, and touch only the blocks (and
+ * within the edge blocks, only the ticks) inside the range. Delta-encoded blocks are decoded into
+ * a TickBatch on the way; raw blocks are handed out as pointers into the mapping.
+ */
+class TickStoreReader {
+public:
+    /**
+     * @brief Maps and validates the store at path.
+     * @throws std::runtime_error if the file is missing, truncated or not a tick store.
+     */
+    explicit TickStoreReader(const std::string& path);
+
+    const TickStoreTrailer& trailer() const noexcept { return *trailer_; }
+    TickEncoding encoding() const noexcept { return trailer_->encoding; }
+    std::span<const TickSymbolEntry> symbols() const noexcept { return {symbols_, trailer_->symbol_count}; }
+    std::span<const TickBlockEntry> blocks() const noexcept { return {blocks_, trailer_->block_count}; }
+
+    /**
+     * @brief Blocks of one symbol, in time order.
+     */
+    std::span<const TickBlockEntry> blocks(const TickSymbolEntry& symbol) const noexcept {
+        return {blocks_ + symbol.first_block, symbol.block_count};
+    }
+
+    /**
+     * @brief Looks up a symbol by packed ticker.
+     * @return The directory entry, or nullptr if the store has no ticks for it.
+     */
+    const TickSymbolEntry* findSymbol(uint64_t ticker) const noexcept {
+        const TickSymbolEntry* end = symbols_ + trailer_->symbol_count;
+        const TickSymbolEntry* it = std::lower_bound(symbols_, end, ticker,
+            [](const TickSymbolEntry& entry, uint64_t key) { return entry.ticker < key; });
+        return it != end && it->ticker == ticker ? it : nullptr;
+    }
+
+    const TickSymbolEntry* findSymbol(std::string_view ticker) const noexcept { return findSymbol(packTicker(ticker)); }
+
+    /**
+     * @brief Columns of one block: pointers into the mapping for raw stores, otherwise decoded
+     * into batch (valid until batch is next used).
+     * @throws std::runtime_error if an encoded block is corrupt.
+     */
+    TickColumns columns(const TickBlockEntry& block, TickBatch& batch) const {
+        const uint8_t* base = file_.data() + block.offset;
+        if (trailer_->encoding == TickEncoding::Raw) {
+            return {reinterpret_cast<const uint64_t*>(base),
+                    reinterpret_cast<const FixedPrice*>(base + TickBlockLayout::pricesOffset(block.count)),
+                    reinterpret_cast<const int32_t*>(base + TickBlockLayout::volumesOffset(block.count)), block.count};
+        }
+        if (!decodeTicks(base, block.size, batch) || batch.size() != block.count) {
+            throw std::runtime_error("Corrupt tick store block");
+        }
+        return batch.columns();
+    }
+
+    /**
+     * @brief Calls fn(const TickColumns&) for each run of the symbol's ticks with
+     * from <= timestamp <= to, in time order (at most one run per block).
+     * @return Number of ticks passed to fn.
+     */
+    template <typename Fn>
+    uint64_t query(const TickSymbolEntry& symbol, uint64_t from, uint64_t to, Fn&& fn) const {
+        std::span<const TickBlockEntry> range = blocks(symbol);
+        auto it = std::partition_point(range.begin(), range.end(),
+                                       [&](const TickBlockEntry& block) { return block.last_timestamp < from; });
+        uint64_t visited = 0;
+        TickBatch batch;
+        for (; it != range.end() && it->first_timestamp <= to; ++it) {
+            TickColumns block = columns(*it, batch);
+            const uint64_t* ts = block.timestamps;
+            size_t begin = it->first_timestamp >= from ? 0 : static_cast<size_t>(std::lower_bound(ts, ts + block.count, from) - ts);
+            size_t end = it->last_timestamp <= to ? block.count
+                                                  : static_cast<size_t>(std::upper_bound(ts + begin, ts + block.count, to) - ts);
+            if (begin < end) {
+                fn(static_cast<const TickColumns&>(block.slice(begin, end)));
+                visited += end - begin;
+            }
+        }
+        return visited;
+    }
+
+private:
+    MappedFile file_;                          ///< Mapping of the whole store.
+    const TickStoreTrailer* trailer_ = nullptr;
+    const TickSymbolEntry* symbols_ = nullptr; ///< Footer symbol directory, sorted by ticker.
+    const TickBlockEntry* blocks_ = nullptr;   ///< Footer block index, sorted by symbol then time.
+};
@@ -0,0 +1,173 @@
+#include "timer_wheel.h"
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+namespace {
+
+size_t checkedCapacity(size_t capacity) {
+    if (capacity == 0 || capacity >= UINT32_MAX) {
+        throw std::runtime_error("TimerWheel: capacity must be between 1 and 2^32 - 2");
+    }
+    return capacity;
+}
+
+} // namespace
+
+TimerWheel::TimerWheel(size_t capacity, uint64_t resolution, uint64_t start)
+    : nodes_(checkedCapacity(capacity)),
+      shift_(resolution <= 1 ? 0 : static_cast<unsigned>(std::bit_width(resolution) - 1)) {
+    heads_.fill(kNone);
+    for (size_t i = 0; i + 1 < nodes_.size(); ++i) nodes_[i].next = static_cast<uint32_t>(i + 1);
+    free_ = 0;
+    current_ = start >> shift_;
+}
+
+TimerId TimerWheel::schedule(uint64_t deadline, TimerCallback fn, void* context, uint64_t data,
+                             uint64_t interval) noexcept {
+    if (free_ == kNone) return kInvalidTimer;
+    const uint32_t index = free_;
+    Node& node = nodes_[index];
+    free_ = node.next;
+    // Rounded up, so a timer never fires before its deadline.
+    const uint64_t unit = (deadline >> shift_) + ((deadline & (resolution() - 1)) != 0);
+    node.deadline = std::max(unit, current_ + 1);
+    node.interval = interval == 0 ? 0 : std::max<uint64_t>(1, interval >> shift_);
+    node.fn = fn;
+    node.context = context;
+    node.data = data;
+    insert(index);
+    ++size_;
+    return idOf(index);
+}
+
+bool TimerWheel::cancel(TimerId id) noexcept {
+    const auto index = static_cast<uint32_t>(id);
+    if (id == kInvalidTimer || index >= nodes_.size()) return false;
+    const Node& node = nodes_[index];
+    if (node.generation != static_cast<uint32_t>(id >> 32) || node.slot == kNone) return false;
+    unlink(index);
+    release(index);
+    return true;
+}
+
+/**
+ * @brief Jumps from one unit with work to the next: the earliest of the next occupied level-0
+ * slot and, once level 0 has nothing before its block ends, the next occupied slot of any upper
+ * level (whose cascade is due at that slot's first unit). Empty stretches cost a bit search per
+ * level rather than a step per block.
+ */
+size_t TimerWheel::advanceTo(uint64_t unit) {
+    size_t fired = 0;
+    while (size_ != 0) {
+        uint64_t next = UINT64_MAX;
+        if (const size_t distance = nextOccupied(0, static_cast<size_t>(current_ & (kSlots - 1)))) next = current_ + distance;
+        const uint64_t boundary = (current_ | (kSlots - 1)) + 1; // First unit of the next block
+        if (next >= boundary) {
+            for (size_t level = 1; level < kLevels; ++level) {
+                const uint64_t position = current_ >> (kSlotBits * level);
+                if (const size_t distance = nextOccupied(level, static_cast<size_t>(position & (kSlots - 1)))) {
+                    next = std::min(next, (position + distance) << (kSlotBits * level));
+                }
+            }
+        }
+        if (next > unit) break;
+        current_ = next;
+        if ((current_ & (kSlots - 1)) == 0) cascade(1);
+        fired += fire(current_);
+    }
+    current_ = unit;
+    return fired;
+}
+
+size_t TimerWheel::nextOccupied(size_t level, size_t index) const noexcept {
+    const uint64_t* words = &occupied_[level * kWords];
+    const size_t first = (index + 1) & (kSlots - 1);
+    for (size_t scanned = 0; scanned < kSlots;) {
+        const size_t slot = (first + scanned) & (kSlots - 1);
+        const uint64_t bits = words[slot >> 6] >> (slot & 63);
+        if (bits != 0) {
+            const size_t distance = scanned + static_cast<size_t>(std::countr_zero(bits)) + 1;
+            return distance <= kSlots ? distance : 0;
+        }
+        scanned += 64 - (slot & 63);
+    }
+    return 0;
+}
+
+size_t TimerWheel::fire(uint64_t unit) {
+    const size_t slot = static_cast<size_t>(unit & (kSlots - 1));
+    size_t fired = 0;
+    while (heads_[slot] != kNone) { // Re-read each time: callbacks may cancel timers in this slot
+        const uint32_t index = heads_[slot];
+        unlink(index);
+        Node& node = nodes_[index];
+        const TimerCallback fn = node.fn;
+        void* const context = node.context;
+        const uint64_t data = node.data;
+        if (node.interval != 0) { // Re-armed first, so the callback can cancel it
+            node.deadline += node.interval;
+            insert(index);
+        } else {
+            release(index);
+        }
+        fn(context, data);
+        ++fired;
+    }
+    return fired;
+}
+
+void TimerWheel::insert(uint32_t index) noexcept {
+    Node& node = nodes_[index];
+    const uint64_t when = std::min(node.deadline, current_ + kMaxDelta); // Far timers wait in the top level
+    const uint64_t delta = when - current_;
+    const size_t level = delta == 0 ? 0 : static_cast<size_t>(std::bit_width(delta) - 1) / kSlotBits;
+    const size_t slot = level * kSlots + static_cast<size_t>((when >> (kSlotBits * level)) & (kSlots - 1));
+    node.prev = kNone;
+    node.next = heads_[slot];
+    if (node.next != kNone) nodes_[node.next].prev = index;
+    heads_[slot] = index;
+    node.slot = static_cast<uint32_t>(slot);
+    occupied_[slot >> 6] |= uint64_t{1} << (slot & 63);
+}
+
+void TimerWheel::unlink(uint32_t index) noexcept {
+    Node& node = nodes_[index];
+    if (node.prev != kNone) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        heads_[node.slot] = node.next;
+    }
+    if (node.next != kNone) nodes_[node.next].prev = node.prev;
+    if (heads_[node.slot] == kNone) occupied_[node.slot >> 6] &= ~(uint64_t{1} << (node.slot & 63));
+    node.slot = kNone;
+}
+
+void TimerWheel::release(uint32_t index) noexcept {
+    Node& node = nodes_[index];
+    if (++node.generation == 0) node.generation = 1; // IDs are never 0
+    node.slot = kNone;
+    node.next = free_;
+    free_ = index;
+    --size_;
+}
+
+/**
+ * @brief Re-files the slot of level that the current unit has reached into lower levels. When
+ * that slot is the level's first, the level above has wrapped too and is cascaded first, since
+ * its timers may land in the slot being emptied.
+ */
+void TimerWheel::cascade(size_t level) noexcept {
+    if (level >= kLevels) return;
+    const size_t index = static_cast<size_t>((current_ >> (kSlotBits * level)) & (kSlots - 1));
+    if (index == 0) cascade(level + 1);
+    const size_t slot = level * kSlots + index;
+    uint32_t node = heads_[slot];
+    heads_[slot] = kNone;
+    occupied_[slot >> 6] &= ~(uint64_t{1} << (slot & 63));
+    while (node != kNone) {
+        const uint32_t next = nodes_[node].next;
+        insert(node);
+        node = next;
+    }
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include "clock.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Timer handle: the timer's node index in the low 32 bits and the node's generation in the
+ * high 32, so a handle kept past the timer's expiry can never cancel the node's next timer.
+ * 0 is never issued.
+ */
+using TimerId = uint64_t;
+inline constexpr TimerId kInvalidTimer = 0;
+
+/// Timer action; context and data are the values given to TimerWheel::schedule.
+using TimerCallback = void (*)(void* context, uint64_t data);
+
+/**
+ * @brief Hierarchical timing wheel driven by TscClock ticks (order timeouts, heartbeats,
+ * throttle refills).
+ *
+ * Time advances in units of a power-of-two number of clock ticks (the resolution). Four levels of
+ * 256 slots cover 2^8, 2^16, 2^24 and 2^32 units ahead; a timer goes into the lowest level whose
+ * span holds its deadline, and each time the level below wraps, one slot of the level above is
+ * cascaded down. Timer nodes come from a fixed pool and are linked into slots by index (an
+ * intrusive doubly-linked list), so schedule() and cancel() are O(1) and never allocate. Bitmaps
+ * of occupied slots per level let advance() jump straight to the next slot with work, so a large
+ * advance over idle time (e.g. virtual time in a simulation) costs a few bit searches.
+ *
+ * tick() is one rdtsc and a compare unless a unit boundary has passed, cheap enough to call on
+ * every iteration of a poll loop. Deadlines beyond the top level's span are parked in its farthest
+ * slot and re-filed as time approaches them. Timers fire in the advance() that reaches their unit,
+ * so they are late by at most one unit plus the caller's polling interval, and never early.
+ *
+ * Owned by a single thread; callbacks run on it and may schedule or cancel timers.
+ */
+class TimerWheel {
+public:
+    static constexpr size_t kLevels = 4;
+    static constexpr size_t kSlotBits = 8;
+    static constexpr size_t kSlots = size_t{1} << kSlotBits;
+
+    /**
+     * @brief Constructs an empty wheel.
+     * @param capacity Maximum number of pending timers.
+     * @param resolution Clock ticks per unit, rounded down to a power of two (at least 1).
+     * @param start Current clock value (e.g. TscClock::now()).
+     * @throws std::runtime_error if capacity is 0 or does not fit in 32 bits.
+     */
+    TimerWheel(size_t capacity, uint64_t resolution, uint64_t start);
+
+    /**
+     * @brief Schedules fn(context, data) at clock value deadline, then every interval ticks if
+     * interval is non-zero (until cancelled). A deadline already reached fires on the next unit.
+     * @return Timer handle, or kInvalidTimer if capacity timers are pending.
+     */
+    TimerId schedule(uint64_t deadline, TimerCallback fn, void* context, uint64_t data, uint64_t interval = 0) noexcept;
+
+    /**
+     * @brief Schedules on the TSC clock, delay_ns from now.
+     */
+    TimerId scheduleAfter(uint64_t delay_ns, TimerCallback fn, void* context, uint64_t data) noexcept {
+        return schedule(TscClock::now() + TscClock::fromNanos(delay_ns), fn, context, data);
+    }
+
+    /**
+     * @brief Cancels a pending timer (including a periodic one, from its own callback).
+     * @return False if the timer already fired (one-shot), was cancelled, or was never issued.
+     */
+    bool cancel(TimerId id) noexcept;
+
+    /**
+     * @brief Fires the timers due at the current TSC time.
+     * @return Number of callbacks run.
+     */
+    size_t tick() { return advance(TscClock::now()); }
+
+    /**
+     * @brief Advances to clock value now (monotonic; earlier values are ignored) and fires every
+     * timer whose unit has been reached, in deadline order (ties in any order).
+     * @return Number of callbacks run.
+     */
+    size_t advance(uint64_t now) {
+        const uint64_t unit = now >> shift_;
+        return unit > current_ ? advanceTo(unit) : 0;
+    }
+
+    /**
+     * @brief Clock value of the unit last reached: inside a callback, the unit the timer fired in.
+     */
+    uint64_t now() const noexcept { return current_ << shift_; }
+
+    size_t size() const noexcept { return size_; }
+    size_t capacity() const noexcept { return nodes_.size(); }
+    uint64_t resolution() const noexcept { return uint64_t{1} << shift_; } ///< Clock ticks per unit.
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+    static constexpr size_t kWords = kSlots / 64; ///< Bitmap words per level.
+    static constexpr uint64_t kMaxDelta = (uint64_t{1} << (kSlotBits * kLevels)) - 1; ///< Furthest unit a slot can hold.
+
+    struct Node {
+        uint64_t deadline = 0;        ///< Unit the timer fires in.
+        uint64_t interval = 0;        ///< Re-arm period in units (0 = one-shot).
+        TimerCallback fn = nullptr;
+        void* context = nullptr;
+        uint64_t data = 0;
+        uint32_t prev = kNone;        ///< Slot list links (next doubles as the free-list link).
+        uint32_t next = kNone;
+        uint32_t generation = 1;      ///< Bumped when the node is freed; never 0.
+        uint32_t slot = kNone;        ///< Index into heads_, kNone while free.
+    };
+
+    size_t advanceTo(uint64_t unit);
+    /// Slots from index to the next occupied slot of level, cyclically (1..kSlots), or 0 if none.
+    size_t nextOccupied(size_t level, size_t index) const noexcept;
+    void insert(uint32_t index) noexcept;
+    void unlink(uint32_t index) noexcept;
+    void release(uint32_t index) noexcept;
+    void cascade(size_t level) noexcept;
+    size_t fire(uint64_t unit);
+
+    TimerId idOf(uint32_t index) const noexcept { return static_cast<TimerId>(nodes_[index].generation) << 32 | index; }
+
+    std::vector<Node> nodes_;
+    std::array<uint32_t, kLevels * kSlots> heads_; ///< First node per slot, level-major.
+    std::array<uint64_t, kLevels * kWords> occupied_{}; ///< Non-empty slots, a bit per heads_ entry.
+    uint32_t free_ = kNone;                        ///< Free-list head.
+    uint64_t current_;                             ///< Last unit processed.
+    size_t size_ = 0;                              ///< Pending timers.
+    unsigned shift_;                               ///< log2(resolution).
+};
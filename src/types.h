@@ -1,9 +1,11 @@
 #pragma once
+#include <cstdint>
 #include <string>
 
 struct alignas(64) MarketData {
     std::string symbol; // ~24 bytes (implementation-dependent)
     double price;       // 8 bytes
     int volume;         // 4 bytes
-    char padding[20];   // Pad to 64 bytes (assuming sizeof(std::string) ≈ 24)
-};
\ No newline at end of file
+    uint64_t timestamp; // 8 bytes, TscClock ticks at enqueue (virtual ns when simulating; 0 if unset)
+    char padding[8];    // Pad to 64 bytes (assuming sizeof(std::string) <= 32)
+};
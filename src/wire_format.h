@@ -0,0 +1,87 @@
+#pragma once
+#include "symbol_directory.h"
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief Binary feed datagram layout: one WireHeader followed by `count` WireUpdate records.
+ *
+ * All fields are little-endian and naturally aligned, so a datagram can be decoded in place
+ * from a receive buffer. The header sequence numbers datagrams for gap detection.
+ */
+constexpr uint32_t kWireMagic = 0x31544648; ///< "HFT1" in little-endian byte order.
+
+struct WireHeader {
+    uint32_t magic;     ///< kWireMagic.
+    uint16_t count;     ///< Number of WireUpdate records that follow.
+    uint16_t reserved;  ///< Always zero.
+    uint64_t sequence;  ///< Datagram sequence number, incremented per datagram.
+    uint64_t send_time; ///< Sender timestamp (sender's clock domain).
+};
+static_assert(sizeof(WireHeader) == 24, "WireHeader is sent verbatim");
+
+struct WireUpdate {
+    uint64_t ticker;   ///< Packed ticker (see packTicker).
+    double price;      ///< Trade price.
+    int32_t volume;    ///< Trade volume.
+    uint32_t reserved; ///< Always zero.
+};
+static_assert(sizeof(WireUpdate) == 24, "WireUpdate is sent verbatim");
+
+constexpr size_t kMaxDatagramSize = 1472; ///< Largest UDP payload without fragmentation on a 1500 MTU.
+constexpr size_t kMaxWireUpdates = (kMaxDatagramSize - sizeof(WireHeader)) / sizeof(WireUpdate);
+
+/**
+ * @brief Serialises a datagram into out (at least kMaxDatagramSize bytes).
+ * @return Datagram size in bytes; count is clamped to kMaxWireUpdates.
+ */
+inline size_t encodeDatagram(uint8_t* out, uint64_t sequence, uint64_t send_time, const WireUpdate* updates,
+                             size_t count) noexcept {
+    if (count > kMaxWireUpdates) count = kMaxWireUpdates;
+    WireHeader header{kWireMagic, static_cast<uint16_t>(count), 0, sequence, send_time};
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + sizeof(header), updates, count * sizeof(WireUpdate));
+    return sizeof(header) + count * sizeof(WireUpdate);
+}
+
+/**
+ * @brief Validates a datagram and invokes sink(header, update) for each update it carries.
+ * @return False for truncated or foreign datagrams, or ones carrying a ticker that is empty or not
+ * in packTicker() form (see validTicker), in which case sink is never called.
+ */
+template <typename Sink>
+bool decodeDatagram(const uint8_t* data, size_t size, Sink&& sink) {
+    WireHeader header;
+    if (size < sizeof(header)) return false;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != kWireMagic || size < sizeof(header) + header.count * sizeof(WireUpdate)) return false;
+    const uint8_t* cursor = data + sizeof(header);
+    for (size_t i = 0; i < header.count; ++i) {
+        uint64_t ticker;
+        std::memcpy(&ticker, cursor + i * sizeof(WireUpdate) + offsetof(WireUpdate, ticker), sizeof(ticker));
+        if (!validTicker(ticker)) return false;
+    }
+    for (size_t i = 0; i < header.count; ++i, cursor += sizeof(WireUpdate)) {
+        WireUpdate update;
+        std::memcpy(&update, cursor, sizeof(update));
+        sink(header, update);
+    }
+    return true;
+}
+
+/**
+ * @brief Fills a MarketData (typically a claimed queue slot) from a decoded update.
+ *
+ * The symbol is assigned in place, which stays within the string's small buffer for tickers
+ * of up to 8 characters, so decoding allocates nothing.
+ */
+inline void toMarketData(const WireUpdate& update, uint64_t timestamp, MarketData& data) {
+    char text[sizeof(update.ticker)];
+    std::memcpy(text, &update.ticker, sizeof(text));
+    data.symbol.assign(text, strnlen(text, sizeof(text)));
+    data.price = update.price;
+    data.volume = update.volume;
+    data.timestamp = timestamp;
+}